@@ -27,10 +27,11 @@ int main()
     // Print library contents
     std::cout << "Loaded shader library: " << libPath << "\n";
     std::cout << "  Entries: " << lib.entries.size() << "\n";
+    std::cout << "  Layout classes: " << lib.layoutClasses.size() << "\n";
     for (const auto& e : lib.entries)
     {
         std::cout << "    keyHash=" << e.keyHash << ", stage=" << static_cast<uint32_t>(e.stage)
-                  << ", offset=" << e.offset << ", size=" << e.size << "\n";
+                  << ", layoutClass=" << e.layoutClass << ", offset=" << e.offset << ", size=" << e.size << "\n";
     }
 
     // Example: shader id derived from path at build time:
@@ -43,14 +44,15 @@ int main()
 
     const uint64_t variantHash = key.build();
 
-    auto blobR = extract_vshlib_blob(lib, variantHash, ShaderStage::eFrag);
-    if (!blobR.isOk())
+    // The blob is a view into lib.blobData, no copy is made.
+    const auto blob = find_vshlib_blob(lib, variantHash, ShaderStage::eFrag);
+    if (blob.empty())
     {
         std::cerr << "Variant not found. shaderId=" << shaderId << " hash=" << variantHash << "\n";
         return 4;
     }
 
-    auto br = read_vshbin(blobR.value());
+    auto br = read_vshbin(blob);
     if (!br.isOk())
     {
         std::cerr << "Failed to parse embedded vshbin: " << br.error().message << "\n";
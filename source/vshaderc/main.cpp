@@ -1,21 +1,45 @@
 #include <vshadersystem/binary.hpp>
+#include <vshadersystem/deps.hpp>
 #include <vshadersystem/engine_keywords.hpp>
 #include <vshadersystem/hash.hpp>
-#include <vshadersystem/keyword_expr.hpp>
+#include <vshadersystem/keyword_query.hpp>
 #include <vshadersystem/library.hpp>
+#include <vshadersystem/library_split.hpp>
+#include <vshadersystem/link_modules.hpp>
+#include <vshadersystem/live_link.hpp>
+#include <vshadersystem/material_layout.hpp>
+#include <vshadersystem/material_pool.hpp>
 #include <vshadersystem/metadata.hpp>
+#include <vshadersystem/process_pool.hpp>
 #include <vshadersystem/result.hpp>
+#include <vshadersystem/shader_id.hpp>
+#include <vshadersystem/spirv_stats.hpp>
 #include <vshadersystem/system.hpp>
+#include <vshadersystem/thread_pool.hpp>
+#include <vshadersystem/validation.hpp>
+#include <vshadersystem/variants.hpp>
+#include <vshadersystem/workgroup.hpp>
 
 #include <algorithm>
+#include <bit>
 #include <cctype>
 #include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstdio>
 #include <cstdlib>
 #include <cstring>
 #include <filesystem>
 #include <fstream>
 #include <iostream>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <sstream>
 #include <string>
+#include <string_view>
+#include <thread>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
@@ -49,8 +73,14 @@ static void print_usage()
 
 Usage:
   vshaderc compile -i <input.vshader> -o <output.vshbin> -S <stage> [options]
+  vshaderc compile @<jobs.rsp> [@<more.rsp> ...] [options]
   vshaderc build --shader_root <dir> [--shader <path> ...] [-I <dir> ...] [--keywords-file <path.vkw>] -o <output.vshlib> [options]
-  vshaderc packlib -o <output.vshlib> [--keywords-file <path.vkw>] <in1.vshbin> <in2.vshbin> ...
+  vshaderc packlib -o <output.vshlib> [--keywords-file <path.vkw>] <in1.vshbin|@list.txt> <in2.vshbin> ...
+  vshaderc deps --shader_root <dir> [-I <dir> ...] [--changed <file> ...] [options]
+  vshaderc analyze --shader_root <dir> [--shader <path> ...] [-I <dir> ...] [options]
+  vshaderc query <lib.vshlib> [--shader <id>] [-S <stage>] [--where <expr>] [--count]
+  vshaderc split <lib.vshlib> -o <dir> [--manifest <file>] [--group <name>=<id>,...] [--by-keyword <name>]
+  vshaderc watch --shader_root <dir> [-I <dir> ...] [--keywords-file <path.vkw>] --live <socket> [-o <output.vshlib>]
 
 Stages:
   vert, frag, comp, task, mesh, rgen, rmiss, rchit, rahit, rint
@@ -61,6 +91,10 @@ Options (compile):
   --keywords-file <vkw>  Load engine_keywords.vkw and inject global permute values if shader declares them
   --no-cache             Disable cache
   --cache <dir>          Cache directory (default: .vshader_cache)
+  --project-root <dir>   Root for machine-independent cache keys (default: current directory)
+  --binding-table <vbt>  Remap descriptor set/binding decorations from a canonical table
+  -j, --jobs <N>         Worker threads for response file jobs (default: hardware threads)
+  --validate             Validate SPIR-V (SPIRV-Tools builds); each unique module once, cached
   --verbose              Verbose logging
 
 Options (build):
@@ -70,20 +104,108 @@ Options (build):
   --keywords-file <vkw>  Load engine keywords (.vkw) and embed it into the output vshlib
   --no-cache             Disable cache
   --cache <dir>          Cache directory (default: .vshader_cache)
+  --project-root <dir>   Root for machine-independent cache keys (default: --shader_root)
+  --binding-table <vbt>  Remap descriptor set/binding decorations from a canonical table
+  --workgroup-sizes <l>  Extra local sizes for compute shaders using local_size_*_id, e.g. 64,128,8x8
+  --material-glsl <dir>  Write <id>.material.glsl decoding each shader's Material block from the parameter pool
+  --link-module <path>   Experimental: link an include module as precompiled SPIR-V (repeatable)
+  --link-report          Compare linked variant compile times against source inclusion
+  --split-manifest <f>   Write partitioned libraries + <name>.vshroute next to -o instead of one library
+  --split-group <spec>   Partition shader ids: <name>=<id>[,<id>...] (repeatable)
+  --split-keyword <name> Also partition by the value of this permutation keyword
+  --progressive          Build default, then used, then remaining variants; publish -o snapshots along the way
+  --snapshot-every <s>   Seconds between progressive snapshots (default: 120)
+  --usage-log <file>     Variant usage counts ordering --progressive builds: <count> <shaderId> [NAME=VALUE ...]
+  --profile <name=vkw>   Build for several engine keyword profiles; writes <out>.<name>.vshlib each (repeatable)
+  --merge-profiles       With --profile: write one -o library with per-entry profile membership instead
+  --workers <N>          Compile in N worker processes (0 = hardware threads); a crash fails only its variant
+  --worker-jobs <N>      Restart a worker after N jobs (default: 256, 0 = never)
+  --worker-max-mb <MB>   Restart a worker once its resident memory exceeds MB (default: no limit)
+  -j, --jobs <N>         Compile and validate threads (default: hardware threads, less --workers processes)
+  --validate             Validate each unique SPIR-V module alongside compilation; fail the build if invalid
+  --strip-plugin <lib>   Shared library exporting vshaderc_strip_variant() to drop variants before compiling
   --skip-invalid          Skip variants failing only_if constraints
   --verbose               Verbose logging
 
 Options (packlib):
   --keywords-file <vkw>  Embed keywords file bytes into output vshlib
+  -j, --jobs <N>         Threads reading .vshbin headers (default: hardware threads)
+  --verbose              Verbose logging
+
+Options (deps):
+  --shader_root <dir>    Root directory to scan (same as build)
+  -I <dir>               Add include directory (repeatable)
+  --keywords-file <vkw>  Engine keywords used for only_if pruning
+  --changed <file>       Report shaders/variants/estimated compile time rebuilt when <file> changes (repeatable)
+  --cache <dir>          Cache directory holding deps.graph (default: .vshader_cache)
+  --project-root <dir>   Root for project-relative paths (default: --shader_root, else the last build's)
+  --no-scan              Use the graph recorded by the last build instead of preprocessing shaders
+  --top <N>              Without --changed: list the N includes with the largest fan-out (default: 20)
+  --verbose              Verbose logging
+
+Options (analyze):
+  --shader_root <dir>    Root directory to scan (same as build)
+  --shader <path>        Analyze only a specific shader (repeatable)
+  -I <dir>               Add include directory (repeatable)
+  --keywords-file <vkw>  Engine keywords used for only_if pruning and global values
+  --samples <N>          Variant pairs compiled per permute keyword (default: 4)
+  --no-cache             Disable cache (every sample is timed)
+  --cache <dir>          Cache directory; deps.graph timings estimate savings of cached samples
+  --project-root <dir>   Root for machine-independent cache keys (default: --shader_root)
+  --verbose              Verbose logging
+
+Options (query):
+  --shader <id>          Only entries of this shader id (e.g. base.frag)
+  -S, --stage <stage>    Only entries of this stage
+  --where <expr>         only_if-style predicate over permute keywords, e.g. "VTX_HAS_NORMAL==1 && SURFACE!=BLEND"
+  --count                Print the number of matches only
+  --verbose              Verbose logging
+
+Options (split):
+  -o <dir>               Output directory for <lib>.<partition>.vshlib and <lib>.vshroute
+  --manifest <file>      Usage manifest: [partition] headers followed by shader ids
+  --group <spec>         Partition shader ids: <name>=<id>[,<id>...] (repeatable)
+  --by-keyword <name>    Also partition by the value of this permutation keyword
+  --default <name>       Partition for shaders no group lists (default: common)
+  --verbose              Verbose logging
+
+Options (watch):
+  --shader_root <dir>    Root directory to watch (same as build)
+  --shader <path>        Watch only a specific shader (repeatable)
+  -I <dir>               Add include directory (repeatable)
+  --keywords-file <vkw>  Load engine keywords (.vkw); embedded into -o
+  --binding-table <vbt>  Remap descriptor set/binding decorations from a canonical table
+  --workgroup-sizes <l>  Extra local sizes for compute shaders using local_size_*_id
+  --live <socket>        Stream rebuilt .vshbin entries to processes connected to this Unix socket
+  -o <output.vshlib>     Rewrite this library after every rebuild
+  --interval <ms>        Polling interval for source and include changes (default: 200)
+  -j, --jobs <N>         Compile threads (default: hardware threads)
+  --no-cache             Disable cache
+  --cache <dir>          Cache directory (default: .vshader_cache)
+  --project-root <dir>   Root for machine-independent cache keys (default: --shader_root)
+  --skip-invalid         Skip variants failing only_if constraints
   --verbose              Verbose logging
 
 Notes:
+  - compile response files list one job per line (-i/-o/-S/-I/-D); options on the command line apply to
+    every job. The exit code is that of the first failed job.
   - build infers the shader stage from filename suffix: *.vert.vshader, *.frag.vshader, *.comp.vshader, ...
+  - analyze recommends runtime below 2% static-cost delta and special below 10%; keywords that change
+    descriptors or stage IO stay permute.
+  - split and build --split-*: shaders listed by more than one group go to a "shared" partition. The
+    .vshroute index maps each shaderIdHash to the partitions holding it.
+  - watch rebuilds every variant of a shader whose source or recorded includes changed. With --live, each
+    rebuild is sent as one batch; clients connecting later first receive every entry rebuilt so far.
 
 Examples:
   vshaderc compile -i shaders/pbr.frag.vshader -o out/pbr.frag.vshbin -S frag -I shaders/include -D USE_FOO=1
+  vshaderc compile @out/jobs.rsp -I shaders/include --keywords-file engine_keywords.vkw -j 8
   vshaderc build --shader_root examples/keywords/shaders --keywords-file examples/keywords/engine_keywords.vkw -o out/shaders.vshlib --verbose
   vshaderc packlib -o out/shaders.vshlib --keywords-file engine_keywords.vkw out/*.vshbin
+  vshaderc deps --shader_root examples/keywords/shaders --changed examples/keywords/shaders/include/common/gpu_scene.glsl
+  vshaderc query out/shaders.vshlib --shader base.frag -S frag --where "VTX_HAS_NORMAL==1"
+  vshaderc split out/shaders.vshlib -o out/streaming --manifest levels.txt --by-keyword QUALITY
+  vshaderc watch --shader_root examples/keywords/shaders --live /tmp/vshaderc.sock -o out/shaders.vshlib
 )";
 }
 
@@ -256,62 +378,6 @@ static inline std::string normalize_define_set(const std::vector<Define>& defs)
     return out;
 }
 
-// ============================================================
-// Keyword value parsing (for only_if resolve)
-// ============================================================
-
-static inline bool parse_bool_str(const std::string& s, uint32_t& out)
-{
-    if (s.empty())
-    {
-        out = 1;
-        return true;
-    }
-    if (s == "1" || s == "true" || s == "TRUE" || s == "True")
-    {
-        out = 1;
-        return true;
-    }
-    if (s == "0" || s == "false" || s == "FALSE" || s == "False")
-    {
-        out = 0;
-        return true;
-    }
-    return false;
-}
-
-static inline Result<uint32_t> parse_keyword_value_local(const KeywordDecl& d, const std::string& raw)
-{
-    if (d.kind == KeywordValueKind::eBool)
-    {
-        uint32_t v = 0;
-        if (!parse_bool_str(raw, v))
-            return Result<uint32_t>::err({ErrorCode::eParseError, "Invalid bool for keyword '" + d.name + "'"});
-        return Result<uint32_t>::ok(v);
-    }
-
-    // Enum:
-    if (raw.empty())
-        return Result<uint32_t>::ok(d.defaultValue);
-
-    // numeric index
-    if (std::all_of(raw.begin(), raw.end(), [](unsigned char c) { return std::isdigit(c) != 0; }))
-    {
-        uint32_t idx = 0;
-        for (char c : raw)
-            idx = idx * 10u + static_cast<uint32_t>(c - '0');
-        if (idx >= d.enumValues.size())
-            return Result<uint32_t>::err({ErrorCode::eParseError, "Enum index out of range for '" + d.name + "'"});
-        return Result<uint32_t>::ok(idx);
-    }
-
-    for (uint32_t i = 0; i < static_cast<uint32_t>(d.enumValues.size()); ++i)
-        if (d.enumValues[i] == raw)
-            return Result<uint32_t>::ok(i);
-
-    return Result<uint32_t>::err({ErrorCode::eParseError, "Unknown enum value '" + raw + "' for '" + d.name + "'"});
-}
-
 // ============================================================
 // packlib
 // ============================================================
@@ -322,6 +388,7 @@ static int cmd_packlib(int argc, char** argv)
     std::string              outPath;
     std::string              keywordsPath;
     std::vector<std::string> inputs;
+    uint32_t                 jobs    = 0;
     bool                     verbose = false;
 
     for (int i = 2; i < argc; ++i)
@@ -331,6 +398,28 @@ static int cmd_packlib(int argc, char** argv)
         {
             outPath = argv[++i];
         }
+        else if ((a == "-j" || a == "--jobs") && i + 1 < argc)
+        {
+            jobs = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        }
+        else if (a.size() > 1 && a[0] == '@')
+        {
+            // Input list file: one .vshbin path per line.
+            std::string list;
+            if (!read_text_file(a.substr(1), list))
+            {
+                log_error("packlib: failed to read input list: " + a.substr(1));
+                return 2;
+            }
+            std::istringstream iss(list);
+            std::string        line;
+            while (std::getline(iss, line))
+            {
+                line = trim_copy(line);
+                if (!line.empty() && line[0] != '#')
+                    inputs.push_back(std::move(line));
+            }
+        }
         else if ((a == "--keywords-file" || a.rfind("--keywords-file=", 0) == 0))
         {
             if (a == "--keywords-file")
@@ -387,64 +476,62 @@ static int cmd_packlib(int argc, char** argv)
         log_info("packlib: embedding keywords file: " + keywordsPath);
     }
 
-    std::vector<ShaderLibraryEntry> entries;
-    entries.reserve(inputs.size());
+    // Only headers and identity chunks are read, in parallel; blob bytes are streamed into the
+    // output by ShaderLibraryWriter, so memory stays bounded by the TOC, not the blobs.
+    std::vector<Result<ShaderBinaryInfo>> infos(inputs.size());
+    {
+        ThreadPool pool(jobs);
+        for (size_t i = 0; i < inputs.size(); ++i)
+            pool.submit([&, i]() { infos[i] = peek_vshbin_file(inputs[i]); });
+        pool.wait();
+    }
+
+    ShaderLibraryWriter writer;
 
     std::unordered_set<uint64_t> seen;
     seen.reserve(inputs.size() * 2);
 
-    for (const auto& path : inputs)
+    for (size_t i = 0; i < inputs.size(); ++i)
     {
-        auto r = read_vshbin_file(path);
+        const auto& path = inputs[i];
+        auto&       r    = infos[i];
         if (!r.isOk())
         {
             log_error("packlib: failed to read " + path + ": " + r.error().message);
             return 4;
         }
 
-        const auto&        bin = r.value();
-        ShaderLibraryEntry e;
-        e.keyHash = (bin.variantHash != 0) ? bin.variantHash : bin.contentHash;
-        e.stage   = bin.stage;
+        const auto&       bin     = r.value();
+        const uint64_t    keyHash = (bin.variantHash != 0) ? bin.variantHash : bin.contentHash;
+        const ShaderStage stage   = bin.stage;
 
         log_verbose("processing " + path + " shaderIdHash=" + std::to_string(bin.shaderIdHash) + " contentHash=" +
                     std::to_string(bin.contentHash) + " variantHash=" + std::to_string(bin.variantHash) +
-                    " stage=" + std::to_string(static_cast<int>(bin.stage)));
+                    " stage=" + std::to_string(static_cast<int>(stage)));
 
-        const uint64_t sig =
-            xxhash64(&e.keyHash, sizeof(e.keyHash), static_cast<uint64_t>(static_cast<uint8_t>(e.stage)));
+        const uint64_t sig = xxhash64(&keyHash, sizeof(keyHash), static_cast<uint64_t>(static_cast<uint8_t>(stage)));
         if (seen.find(sig) != seen.end())
         {
-            log_error("packlib: duplicate entry for keyHash=" + std::to_string(e.keyHash) +
-                      " stage=" + std::to_string(static_cast<int>(e.stage)) + " input=" + path);
+            log_error("packlib: duplicate entry for keyHash=" + std::to_string(keyHash) +
+                      " stage=" + std::to_string(static_cast<int>(stage)) + " input=" + path);
             return 4;
         }
         seen.insert(sig);
 
-        if (!read_binary_file(path, e.blob))
-        {
-            log_error("packlib: failed to read bytes for " + path);
-            return 4;
-        }
+        writer.add(keyHash, stage, path, bin);
 
-        entries.push_back(std::move(e));
+        // Reflection and keyword values are reduced to signatures by add(); drop the rest early.
+        r = {};
     }
 
-    // deterministic order
-    std::sort(entries.begin(), entries.end(), [](const ShaderLibraryEntry& a, const ShaderLibraryEntry& b) {
-        if (a.keyHash != b.keyHash)
-            return a.keyHash < b.keyHash;
-        return static_cast<uint8_t>(a.stage) < static_cast<uint8_t>(b.stage);
-    });
-
-    auto w = write_vslib(outPath, entries, keywordsBytes.empty() ? nullptr : &keywordsBytes);
+    auto w = writer.write(outPath, keywordsBytes.empty() ? nullptr : &keywordsBytes);
     if (!w.isOk())
     {
         log_error("packlib: write failed: " + w.error().message);
         return 5;
     }
 
-    log_info("packlib: wrote " + outPath + " (" + std::to_string(entries.size()) + " entries)");
+    log_info("packlib: wrote " + outPath + " (" + std::to_string(writer.entryCount()) + " entries)");
     return 0;
 }
 
@@ -452,137 +539,194 @@ static int cmd_packlib(int argc, char** argv)
 // Cook manifest structs
 // ============================================================
 
-static int cmd_compile(int argc, char** argv)
+// Per-job arguments of `vshaderc compile`. In batch mode the command line provides defaults and
+// every response file line is parsed on top of a copy of them.
+struct CompileJobArgs
 {
-    // vshaderc compile -i <input> -o <out.vshbin> -S <stage> [options]
     std::string              inPath;
     std::string              outPath;
     std::string              stageStr;
     std::vector<std::string> includeDirs;
     std::vector<Define>      defines;
-    std::string              keywordsFile;
-    bool                     enableCache = true;
-    std::string              cacheDir    = ".vshader_cache";
-    bool                     verbose     = false;
+};
 
-    for (int i = 2; i < argc; ++i)
+// Loaded once per vshaderc invocation and shared by all jobs.
+struct CompileShared
+{
+    std::shared_ptr<const EngineKeywordsFile> engineKw;     // null without --keywords-file
+    std::shared_ptr<const BindingTable>       bindingTable; // null without --binding-table
+    bool                                      enableCache = true;
+    std::string                               cacheDir    = ".vshader_cache";
+    std::string                               projectRoot;
+    FileHashCache                             fileHashCache;
+    IncludeCache                              includeCache;
+
+    std::unique_ptr<SpirvValidationCache> validation; // --validate
+};
+
+struct CompileJobResult
+{
+    int         exitCode = 0; // same codes as a single-file compile
+    std::string error;
+    std::string log;
+    bool        fromCache = false;
+    long long   buildMs   = -1; // -1 if build_shader was not reached
+};
+
+static Define parse_define_arg(const std::string& def)
+{
+    auto   pos = def.find('=');
+    Define d;
+    if (pos == std::string::npos)
     {
-        std::string a = argv[i];
-        if (a == "-h" || a == "--help")
-        {
-            print_usage();
-            return 0;
-        }
-        else if (a == "-i" && i + 1 < argc)
-        {
-            inPath = argv[++i];
-        }
-        else if (a == "-o" && i + 1 < argc)
+        d.name  = def;
+        d.value = "";
+    }
+    else
+    {
+        d.name  = def.substr(0, pos);
+        d.value = def.substr(pos + 1);
+    }
+    return d;
+}
+
+// Consumes a per-job option at args[i] (and its value). Returns false if args[i] is not one.
+static bool parse_compile_job_arg(const std::vector<std::string>& args, size_t& i, CompileJobArgs& job)
+{
+    const std::string& a        = args[i];
+    const bool         hasValue = i + 1 < args.size();
+
+    if (a == "-i" && hasValue)
+        job.inPath = args[++i];
+    else if (a == "-o" && hasValue)
+        job.outPath = args[++i];
+    else if (a == "-S" && hasValue)
+        job.stageStr = args[++i];
+    else if (a == "-I" && hasValue)
+        job.includeDirs.push_back(args[++i]);
+    else if (a == "-D" && hasValue)
+        job.defines.push_back(parse_define_arg(args[++i]));
+    else
+        return false;
+    return true;
+}
+
+// Splits a response file line at whitespace; double quotes group an argument containing spaces.
+static bool tokenize_response_line(const std::string& line, std::vector<std::string>& out)
+{
+    out.clear();
+
+    std::string cur;
+    bool        inToken = false;
+    bool        quoted  = false;
+    for (char c : line)
+    {
+        if (c == '"')
         {
-            outPath = argv[++i];
+            quoted  = !quoted;
+            inToken = true;
         }
-        else if (a == "-S" && i + 1 < argc)
+        else if (!quoted && std::isspace(static_cast<unsigned char>(c)))
         {
-            stageStr = argv[++i];
+            if (inToken)
+                out.push_back(std::move(cur));
+            cur.clear();
+            inToken = false;
         }
-        else if (a == "-I" && i + 1 < argc)
+        else
         {
-            includeDirs.push_back(argv[++i]);
+            cur.push_back(c);
+            inToken = true;
         }
-        else if (a == "-D" && i + 1 < argc)
+    }
+    if (inToken)
+        out.push_back(std::move(cur));
+    return !quoted;
+}
+
+// Response file: one job per line (-i/-o/-S/-I/-D), '#' starts a comment line.
+static bool read_compile_response_file(const std::string&           path,
+                                       const CompileJobArgs&        defaults,
+                                       std::vector<CompileJobArgs>& outJobs,
+                                       std::string&                 outError)
+{
+    std::string text;
+    if (!read_text_file(path, text))
+    {
+        outError = "failed to read response file: " + path;
+        return false;
+    }
+
+    std::istringstream       iss(text);
+    std::string              line;
+    size_t                   lineNo = 0;
+    std::vector<std::string> toks;
+    while (std::getline(iss, line))
+    {
+        ++lineNo;
+        const std::string where = path + ":" + std::to_string(lineNo) + ": ";
+
+        const std::string t = trim_copy(line);
+        if (t.empty() || t.front() == '#')
+            continue;
+
+        if (!tokenize_response_line(t, toks))
         {
-            std::string def = argv[++i];
-            auto        pos = def.find('=');
-            Define      d;
-            if (pos == std::string::npos)
-            {
-                d.name  = def;
-                d.value = "";
-            }
-            else
-            {
-                d.name  = def.substr(0, pos);
-                d.value = def.substr(pos + 1);
-            }
-            defines.push_back(std::move(d));
+            outError = where + "unterminated quote";
+            return false;
         }
-        else if ((a == "--keywords-file" || a.rfind("--keywords-file=", 0) == 0))
+
+        CompileJobArgs job = defaults;
+        for (size_t i = 0; i < toks.size(); ++i)
         {
-            if (a == "--keywords-file")
+            if (!parse_compile_job_arg(toks, i, job))
             {
-                if (i + 1 >= argc)
-                {
-                    log_error("--keywords-file requires a path");
-                    return 2;
-                }
-                keywordsFile = argv[++i];
-            }
-            else
-            {
-                keywordsFile = a.substr(std::string("--keywords-file=").size());
+                outError = where + "unsupported job argument: " + toks[i];
+                return false;
             }
         }
-        else if (a == "--no-cache")
-        {
-            enableCache = false;
-        }
-        else if (a == "--cache" && i + 1 < argc)
-        {
-            cacheDir = argv[++i];
-        }
-        else if (a == "--verbose")
-        {
-            verbose = true;
-        }
-        else
-        {
-            log_error("Unknown compile argument: " + a);
-            print_usage();
-            return 2;
-        }
+        outJobs.push_back(std::move(job));
     }
+    return true;
+}
 
-    g_verbose = verbose;
+static CompileJobResult run_compile_job(const CompileJobArgs& job, CompileShared& shared)
+{
+    CompileJobResult res;
 
     ShaderStage stage = ShaderStage::eFrag;
-    if (!parse_stage(stageStr, stage))
+    if (!parse_stage(job.stageStr, stage))
     {
-        log_error("Invalid stage: " + stageStr);
-        return 3;
+        res.exitCode = 3;
+        res.error    = "Invalid stage: " + job.stageStr;
+        return res;
     }
 
-    if (inPath.empty() || outPath.empty())
+    if (job.inPath.empty() || job.outPath.empty())
     {
-        log_error("compile: input/output must be specified (-i/-o)");
-        return 4;
+        res.exitCode = 4;
+        res.error    = "compile: input/output must be specified (-i/-o)";
+        return res;
     }
 
-    std::string src;
-    if (!read_text_file(inPath, src))
+    auto src = std::make_shared<std::string>();
+    if (!read_text_file(job.inPath, *src))
     {
-        log_error("compile: failed to read input file: " + inPath);
-        return 5;
+        res.exitCode = 5;
+        res.error    = "compile: failed to read input file: " + job.inPath;
+        return res;
     }
 
-    EngineKeywordsFile engineKw;
-    bool               hasEngineKw = false;
-    if (!keywordsFile.empty())
+    std::vector<Define> defines = job.defines;
+    if (shared.engineKw)
     {
-        auto kwr = load_engine_keywords_vkw(keywordsFile);
-        if (!kwr.isOk())
-        {
-            log_error("compile: failed to parse keywords file: " + kwr.error().message);
-            return 5;
-        }
-        engineKw    = std::move(kwr.value());
-        hasEngineKw = true;
-
         // Parse shader metadata to discover declared keywords for injection.
-        auto mr = parse_vultra_metadata(src);
+        auto mr = parse_vultra_metadata(*src);
         if (!mr.isOk())
         {
-            log_error("compile: failed to parse shader metadata for keyword injection: " + mr.error().message);
-            return 5;
+            res.exitCode = 5;
+            res.error    = "compile: failed to parse shader metadata for keyword injection: " + mr.error().message;
+            return res;
         }
 
         // Build define map: do not override user -D
@@ -600,8 +744,8 @@ static int cmd_compile(int argc, char** argv)
             if (defMap.find(kd.name) != defMap.end())
                 continue;
 
-            auto iv = engineKw.values.find(kd.name);
-            if (iv != engineKw.values.end())
+            auto iv = shared.engineKw->values.find(kd.name);
+            if (iv != shared.engineKw->values.end())
             {
                 Define d;
                 d.name  = kd.name;
@@ -613,158 +757,3290 @@ static int cmd_compile(int argc, char** argv)
     }
 
     BuildRequest req;
-    req.source.virtualPath  = inPath;
-    req.source.sourceText   = std::move(src);
-    req.options.stage       = stage;
-    req.options.includeDirs = std::move(includeDirs);
-    req.options.defines     = std::move(defines);
+    req.source.virtualPath      = job.inPath;
+    req.source.sharedSourceText = std::move(src);
+    req.options.stage           = stage;
+    req.options.includeDirs     = job.includeDirs;
+    req.options.defines         = std::move(defines);
+    req.options.includeCache    = &shared.includeCache;
 
-    req.hasEngineKeywords = hasEngineKw;
-    if (hasEngineKw)
-        req.engineKeywords = std::move(engineKw);
+    req.sharedEngineKeywords = shared.engineKw;
+    req.sharedBindingTable   = shared.bindingTable;
 
-    req.enableCache = enableCache;
-    req.cacheDir    = cacheDir;
+    req.enableCache   = shared.enableCache;
+    req.cacheDir      = shared.cacheDir;
+    req.projectRoot   = shared.projectRoot;
+    req.fileHashCache = &shared.fileHashCache;
 
     auto start = std::chrono::steady_clock::now();
     auto r     = build_shader(req);
     auto end   = std::chrono::steady_clock::now();
 
-    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
-    log_info("compile: build_shader took " + std::to_string(ms) + " ms");
+    res.buildMs = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
 
     if (!r.isOk())
     {
-        log_error("compile: build failed: " + r.error().message);
-        return 6;
+        res.exitCode = 6;
+        res.error    = "compile: build failed: " + r.error().message;
+        return res;
     }
 
-    auto w = write_vshbin_file(outPath, r.value().binary);
-    if (!w.isOk())
+    if (shared.validation)
     {
-        log_error("compile: write failed: " + w.error().message);
-        return 7;
+        auto vr = shared.validation->validate(r.value().binary.spirv, r.value().binary.spirvHash);
+        if (!vr.isOk())
+        {
+            res.exitCode = 8;
+            res.error    = "compile: " + vr.error().message;
+            return res;
+        }
     }
 
-    log_info("compile: OK wrote " + outPath + (r.value().fromCache ? " (cache)" : ""));
-    if (g_verbose && !r.value().log.empty())
-        log_verbose("compile log:\n" + r.value().log);
-
-    return 0;
-}
-
-// ============================================================
-// build
-// ============================================================
-
-static bool infer_stage_from_shader_path(const std::filesystem::path& p, ShaderStage& outStage)
-{
-    // Accept:
-    //   foo.vert.vshader, foo.frag.vshader, foo.comp.vshader, ...
+    // Dependencies are only needed to validate cache entries; keep them out of the artifact.
+    r.value().binary.dependencies.clear();
 
-    auto ext = p.extension().string();
-    if (ext != ".vshader")
-        return false;
+    auto w = write_vshbin_file(job.outPath, r.value().binary);
+    if (!w.isOk())
+    {
+        res.exitCode = 7;
+        res.error    = "compile: write failed: " + w.error().message;
+        return res;
+    }
 
-    auto stem = p.stem().string();                                // foo.vert
-    auto ext2 = std::filesystem::path(stem).extension().string(); // .vert
-    return parse_stage(ext2.substr(1), outStage);
+    res.fromCache = r.value().fromCache;
+    res.log       = std::move(r.value().log);
+    return res;
 }
 
-static void scan_shader_root(const std::filesystem::path& root, std::vector<std::filesystem::path>& outFiles)
+static int cmd_compile(int argc, char** argv)
 {
-    outFiles.clear();
+    // vshaderc compile -i <input> -o <out.vshbin> -S <stage> [options]
+    // vshaderc compile @jobs.rsp [@more.rsp ...] [shared options]
+    const std::vector<std::string> args(argv + 2, argv + argc);
 
-    std::error_code ec;
-    if (!std::filesystem::exists(root, ec))
-        return;
+    CompileJobArgs           defaults;
+    std::vector<std::string> responseFiles;
+    std::string              keywordsFile;
+    std::string              bindingTablePath;
+    bool                     enableCache = true;
+    std::string              cacheDir    = ".vshader_cache";
+    std::string              projectRoot;
+    uint32_t                 jobs     = 0;
+    bool                     validate = false;
+    bool                     verbose  = false;
 
-    for (auto it = std::filesystem::recursive_directory_iterator(root, ec);
-         it != std::filesystem::recursive_directory_iterator();
-         it.increment(ec))
+    for (size_t i = 0; i < args.size(); ++i)
     {
-        if (ec)
-            break;
-
-        const auto& e = *it;
-        if (!e.is_regular_file(ec))
-            continue;
-
-        const auto& p = e.path();
-
-        // Keep this conservative: we mainly build *.vshader.
-        if (p.extension() == ".vshader")
+        const std::string& a = args[i];
+        if (a == "-h" || a == "--help")
+        {
+            print_usage();
+            return 0;
+        }
+        else if (parse_compile_job_arg(args, i, defaults))
         {
-            outFiles.push_back(p);
             continue;
         }
-    }
-
-    std::sort(outFiles.begin(), outFiles.end());
-}
-
-static void enumerate_permutation_variants(const std::vector<const KeywordDecl*>& permuteDecls,
-                                           size_t                                 idx,
-                                           std::vector<Define>&                   cur,
-                                           std::vector<std::vector<Define>>&      out)
-{
-    if (idx >= permuteDecls.size())
-    {
-        out.push_back(cur);
-        return;
-    }
-
-    const KeywordDecl* kd = permuteDecls[idx];
-
-    // Bool: {0,1}
-    if (kd->kind == KeywordValueKind::eBool)
-    {
-        // 0
+        else if (a.size() > 1 && a.front() == '@')
         {
-            Define d;
-            d.name  = kd->name;
-            d.value = "0";
-            cur.push_back(std::move(d));
-            enumerate_permutation_variants(permuteDecls, idx + 1, cur, out);
-            cur.pop_back();
+            responseFiles.push_back(a.substr(1));
         }
-        // 1
+        else if ((a == "--keywords-file" || a.rfind("--keywords-file=", 0) == 0))
         {
-            Define d;
-            d.name  = kd->name;
-            d.value = "1";
-            cur.push_back(std::move(d));
-            enumerate_permutation_variants(permuteDecls, idx + 1, cur, out);
-            cur.pop_back();
+            if (a == "--keywords-file")
+            {
+                if (i + 1 >= args.size())
+                {
+                    log_error("--keywords-file requires a path");
+                    return 2;
+                }
+                keywordsFile = args[++i];
+            }
+            else
+            {
+                keywordsFile = a.substr(std::string("--keywords-file=").size());
+            }
+        }
+        else if (a == "--no-cache")
+        {
+            enableCache = false;
+        }
+        else if (a == "--cache" && i + 1 < args.size())
+        {
+            cacheDir = args[++i];
+        }
+        else if (a == "--project-root" && i + 1 < args.size())
+        {
+            projectRoot = args[++i];
+        }
+        else if (a == "--binding-table" && i + 1 < args.size())
+        {
+            bindingTablePath = args[++i];
+        }
+        else if ((a == "-j" || a == "--jobs") && i + 1 < args.size())
+        {
+            jobs = static_cast<uint32_t>(std::strtoul(args[++i].c_str(), nullptr, 10));
+        }
+        else if (a == "--validate")
+        {
+            validate = true;
+        }
+        else if (a == "--verbose")
+        {
+            verbose = true;
+        }
+        else
+        {
+            log_error("Unknown compile argument: " + a);
+            print_usage();
+            return 2;
+        }
+    }
+
+    g_verbose = verbose;
+
+    if (validate && !spirv_validation_available())
+    {
+        log_error("compile: --validate requires vshadersystem built with the vshadersystem_spirv_tools option");
+        return 2;
+    }
+
+    std::vector<CompileJobArgs> jobList;
+    for (const auto& rsp : responseFiles)
+    {
+        std::string err;
+        if (!read_compile_response_file(rsp, defaults, jobList, err))
+        {
+            log_error("compile: " + err);
+            return 2;
+        }
+    }
+
+    CompileShared shared;
+    shared.enableCache = enableCache;
+    shared.cacheDir    = cacheDir;
+    shared.projectRoot = projectRoot;
+    if (validate)
+        shared.validation = std::make_unique<SpirvValidationCache>(enableCache ? cacheDir : std::string());
+
+    if (!keywordsFile.empty())
+    {
+        auto kwr = load_engine_keywords_vkw(keywordsFile);
+        if (!kwr.isOk())
+        {
+            log_error("compile: failed to parse keywords file: " + kwr.error().message);
+            return 5;
+        }
+        shared.engineKw = std::make_shared<const EngineKeywordsFile>(std::move(kwr.value()));
+    }
+
+    if (!bindingTablePath.empty())
+    {
+        auto btr = load_binding_table(bindingTablePath);
+        if (!btr.isOk())
+        {
+            log_error("compile: failed to load binding table: " + btr.error().message);
+            return 5;
+        }
+        shared.bindingTable = std::make_shared<const BindingTable>(std::move(btr.value()));
+    }
+
+    if (responseFiles.empty())
+    {
+        const auto res = run_compile_job(defaults, shared);
+
+        if (res.buildMs >= 0)
+            log_info("compile: build_shader took " + std::to_string(res.buildMs) + " ms");
+
+        if (res.exitCode != 0)
+        {
+            log_error(res.error);
+            return res.exitCode;
+        }
+
+        log_info("compile: OK wrote " + defaults.outPath + (res.fromCache ? " (cache)" : ""));
+        if (g_verbose && !res.log.empty())
+            log_verbose("compile log:\n" + res.log);
+
+        return 0;
+    }
+
+    // Batch: one process, shared keywords/binding table/include cache, jobs spread over a thread pool.
+    const auto batchStart = std::chrono::steady_clock::now();
+
+    std::vector<CompileJobResult> results(jobList.size());
+    std::mutex                    logMutex;
+    size_t                        finished = 0;
+    {
+        ThreadPool pool(jobs);
+        log_info("compile: batch of " + std::to_string(jobList.size()) + " jobs on " +
+                 std::to_string(pool.threadCount()) + " threads");
+
+        for (size_t j = 0; j < jobList.size(); ++j)
+        {
+            pool.submit([&, j]() {
+                results[j]     = run_compile_job(jobList[j], shared);
+                const auto& r  = results[j];
+                const auto& jb = jobList[j];
+
+                std::lock_guard<std::mutex> lock(logMutex);
+                const std::string           tag =
+                    "compile: [" + std::to_string(++finished) + "/" + std::to_string(jobList.size()) + "] ";
+                if (r.exitCode == 0)
+                {
+                    log_info(tag + "OK " + jb.outPath + (r.fromCache ? " (cache)" : ""));
+                    if (g_verbose && !r.log.empty())
+                        log_verbose("compile log (" + jb.inPath + "):\n" + r.log);
+                }
+                else
+                {
+                    log_error(tag + "exit " + std::to_string(r.exitCode) + " " + jb.inPath + ": " + r.error);
+                }
+            });
+        }
+        pool.wait();
+    }
+
+    const auto batchMs =
+        std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - batchStart).count();
+
+    // Exit with the status of the first failed job in response file order.
+    int    exitCode = 0;
+    size_t failed   = 0;
+    for (const auto& r : results)
+    {
+        if (r.exitCode == 0)
+            continue;
+        if (failed++ == 0)
+            exitCode = r.exitCode;
+    }
+
+    log_info("compile: batch done, " + std::to_string(jobList.size() - failed) + " ok, " + std::to_string(failed) +
+             " failed, " + std::to_string(batchMs) + " ms");
+    if (shared.validation)
+    {
+        log_info("compile: validated " + std::to_string(shared.validation->validatedCount()) +
+                 " SPIR-V modules, " + std::to_string(shared.validation->cachedCount()) + " already validated");
+    }
+    return exitCode;
+}
+
+// ============================================================
+// worker
+// ============================================================
+
+// Messages between `build --workers` and `vshaderc worker` processes (framing: process_pool.hpp):
+//   job   : virtualPath string, stage u8, profile u32, defineCount u32 * {name string, value string}, source string
+//   reply : ok u8, then
+//           ok    -> fromCache u8, compileMs f64, linkMs f64, vshbin blob, sizeVariantCount u32 * vshbin blob
+//           error -> code u32, message string
+// Strings and blobs are u32 size + bytes. The worker holds the rest of the request (include dirs,
+// keywords, binding table, cache) from its command line.
+
+static void put_u32(std::vector<uint8_t>& out, uint32_t v)
+{
+    uint8_t b[4];
+    std::memcpy(b, &v, 4);
+    out.insert(out.end(), b, b + 4);
+}
+
+static void put_u64(std::vector<uint8_t>& out, uint64_t v)
+{
+    uint8_t b[8];
+    std::memcpy(b, &v, 8);
+    out.insert(out.end(), b, b + 8);
+}
+
+static void put_f64(std::vector<uint8_t>& out, double v)
+{
+    uint8_t b[8];
+    std::memcpy(b, &v, 8);
+    out.insert(out.end(), b, b + 8);
+}
+
+static void put_bytes(std::vector<uint8_t>& out, const void* data, size_t size)
+{
+    put_u32(out, static_cast<uint32_t>(size));
+    out.insert(out.end(), static_cast<const uint8_t*>(data), static_cast<const uint8_t*>(data) + size);
+}
+
+static bool get_u32(const uint8_t*& p, const uint8_t* e, uint32_t& v)
+{
+    if (static_cast<size_t>(e - p) < 4)
+        return false;
+    std::memcpy(&v, p, 4);
+    p += 4;
+    return true;
+}
+
+static bool get_u64(const uint8_t*& p, const uint8_t* e, uint64_t& v)
+{
+    if (static_cast<size_t>(e - p) < 8)
+        return false;
+    std::memcpy(&v, p, 8);
+    p += 8;
+    return true;
+}
+
+static bool get_f64(const uint8_t*& p, const uint8_t* e, double& v)
+{
+    if (static_cast<size_t>(e - p) < 8)
+        return false;
+    std::memcpy(&v, p, 8);
+    p += 8;
+    return true;
+}
+
+static bool get_bytes(const uint8_t*& p, const uint8_t* e, std::span<const uint8_t>& out)
+{
+    uint32_t size = 0;
+    if (!get_u32(p, e, size) || size > static_cast<size_t>(e - p))
+        return false;
+    out = {p, size};
+    p += size;
+    return true;
+}
+
+static bool get_string(const uint8_t*& p, const uint8_t* e, std::string& out)
+{
+    std::span<const uint8_t> bytes;
+    if (!get_bytes(p, e, bytes))
+        return false;
+    out.assign(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+    return true;
+}
+
+static std::vector<uint8_t> encode_build_job(const std::string&         virtualPath,
+                                             std::string_view           sourceText,
+                                             ShaderStage                stage,
+                                             const std::vector<Define>& defines,
+                                             uint32_t                   profile)
+{
+    std::vector<uint8_t> out;
+    put_bytes(out, virtualPath.data(), virtualPath.size());
+    out.push_back(static_cast<uint8_t>(stage));
+    put_u32(out, profile);
+    put_u32(out, static_cast<uint32_t>(defines.size()));
+    for (const auto& d : defines)
+    {
+        put_bytes(out, d.name.data(), d.name.size());
+        put_bytes(out, d.value.data(), d.value.size());
+    }
+    put_bytes(out, sourceText.data(), sourceText.size());
+    return out;
+}
+
+static bool decode_build_job(std::span<const uint8_t> msg, BuildRequest& req, uint32_t& profile)
+{
+    const uint8_t* p = msg.data();
+    const uint8_t* e = msg.data() + msg.size();
+
+    uint32_t defineCount = 0;
+    if (!get_string(p, e, req.source.virtualPath) || p == e)
+        return false;
+    req.options.stage = static_cast<ShaderStage>(*p++);
+    if (!get_u32(p, e, profile) || !get_u32(p, e, defineCount) || defineCount > static_cast<size_t>(e - p))
+        return false;
+
+    req.options.defines.resize(defineCount);
+    for (auto& d : req.options.defines)
+    {
+        if (!get_string(p, e, d.name) || !get_string(p, e, d.value))
+            return false;
+    }
+    return get_string(p, e, req.source.sourceText) && p == e;
+}
+
+static std::vector<uint8_t> encode_build_reply(const Result<BuildResult>& br)
+{
+    std::vector<uint8_t> out;
+
+    // Serialize first: a binary that cannot be written is reported like a failed build.
+    std::vector<std::vector<uint8_t>> blobs;
+    Error                             error = br.isOk() ? Error::ok() : br.error();
+    if (br.isOk())
+    {
+        auto bytes = write_vshbin(br.value().binary);
+        for (size_t i = 0; bytes.isOk(); ++i)
+        {
+            blobs.push_back(std::move(bytes.value()));
+            if (i == br.value().sizeVariants.size())
+                break;
+            bytes = write_vshbin(br.value().sizeVariants[i]);
+        }
+        if (!bytes.isOk())
+            error = bytes.error();
+    }
+
+    out.push_back(error.code == ErrorCode::eOk ? 1 : 0);
+    if (error.code != ErrorCode::eOk)
+    {
+        put_u32(out, static_cast<uint32_t>(error.code));
+        put_bytes(out, error.message.data(), error.message.size());
+        return out;
+    }
+
+    out.push_back(br.value().fromCache ? 1 : 0);
+    put_f64(out, br.value().compileMs);
+    put_f64(out, br.value().linkMs);
+    put_bytes(out, blobs[0].data(), blobs[0].size());
+    put_u32(out, static_cast<uint32_t>(blobs.size() - 1));
+    for (size_t i = 1; i < blobs.size(); ++i)
+        put_bytes(out, blobs[i].data(), blobs[i].size());
+    return out;
+}
+
+// Memory a finished build holds until `build` consumes it; bounds how far compiles run ahead.
+static size_t build_result_bytes(const Result<BuildResult>& br)
+{
+    size_t bytes = sizeof(BuildResult);
+    if (!br.isOk())
+        return bytes + br.error().message.size();
+
+    bytes += br.value().binary.spirv.size() * sizeof(uint32_t) + br.value().log.size();
+    for (const auto& sv : br.value().sizeVariants)
+        bytes += sizeof(ShaderBinary) + sv.spirv.size() * sizeof(uint32_t);
+    return bytes;
+}
+
+static Result<BuildResult> decode_build_reply(std::span<const uint8_t> msg)
+{
+    const Result<BuildResult> malformed =
+        Result<BuildResult>::err({ErrorCode::eDeserializeError, "Malformed reply from worker process."});
+
+    const uint8_t* p = msg.data();
+    const uint8_t* e = msg.data() + msg.size();
+    if (p == e)
+        return malformed;
+
+    if (*p++ == 0)
+    {
+        uint32_t code = 0;
+        Error    error;
+        if (!get_u32(p, e, code) || !get_string(p, e, error.message))
+            return malformed;
+        error.code = static_cast<ErrorCode>(code);
+        return Result<BuildResult>::err(std::move(error));
+    }
+
+    BuildResult              out;
+    std::span<const uint8_t> blob;
+    uint32_t                 sizeVariantCount = 0;
+    if (p == e)
+        return malformed;
+    out.fromCache = *p++ != 0;
+    if (!get_f64(p, e, out.compileMs) || !get_f64(p, e, out.linkMs) || !get_bytes(p, e, blob))
+        return malformed;
+
+    auto bin = read_vshbin(blob);
+    if (!bin.isOk())
+        return Result<BuildResult>::err(bin.error());
+    out.binary = std::move(bin.value());
+
+    if (!get_u32(p, e, sizeVariantCount))
+        return malformed;
+    for (uint32_t i = 0; i < sizeVariantCount; ++i)
+    {
+        if (!get_bytes(p, e, blob))
+            return malformed;
+        auto sv = read_vshbin(blob);
+        if (!sv.isOk())
+            return Result<BuildResult>::err(sv.error());
+        out.sizeVariants.push_back(std::move(sv.value()));
+    }
+
+    return Result<BuildResult>::ok(std::move(out));
+}
+
+static int cmd_worker(int argc, char** argv)
+{
+    // vshaderc worker [-I <dir> ...] [--profile-keywords <vkw|-> ...] [--binding-table <vbt>]
+    // [--workgroup-sizes <list>] [--cache <dir>|--no-cache] [--project-root <dir>] [--link-module <path> ...]
+    // Started by `build --workers`; serves build jobs over stdin/stdout until stdin closes.
+    std::vector<std::string>   includeDirs;
+    std::vector<std::string>   keywordsPaths;
+    std::string                bindingTablePath;
+    std::vector<WorkgroupSize> workgroupSizes;
+    bool                       enableCache = true;
+    std::string                cacheDir    = ".vshader_cache";
+    std::string                projectRoot;
+    std::vector<std::string>   linkModules;
+
+    // Setup errors are returned for every job, so the build reports them instead of seeing crashes.
+    std::string setupError;
+
+    for (int i = 2; i < argc; ++i)
+    {
+        std::string a = argv[i];
+
+        if (a == "-I" && i + 1 < argc)
+        {
+            includeDirs.push_back(argv[++i]);
+        }
+        else if (a == "--profile-keywords" && i + 1 < argc)
+        {
+            keywordsPaths.push_back(argv[++i]);
+        }
+        else if (a == "--binding-table" && i + 1 < argc)
+        {
+            bindingTablePath = argv[++i];
+        }
+        else if (a == "--workgroup-sizes" && i + 1 < argc)
+        {
+            auto wr = parse_workgroup_sizes(argv[++i]);
+            if (wr.isOk())
+                workgroupSizes = std::move(wr.value());
+            else
+                setupError = wr.error().message;
+        }
+        else if (a == "--no-cache")
+        {
+            enableCache = false;
+        }
+        else if (a == "--cache" && i + 1 < argc)
+        {
+            cacheDir = argv[++i];
+        }
+        else if (a == "--project-root" && i + 1 < argc)
+        {
+            projectRoot = argv[++i];
+        }
+        else if (a == "--link-module" && i + 1 < argc)
+        {
+            linkModules.push_back(argv[++i]);
+        }
+        else
+        {
+            setupError = "Unknown worker arg: " + a;
+        }
+    }
+
+    // Loaded once and shared by every job's request; null = profile without keywords.
+    std::vector<std::shared_ptr<const EngineKeywordsFile>> profiles(std::max<size_t>(keywordsPaths.size(), 1));
+    for (size_t pi = 0; pi < keywordsPaths.size(); ++pi)
+    {
+        if (keywordsPaths[pi] == "-")
+            continue;
+
+        auto kwr = load_engine_keywords_vkw(keywordsPaths[pi]);
+        if (!kwr.isOk())
+        {
+            setupError = "failed to parse keywords file: " + kwr.error().message;
+            continue;
+        }
+        profiles[pi] = std::make_shared<const EngineKeywordsFile>(std::move(kwr.value()));
+    }
+
+    std::shared_ptr<const BindingTable> bindingTable;
+    if (!bindingTablePath.empty())
+    {
+        auto btr = load_binding_table(bindingTablePath);
+        if (btr.isOk())
+            bindingTable = std::make_shared<const BindingTable>(std::move(btr.value()));
+        else
+            setupError = "failed to load binding table: " + btr.error().message;
+    }
+
+    const auto sharedIncludeDirs = std::make_shared<const std::vector<std::string>>(std::move(includeDirs));
+
+    // Live for the worker's lifetime, so headers are read and guard-scanned once per worker, not per job.
+    IncludeCache    includeCache;
+    FileHashCache   fileHashCache;
+    LinkModuleCache linkModuleCache;
+
+    return run_process_pool_worker([&](std::span<const uint8_t> msg) {
+        if (!setupError.empty())
+            return encode_build_reply(
+                Result<BuildResult>::err({ErrorCode::eInvalidArgument, "worker: " + setupError}));
+
+        BuildRequest req;
+        uint32_t     profile = 0;
+        if (!decode_build_job(msg, req, profile) || profile >= profiles.size())
+            return encode_build_reply(
+                Result<BuildResult>::err({ErrorCode::eDeserializeError, "worker: malformed build job"}));
+
+        req.options.sharedIncludeDirs = sharedIncludeDirs;
+        req.options.includeCache      = &includeCache;
+        req.sharedEngineKeywords      = profiles[profile];
+        req.sharedBindingTable        = bindingTable;
+
+        if (req.options.stage == ShaderStage::eComp)
+            req.workgroupSizes = workgroupSizes;
+
+        req.enableCache     = enableCache;
+        req.cacheDir        = cacheDir;
+        req.projectRoot     = projectRoot;
+        req.fileHashCache   = &fileHashCache;
+        req.linkModules     = linkModules;
+        req.linkModuleCache = &linkModuleCache;
+
+        return encode_build_reply(build_shader(req));
+    });
+}
+
+// ============================================================
+// build
+// ============================================================
+
+static bool infer_stage_from_shader_path(const std::filesystem::path& p, ShaderStage& outStage)
+{
+    // Accept:
+    //   foo.vert.vshader, foo.frag.vshader, foo.comp.vshader, ...
+
+    auto ext = p.extension().string();
+    if (ext != ".vshader")
+        return false;
+
+    auto stem = p.stem().string();                                // foo.vert
+    auto ext2 = std::filesystem::path(stem).extension().string(); // .vert
+    return parse_stage(ext2.substr(1), outStage);
+}
+
+static void scan_shader_root(const std::filesystem::path& root, std::vector<std::filesystem::path>& outFiles)
+{
+    outFiles.clear();
+
+    std::error_code ec;
+    if (!std::filesystem::exists(root, ec))
+        return;
+
+    for (auto it = std::filesystem::recursive_directory_iterator(root, ec);
+         it != std::filesystem::recursive_directory_iterator();
+         it.increment(ec))
+    {
+        if (ec)
+            break;
+
+        const auto& e = *it;
+        if (!e.is_regular_file(ec))
+            continue;
+
+        const auto& p = e.path();
+
+        // Keep this conservative: we mainly build *.vshader.
+        if (p.extension() == ".vshader")
+        {
+            outFiles.push_back(p);
+            continue;
+        }
+    }
+
+    std::sort(outFiles.begin(), outFiles.end());
+}
+
+static void add_implicit_include_dirs(const std::filesystem::path& shaderRootPath,
+                                      std::vector<std::string>&    includeDirs)
+{
+    // Implicit include dirs: shader_root and shader_root/include if present.
+    includeDirs.push_back(shaderRootPath.generic_string());
+    const auto      inc = shaderRootPath / "include";
+    std::error_code ec;
+    if (std::filesystem::exists(inc, ec))
+        includeDirs.push_back(inc.generic_string());
+}
+
+static void resolve_shader_files(const std::filesystem::path&        shaderRootPath,
+                                 const std::vector<std::string>&     shaders,
+                                 std::vector<std::filesystem::path>& outFiles)
+{
+    // No explicit list: build everything under shader_root.
+    if (shaders.empty())
+    {
+        scan_shader_root(shaderRootPath, outFiles);
+        return;
+    }
+
+    outFiles.clear();
+    outFiles.reserve(shaders.size());
+    for (const auto& s : shaders)
+    {
+        std::filesystem::path p = s;
+        if (p.is_relative())
+            p = shaderRootPath / p;
+        outFiles.push_back(std::filesystem::weakly_canonical(p));
+    }
+    std::sort(outFiles.begin(), outFiles.end());
+}
+
+struct MaterialLayoutSummary
+{
+    size_t   blocks         = 0;
+    uint64_t declaredBytes  = 0;
+    uint64_t paddingBytes   = 0;
+    uint64_t optimizedBytes = 0;
+    uint64_t scalarBytes    = 0;
+};
+
+static uint64_t material_layout_sig(const std::string& virtualPath, const MaterialDescription& mdesc)
+{
+    uint64_t sig = xxhash64(virtualPath);
+    for (const auto& p : mdesc.params)
+    {
+        sig = xxhash64(p.name, sig);
+        sig = xxhash64(&p.offset, sizeof(p.offset), sig);
+        sig = xxhash64(&p.size, sizeof(p.size), sig);
+    }
+    return sig;
+}
+
+static void report_material_layout(const std::string&            virtualPath,
+                                   const MaterialDescription&    mdesc,
+                                   std::unordered_set<uint64_t>& seenLayouts,
+                                   MaterialLayoutSummary&        summary)
+{
+    if (mdesc.params.empty())
+        return;
+
+    // Variants usually share the Material block; count each distinct layout of a shader once.
+    if (!seenLayouts.insert(material_layout_sig(virtualPath, mdesc)).second)
+        return;
+
+    const auto r = analyze_material_layout(mdesc);
+
+    ++summary.blocks;
+    summary.declaredBytes += r.declaredSize;
+    summary.paddingBytes += r.paddingBytes;
+    summary.optimizedBytes += r.optimizedSize;
+    summary.scalarBytes += r.scalarSize;
+
+    if (r.paddingBytes == 0)
+        return;
+
+    log_info("build: material layout " + virtualPath + ": size=" + std::to_string(r.declaredSize) +
+             " padding=" + std::to_string(r.paddingBytes) + " reordered=" + std::to_string(r.optimizedSize) +
+             " scalar=" + std::to_string(r.scalarSize));
+
+    if (!r.suggestedOrder.empty())
+    {
+        std::string order;
+        for (const auto& name : r.suggestedOrder)
+            order += (order.empty() ? "" : ", ") + name;
+        log_verbose("build:   suggested member order: " + order);
+    }
+}
+
+struct MaterialGlslState
+{
+    uint64_t sig              = 0; // layout the include was generated from; 0 = not written yet
+    bool     mismatchReported = false;
+};
+
+// Writes <dir>/<shader id>.material.glsl from the first variant that has a Material block.
+// The decoders hard-code offsets, so variants with a different layout are reported, not merged.
+static bool write_material_pool_include(const std::string&         dir,
+                                        const std::string&         virtualPath,
+                                        const MaterialDescription& mdesc,
+                                        MaterialGlslState&         state)
+{
+    if (dir.empty() || mdesc.params.empty())
+        return true;
+
+    const uint64_t sig = material_layout_sig(virtualPath, mdesc);
+    if (state.sig != 0)
+    {
+        if (sig != state.sig && !state.mismatchReported)
+        {
+            log_info("build: " + virtualPath +
+                     ": variants have different Material layouts; material GLSL follows the first one");
+            state.mismatchReported = true;
+        }
+        return true;
+    }
+
+    const std::string shaderId = shader_id_from_virtual_path(virtualPath);
+
+    MaterialPoolGlslOptions opt;
+    opt.prefix     = material_pool_prefix(shaderId);
+    opt.sourceName = virtualPath;
+
+    std::error_code ec;
+    std::filesystem::create_directories(dir, ec);
+
+    const auto    path = std::filesystem::path(dir) / (shaderId + ".material.glsl");
+    std::ofstream out(path, std::ios::binary);
+    if (!out)
+        return false;
+    out << generate_material_pool_glsl(mdesc, opt);
+    if (!out)
+        return false;
+
+    state.sig = sig;
+    log_verbose("build: material GLSL -> " + path.generic_string());
+    return true;
+}
+
+// Publishes the views as a complete library: written to <out>.tmp and renamed over <out>, so readers
+// never see a partial library. The first view of each (keyHash, stage) wins.
+static bool publish_library_views(const std::string&                       outLibPath,
+                                  std::vector<ShaderLibraryEntryView>      views,
+                                  const std::vector<uint8_t>*              keywordsBytes,
+                                  const std::vector<ShaderLibraryProfile>* profiles)
+{
+    std::stable_sort(views.begin(), views.end(), [](const ShaderLibraryEntryView& a, const ShaderLibraryEntryView& b) {
+        if (a.keyHash != b.keyHash)
+            return a.keyHash < b.keyHash;
+        return static_cast<uint8_t>(a.stage) < static_cast<uint8_t>(b.stage);
+    });
+    views.erase(std::unique(views.begin(),
+                            views.end(),
+                            [](const ShaderLibraryEntryView& a, const ShaderLibraryEntryView& b) {
+                                return a.keyHash == b.keyHash && a.stage == b.stage;
+                            }),
+                views.end());
+
+    const auto      outPath = std::filesystem::path(outLibPath);
+    std::error_code ec;
+    if (outPath.has_parent_path())
+        std::filesystem::create_directories(outPath.parent_path(), ec);
+
+    const std::string tmpPath = outLibPath + ".tmp";
+    if (!write_vslib(tmpPath, std::span<const ShaderLibraryEntryView>(views), keywordsBytes, profiles).isOk())
+        return false;
+
+    std::filesystem::rename(tmpPath, outPath, ec);
+    return !ec;
+}
+
+static bool publish_library_snapshot(const std::string&                       outLibPath,
+                                     const std::vector<ShaderLibraryEntry>&   entries,
+                                     const std::vector<uint8_t>*              keywordsBytes,
+                                     const std::vector<ShaderLibraryProfile>* profiles)
+{
+    std::vector<ShaderLibraryEntryView> views;
+    views.reserve(entries.size());
+    for (const auto& e : entries)
+        views.push_back({e.keyHash, e.stage, e.blob, e.profileMask});
+
+    return publish_library_views(outLibPath, std::move(views), keywordsBytes, profiles);
+}
+
+// "<name>=<id>[,<id>...]" of --group / --split-group.
+static bool parse_shader_group_spec(const std::string& spec, ShaderGroup& out)
+{
+    const size_t eq = spec.find('=');
+    if (eq == std::string::npos || eq == 0)
+        return false;
+
+    out      = {};
+    out.name = trim_copy(spec.substr(0, eq));
+
+    std::stringstream ids(spec.substr(eq + 1));
+    std::string       id;
+    while (std::getline(ids, id, ','))
+    {
+        id = trim_copy(id);
+        if (!id.empty())
+            out.shaderIds.push_back(id);
+    }
+    return !out.name.empty() && !out.shaderIds.empty();
+}
+
+// Writes <outDir>/<baseName>.<partition>.vshlib per partition plus <outDir>/<baseName>.vshroute.
+static bool write_partitioned_library(const std::string&                       tag,
+                                      std::span<const ShaderLibraryEntryView>  entries,
+                                      const LibraryPartitionPlan&              plan,
+                                      const std::string&                       outDir,
+                                      const std::string&                       baseName,
+                                      const std::vector<uint8_t>*              keywordsBytes,
+                                      const std::vector<ShaderLibraryProfile>* profiles)
+{
+    auto pr = partition_library_entries(entries, plan);
+    if (!pr.isOk())
+    {
+        log_error(tag + ": " + pr.error().message);
+        return false;
+    }
+
+    for (const auto& p : pr.value())
+        log_info(tag + ": partition " + p.name + " entries=" + std::to_string(p.entries.size()) +
+                 " shaders=" + std::to_string(p.shaderIdHashes.size()));
+
+    auto wr = write_library_partitions(pr.value(), outDir, baseName, keywordsBytes, profiles);
+    if (!wr.isOk())
+    {
+        log_error(tag + ": " + wr.error().message);
+        return false;
+    }
+
+    log_info(tag + ": OK -> " + (std::filesystem::path(outDir) / (baseName + ".vshroute")).generic_string() +
+             " partitions=" + std::to_string(wr.value().partitions().size()));
+    return true;
+}
+
+// Build records let `build` skip shaders that are unchanged since the last build. A record holds the
+// results of every variant of one shader, in <cache>/records/, under the inputs hash deps.graph also
+// stores for the shader:
+//   record : tag string, version u32, inputsHash u64, variantCount u32 * {variant u32, reply blob}
+// with replies in the worker reply encoding. Bump kBuildRecordVersion when build output changes.
+static constexpr std::string_view kBuildRecordTag     = "vshrec";
+static constexpr uint32_t         kBuildRecordVersion = 1;
+
+using ShaderInputs = std::vector<std::pair<std::string, uint64_t>>; // include path, content hash
+
+// Hash of everything a shader's results depend on: build settings (configHash), source, variant list
+// and the contents of every include. 0 if an include was seen with two different contents.
+static uint64_t shader_inputs_hash(uint64_t           configHash,
+                                   const std::string& source,
+                                   uint64_t           variantsHash,
+                                   ShaderInputs       includes)
+{
+    std::sort(includes.begin(), includes.end());
+    includes.erase(std::unique(includes.begin(), includes.end()), includes.end());
+
+    uint64_t h = xxhash64(source, configHash);
+    h          = xxhash64(&variantsHash, sizeof(variantsHash), h);
+    for (size_t i = 0; i < includes.size(); ++i)
+    {
+        if (i > 0 && includes[i].first == includes[i - 1].first)
+            return 0;
+
+        h = xxhash64(includes[i].first, h);
+        h = xxhash64(&includes[i].second, sizeof(includes[i].second), h);
+    }
+    return h;
+}
+
+static uint64_t variant_list_hash(ShaderStage                             stage,
+                                  const std::vector<std::vector<Define>>& variants,
+                                  const std::vector<uint64_t>&            profileMasks)
+{
+    uint64_t h = xxhash64(shader_stage_name(stage));
+    for (size_t vi = 0; vi < variants.size(); ++vi)
+    {
+        for (const auto& d : variants[vi])
+            h = xxhash64(d.name + "=" + d.value + ";", h);
+        h = xxhash64(&profileMasks[vi], sizeof(profileMasks[vi]), h);
+    }
+    return h;
+}
+
+static std::string build_record_path(const std::string& cacheDir, const std::string& virtualPath)
+{
+    char name[32];
+    std::snprintf(name, sizeof(name), "%016llx.vshrec", static_cast<unsigned long long>(xxhash64(virtualPath)));
+    return (std::filesystem::path(cacheDir) / "records" / name).string();
+}
+
+static bool write_build_record(const std::string&          path,
+                               uint64_t                    inputsHash,
+                               uint32_t                    variantCount,
+                               const std::vector<uint8_t>& variants)
+{
+    std::vector<uint8_t> out;
+    put_bytes(out, kBuildRecordTag.data(), kBuildRecordTag.size());
+    put_u32(out, kBuildRecordVersion);
+    put_u64(out, inputsHash);
+    put_u32(out, variantCount);
+    out.insert(out.end(), variants.begin(), variants.end());
+
+    std::error_code ec;
+    std::filesystem::create_directories(std::filesystem::path(path).parent_path(), ec);
+
+    const std::string tmpPath = path + ".tmp";
+    {
+        std::ofstream f(tmpPath, std::ios::binary | std::ios::trunc);
+        if (!f || !f.write(reinterpret_cast<const char*>(out.data()), static_cast<std::streamsize>(out.size())))
+            return false;
+    }
+    std::filesystem::rename(tmpPath, path, ec);
+    return !ec;
+}
+
+// Results of the record's variants by variant index, as cache hits; empty if the record is missing,
+// damaged or was written for other inputs.
+static std::vector<std::optional<Result<BuildResult>>> read_build_record(const std::string& path,
+                                                                         uint64_t           inputsHash,
+                                                                         size_t             variantCount)
+{
+    std::vector<uint8_t> bytes;
+    if (!read_binary_file(path, bytes))
+        return {};
+
+    const uint8_t* p = bytes.data();
+    const uint8_t* e = bytes.data() + bytes.size();
+
+    std::string tag;
+    uint32_t    version     = 0;
+    uint64_t    recordHash  = 0;
+    uint32_t    recordCount = 0;
+    if (!get_string(p, e, tag) || tag != kBuildRecordTag || !get_u32(p, e, version) ||
+        version != kBuildRecordVersion || !get_u64(p, e, recordHash) || recordHash != inputsHash ||
+        !get_u32(p, e, recordCount) || recordCount != variantCount)
+        return {};
+
+    std::vector<std::optional<Result<BuildResult>>> out(variantCount);
+    for (uint32_t i = 0; i < recordCount; ++i)
+    {
+        uint32_t                 variant = 0;
+        std::span<const uint8_t> reply;
+        if (!get_u32(p, e, variant) || variant >= variantCount || out[variant] || !get_bytes(p, e, reply))
+            return {};
+
+        auto br = decode_build_reply(reply);
+        if (!br.isOk())
+            return {};
+
+        br.value().fromCache = true;
+        br.value().compileMs = 0.0;
+        br.value().linkMs    = 0.0;
+        out[variant].emplace(std::move(br));
+    }
+    return out;
+}
+
+// Engine keyword profile of a multi-configuration build (--profile <name>=<vkw>).
+struct BuildProfile
+{
+    std::string          name; // empty for the implicit --keywords-file profile
+    std::string          keywordsPath;
+    EngineKeywordsFile   keywords;
+    bool                 hasKeywords = false;
+    std::vector<uint8_t> keywordsBytes;
+};
+
+static int cmd_build(int argc, char** argv)
+{
+    // vshaderc build --shader_root <dir> [--shader <path> ...] [-I <dir> ...] [--keywords-file <vkw>] -o <vshlib>
+    // [--cache dir] [--no-cache] [--project-root dir] [--skip-invalid] [--verbose]
+    std::string                shaderRoot;
+    std::vector<std::string>   shaders;
+    std::vector<std::string>   includeDirs;
+    std::string                keywordsPath;
+    std::string                bindingTablePath;
+    std::string                outLibPath;
+    bool                       enableCache = true;
+    std::string                cacheDir    = ".vshader_cache";
+    std::string                projectRoot;
+    std::vector<WorkgroupSize> workgroupSizes;
+    std::string                materialGlslDir;
+    std::vector<std::string>   linkModules;
+    bool                       linkReport = false;
+    std::string                splitManifestPath;
+    LibraryPartitionPlan       splitPlan;
+    bool                       progressive      = false;
+    uint32_t                   snapshotInterval = 120;
+    std::string                usageLogPath;
+    std::vector<BuildProfile>  profiles;
+    bool                       mergeProfiles = false;
+    bool                       useWorkers    = false;
+    uint32_t                   workerCount   = 0;
+    uint32_t                   workerJobs    = 256;
+    uint64_t                   workerMaxMb   = 0;
+    uint32_t                   threadCount   = 0;
+    std::string                workgroupSizesArg;
+    std::string                stripPluginPath;
+    bool                       validate    = false;
+    bool                       skipInvalid = false;
+    bool                       verbose     = false;
+
+    for (int i = 2; i < argc; ++i)
+    {
+        std::string a = argv[i];
+
+        if (a == "--shader_root" && i + 1 < argc)
+        {
+            shaderRoot = normalize_path_slashes(argv[++i]);
+        }
+        else if (a == "--shader" && i + 1 < argc)
+        {
+            shaders.push_back(normalize_path_slashes(argv[++i]));
+        }
+        else if (a == "-I" && i + 1 < argc)
+        {
+            includeDirs.push_back(normalize_path_slashes(argv[++i]));
+        }
+        else if ((a == "--keywords-file" || a.rfind("--keywords-file=", 0) == 0))
+        {
+            if (a == "--keywords-file")
+            {
+                if (i + 1 >= argc)
+                {
+                    log_error("--keywords-file requires a path");
+                    return 2;
+                }
+                keywordsPath = argv[++i];
+            }
+            else
+            {
+                keywordsPath = a.substr(std::string("--keywords-file=").size());
+            }
+        }
+        else if (a == "-o" && i + 1 < argc)
+        {
+            outLibPath = argv[++i];
+        }
+        else if (a == "--no-cache")
+        {
+            enableCache = false;
+        }
+        else if (a == "--cache" && i + 1 < argc)
+        {
+            cacheDir = argv[++i];
+        }
+        else if (a == "--project-root" && i + 1 < argc)
+        {
+            projectRoot = normalize_path_slashes(argv[++i]);
+        }
+        else if (a == "--binding-table" && i + 1 < argc)
+        {
+            bindingTablePath = argv[++i];
+        }
+        else if (a == "--workgroup-sizes" && i + 1 < argc)
+        {
+            workgroupSizesArg = argv[++i];
+            auto wr           = parse_workgroup_sizes(workgroupSizesArg);
+            if (!wr.isOk())
+            {
+                log_error("build: " + wr.error().message);
+                return 2;
+            }
+            workgroupSizes = std::move(wr.value());
+        }
+        else if (a == "--material-glsl" && i + 1 < argc)
+        {
+            materialGlslDir = argv[++i];
+        }
+        else if (a == "--link-module" && i + 1 < argc)
+        {
+            linkModules.push_back(normalize_path_slashes(argv[++i]));
+        }
+        else if (a == "--link-report")
+        {
+            linkReport = true;
+        }
+        else if (a == "--split-manifest" && i + 1 < argc)
+        {
+            splitManifestPath = argv[++i];
+        }
+        else if (a == "--split-group" && i + 1 < argc)
+        {
+            ShaderGroup g;
+            if (!parse_shader_group_spec(argv[++i], g))
+            {
+                log_error(std::string("build: invalid --split-group (expected <name>=<id>[,<id>...]): ") + argv[i]);
+                return 2;
+            }
+            splitPlan.groups.push_back(std::move(g));
+        }
+        else if (a == "--split-keyword" && i + 1 < argc)
+        {
+            splitPlan.keyword = argv[++i];
+        }
+        else if (a == "--progressive")
+        {
+            progressive = true;
+        }
+        else if (a == "--snapshot-every" && i + 1 < argc)
+        {
+            snapshotInterval = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        }
+        else if (a == "--usage-log" && i + 1 < argc)
+        {
+            usageLogPath = argv[++i];
+        }
+        else if (a == "--profile" && i + 1 < argc)
+        {
+            const std::string spec = argv[++i];
+            const size_t      eq   = spec.find('=');
+            if (eq == std::string::npos || eq == 0 || eq + 1 == spec.size())
+            {
+                log_error("build: invalid --profile (expected <name>=<path.vkw>): " + spec);
+                return 2;
+            }
+
+            BuildProfile p;
+            p.name         = trim_copy(spec.substr(0, eq));
+            p.keywordsPath = trim_copy(spec.substr(eq + 1));
+            profiles.push_back(std::move(p));
+        }
+        else if (a == "--merge-profiles")
+        {
+            mergeProfiles = true;
+        }
+        else if (a == "--workers" && i + 1 < argc)
+        {
+            useWorkers  = true;
+            workerCount = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        }
+        else if (a == "--worker-jobs" && i + 1 < argc)
+        {
+            workerJobs = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        }
+        else if (a == "--worker-max-mb" && i + 1 < argc)
+        {
+            workerMaxMb = std::strtoull(argv[++i], nullptr, 10);
+        }
+        else if ((a == "-j" || a == "--jobs") && i + 1 < argc)
+        {
+            threadCount = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        }
+        else if (a == "--validate")
+        {
+            validate = true;
+        }
+        else if (a == "--strip-plugin" && i + 1 < argc)
+        {
+            stripPluginPath = argv[++i];
+        }
+        else if (a == "--skip-invalid")
+        {
+            skipInvalid = true;
+        }
+        else if (a == "--verbose")
+        {
+            verbose = true;
+        }
+        else if (a == "-h" || a == "--help")
+        {
+            print_usage();
+            return 0;
+        }
+        else
+        {
+            log_error("Unknown build arg: " + a);
+            return 2;
+        }
+    }
+
+    g_verbose = verbose;
+
+    if (shaderRoot.empty())
+    {
+        log_error("build: --shader_root <dir> is required");
+        return 2;
+    }
+    if (outLibPath.empty())
+    {
+        log_error("build: -o <output.vshlib> is required");
+        return 2;
+    }
+
+    std::filesystem::path shaderRootPath = std::filesystem::absolute(shaderRoot);
+
+    if (projectRoot.empty())
+        projectRoot = shaderRootPath.generic_string();
+
+    add_implicit_include_dirs(shaderRootPath, includeDirs);
+
+    if (!linkModules.empty() && !spirv_linking_available())
+    {
+        log_error("build: --link-module requires vshadersystem built with the vshadersystem_spirv_tools option");
+        return 2;
+    }
+    if (linkReport && linkModules.empty())
+    {
+        log_error("build: --link-report requires at least one --link-module");
+        return 2;
+    }
+    if (validate && !spirv_validation_available())
+    {
+        log_error("build: --validate requires vshadersystem built with the vshadersystem_spirv_tools option");
+        return 2;
+    }
+
+    VariantStripper stripper;
+    if (!stripPluginPath.empty())
+    {
+        auto sr = load_variant_strip_plugin(stripPluginPath);
+        if (!sr.isOk())
+        {
+            log_error("build: " + sr.error().message);
+            return 3;
+        }
+        stripper = std::move(sr.value());
+        log_info("build: strip plugin " + stripPluginPath);
+    }
+
+    const bool split = !splitManifestPath.empty() || !splitPlan.groups.empty() || !splitPlan.keyword.empty();
+    if (!splitManifestPath.empty())
+    {
+        auto mr = load_partition_manifest(splitManifestPath);
+        if (!mr.isOk())
+        {
+            log_error("build: " + mr.error().message);
+            return 3;
+        }
+        splitPlan.groups.insert(splitPlan.groups.begin(), mr.value().begin(), mr.value().end());
+    }
+
+    if (progressive && split)
+    {
+        log_error("build: --progressive publishes one library and cannot be combined with --split-*");
+        return 2;
+    }
+    if (!usageLogPath.empty() && !progressive)
+    {
+        log_error("build: --usage-log only orders --progressive builds");
+        return 2;
+    }
+
+    // Named profiles each produce their own library (or their PROF bit with --merge-profiles); without
+    // them the build is a single unnamed profile using --keywords-file.
+    const bool namedProfiles = !profiles.empty();
+    if (namedProfiles && !keywordsPath.empty())
+    {
+        log_error("build: --keywords-file cannot be combined with --profile; give each profile its own .vkw");
+        return 2;
+    }
+    if (mergeProfiles && !namedProfiles)
+    {
+        log_error("build: --merge-profiles requires at least one --profile");
+        return 2;
+    }
+    if (namedProfiles && split)
+    {
+        log_error("build: --profile cannot be combined with --split-*");
+        return 2;
+    }
+    if (namedProfiles && progressive && !mergeProfiles)
+    {
+        log_error("build: --progressive publishes one library; use --merge-profiles with --profile");
+        return 2;
+    }
+    if (profiles.size() > kMaxLibraryProfiles)
+    {
+        log_error("build: at most " + std::to_string(kMaxLibraryProfiles) + " profiles are supported");
+        return 2;
+    }
+    for (size_t pi = 0; pi < profiles.size(); ++pi)
+    {
+        for (size_t pj = 0; pj < pi; ++pj)
+        {
+            if (profiles[pj].name == profiles[pi].name)
+            {
+                log_error("build: duplicate --profile name: " + profiles[pi].name);
+                return 2;
+            }
+        }
+    }
+    if (!namedProfiles)
+    {
+        profiles.emplace_back();
+        profiles.back().keywordsPath = keywordsPath;
+    }
+
+    VariantUsageLog usageLog;
+    if (!usageLogPath.empty())
+    {
+        auto ur = VariantUsageLog::load(usageLogPath);
+        if (!ur.isOk())
+        {
+            log_error("build: " + ur.error().message);
+            return 3;
+        }
+        usageLog = std::move(ur.value());
+        log_info("build: usage log records=" + std::to_string(usageLog.records.size()));
+    }
+
+    for (auto& profile : profiles)
+    {
+        if (profile.keywordsPath.empty())
+            continue;
+
+        log_info("build: loading engine keywords: " + profile.keywordsPath +
+                 (profile.name.empty() ? "" : " (profile " + profile.name + ")"));
+        auto kwr = load_engine_keywords_vkw(profile.keywordsPath);
+        if (!kwr.isOk())
+        {
+            log_error("build: failed to parse keywords file: " + kwr.error().message);
+            return 3;
+        }
+        profile.keywords    = std::move(kwr.value());
+        profile.hasKeywords = true;
+
+        if (!read_binary_file(profile.keywordsPath, profile.keywordsBytes))
+        {
+            log_error("build: failed to read keywords bytes: " + profile.keywordsPath);
+            return 3;
+        }
+    }
+
+    // Merged libraries carry each profile's keywords in PROF instead of the single keywords block.
+    std::vector<ShaderLibraryProfile> libraryProfiles;
+    if (mergeProfiles)
+    {
+        for (const auto& profile : profiles)
+            libraryProfiles.push_back({profile.name, profile.keywordsBytes});
+    }
+
+    const std::vector<uint8_t>* keywordsBytes =
+        (namedProfiles || profiles[0].keywordsBytes.empty()) ? nullptr : &profiles[0].keywordsBytes;
+    const std::vector<ShaderLibraryProfile>* libraryProfilesPtr = mergeProfiles ? &libraryProfiles : nullptr;
+
+    BindingTable bindingTable;
+    bool         hasBindingTable = false;
+
+    if (!bindingTablePath.empty())
+    {
+        log_info("build: loading binding table: " + bindingTablePath);
+        auto btr = load_binding_table(bindingTablePath);
+        if (!btr.isOk())
+        {
+            log_error("build: failed to load binding table: " + btr.error().message);
+            return 3;
+        }
+        bindingTable    = std::move(btr.value());
+        hasBindingTable = true;
+    }
+
+    // Resolve shader list.
+    std::vector<std::filesystem::path> shaderFiles;
+    resolve_shader_files(shaderRootPath, shaders, shaderFiles);
+
+    if (shaderFiles.empty())
+    {
+        log_error("build: no shaders found under: " + shaderRootPath.generic_string());
+        return 4;
+    }
+
+    log_info("build: shaders=" + std::to_string(shaderFiles.size()));
+
+    const auto projectRootPath = resolve_project_root(projectRoot);
+
+    // Include graph + timings from the previous build; refreshed below and consumed by `vshaderc deps`.
+    DependencyGraph graph;
+    if (enableCache)
+    {
+        auto gr = DependencyGraph::load(dependency_graph_path(cacheDir));
+        if (gr.isOk())
+            graph = std::move(gr.value());
+    }
+
+    FileHashCache fileHashCache;
+
+    // Build records are kept in the cache, and skipped with link modules, whose own includes they do not
+    // track. Settings that change every shader's results are folded into each shader's inputs hash.
+    bool     useRecords = enableCache && linkModules.empty();
+    uint64_t configHash = xxhash64(projectRootPath.generic_string(), kBuildRecordVersion);
+    for (const auto& dir : includeDirs)
+        configHash = xxhash64(dir, configHash);
+    for (const auto& profile : profiles)
+        configHash = xxhash64(profile.keywordsBytes.data(), profile.keywordsBytes.size(), configHash);
+    configHash = xxhash64(workgroupSizesArg, configHash);
+    if (hasBindingTable)
+    {
+        uint64_t tableHash = 0;
+        if (!fileHashCache.hash(bindingTablePath, tableHash))
+            useRecords = false;
+        configHash = xxhash64(&tableHash, sizeof(tableHash), configHash);
+    }
+    size_t reusedShaders = 0;
+
+    // Link modules are compiled once for the whole build. The report compares fresh linked compiles
+    // against the first variant of each shader rebuilt with the modules included as source.
+    LinkModuleCache linkModuleCache;
+    size_t          linkedCompiles = 0;
+    double          linkedMs       = 0.0;
+    double          linkedLinkMs   = 0.0;
+    size_t          sourceCompiles = 0;
+    double          sourceMs       = 0.0;
+
+    std::vector<ShaderLibraryEntry> entries;
+    entries.reserve(1024);
+
+    // keyHash/stage signature -> index in entries; a variant several profiles share is compiled once.
+    std::unordered_map<uint64_t, size_t> seen;
+    seen.reserve(4096);
+
+    size_t      pruned     = 0;
+    size_t      stripped   = 0;
+    size_t      shared     = 0; // variants another profile had already produced
+    std::string firstError = {};
+
+    std::unordered_set<uint64_t> seenLayouts;
+    MaterialLayoutSummary        layoutSummary;
+
+    // Every shader is planned before compiling, so progressive builds can order variants across shaders.
+    struct ShaderPlan
+    {
+        std::string                      virtualPath;
+        ShaderStage                      stage {};
+        std::shared_ptr<std::string>     src; // shared by every variant request
+        std::vector<std::vector<Define>> variants;     // union over all profiles
+        std::vector<uint64_t>            profileMasks; // [variant] profiles enumerating it
+        DependencyGraphNode              node;
+        size_t                           freshCompiles  = 0;
+        double                           freshCompileMs = 0.0;
+        MaterialGlslState                materialGlsl;
+
+        // Build records: unchanged shaders take their results from the record instead of compiling
+        // (loaded when their first variant is submitted); the others record theirs as they are consumed.
+        uint64_t                                        variantsHash = 0;
+        bool                                            reuse        = false;
+        std::vector<std::optional<Result<BuildResult>>> reused;
+        ShaderInputs                                    inputs;
+        std::vector<uint8_t>                            record;
+        uint32_t                                        recordedVariants = 0;
+    };
+
+    struct BuildJob
+    {
+        uint32_t shader   = 0;
+        uint32_t variant  = 0;
+        uint32_t tier     = 0; // progressive: 0 = default variant, 1 = seen in the usage log, 2 = the rest
+        uint64_t usage    = 0;
+        uint32_t distance = 0; // variant_default_distance()
+    };
+
+    std::vector<ShaderPlan> plans;
+    std::vector<BuildJob>   jobs;
+    plans.reserve(shaderFiles.size());
+
+    size_t shaderIndex = 0;
+
+    for (const auto& shaderPathAbs : shaderFiles)
+    {
+        ++shaderIndex;
+
+        std::error_code ec;
+        auto            rel = std::filesystem::relative(shaderPathAbs, shaderRootPath, ec);
+        if (ec)
+            rel = shaderPathAbs.filename();
+
+        ShaderPlan plan;
+        plan.virtualPath = normalize_path_slashes(rel.generic_string());
+
+        const std::string& virtualPath = plan.virtualPath;
+
+        if (!infer_stage_from_shader_path(shaderPathAbs, plan.stage))
+        {
+            firstError = "build: failed to infer stage from file name: " + shaderPathAbs.generic_string();
+            break;
+        }
+
+        log_info("build: [" + std::to_string(shaderIndex) + "/" + std::to_string(shaderFiles.size()) + "] " +
+                 virtualPath);
+
+        plan.src = std::make_shared<std::string>();
+        if (!read_text_file(shaderPathAbs.generic_string(), *plan.src))
+        {
+            firstError = "build: failed to read shader: " + shaderPathAbs.generic_string();
+            break;
+        }
+
+        auto mdr = parse_vultra_metadata(*plan.src);
+        if (!mdr.isOk())
+        {
+            firstError = "build: failed to parse metadata: " + virtualPath + ": " + mdr.error().message;
+            break;
+        }
+
+        ParsedMetadata md = std::move(mdr.value());
+
+        const std::string shaderId = shader_id_from_virtual_path(virtualPath);
+
+        // Union of the profiles' variants; define sets are enumerated in declaration order, so equal
+        // variants have equal define lists.
+        std::unordered_map<std::string, size_t> variantIndices;
+        size_t                                  shaderStripped = 0;
+        for (size_t pi = 0; pi < profiles.size() && firstError.empty(); ++pi)
+        {
+            const auto& profile = profiles[pi];
+
+            auto enr = enumerate_shader_variants(
+                md, profile.hasKeywords ? &profile.keywords : nullptr, skipInvalid, shaderId, plan.stage, stripper);
+            if (!enr.isOk())
+            {
+                firstError = "build: " + virtualPath + (profile.name.empty() ? "" : " (profile " + profile.name + ")") +
+                             ": " + enr.error().message;
+                break;
+            }
+            pruned += enr.value().pruned;
+            shaderStripped += enr.value().stripped;
+
+            for (auto& defines : enr.value().variants)
+            {
+                std::string key;
+                for (const auto& d : defines)
+                    key += d.name + "=" + d.value + ";";
+
+                auto [it, inserted] = variantIndices.emplace(std::move(key), plan.variants.size());
+                if (inserted)
+                {
+                    plan.variants.push_back(std::move(defines));
+                    plan.profileMasks.push_back(0);
+                }
+                plan.profileMasks[it->second] |= uint64_t(1) << pi;
+            }
+        }
+        if (!firstError.empty())
+            break;
+
+        stripped += shaderStripped;
+
+        log_info("build: variants=" + std::to_string(plan.variants.size()) +
+                 (profiles.size() > 1 ? " across " + std::to_string(profiles.size()) + " profiles" : "") +
+                 (stripper ? " stripped=" + std::to_string(shaderStripped) : ""));
+
+        plan.node.virtualPath = virtualPath;
+        plan.node.path        = make_portable_path(shaderPathAbs.generic_string(), projectRootPath);
+        plan.variantsHash     = variant_list_hash(plan.stage, plan.variants, plan.profileMasks);
+
+        // Unchanged since the last build when the includes deps.graph recorded still hash to its inputs.
+        const auto* prev = useRecords ? graph.findShader(virtualPath) : nullptr;
+        if (prev && prev->inputsHash != 0)
+        {
+            ShaderInputs includes;
+            bool         readable = true;
+            for (const auto& inc : prev->includes)
+            {
+                std::filesystem::path incPath(inc);
+                if (incPath.is_relative())
+                    incPath = projectRootPath / incPath;
+
+                uint64_t h = 0;
+                readable   = fileHashCache.hash(incPath, h);
+                if (!readable)
+                    break;
+                includes.emplace_back(inc, h);
+            }
+
+            if (readable &&
+                shader_inputs_hash(configHash, *plan.src, plan.variantsHash, std::move(includes)) == prev->inputsHash)
+            {
+                plan.reuse           = true;
+                plan.node.includes   = prev->includes;
+                plan.node.inputsHash = prev->inputsHash;
+                log_verbose("build: unchanged since the last build: " + virtualPath);
+            }
+        }
+
+        for (size_t vi = 0; vi < plan.variants.size(); ++vi)
+        {
+            BuildJob job;
+            job.shader  = static_cast<uint32_t>(plans.size());
+            job.variant = static_cast<uint32_t>(vi);
+            if (progressive)
+            {
+                const auto& profile = profiles[std::countr_zero(plan.profileMasks[vi])];
+                job.distance =
+                    variant_default_distance(md, profile.hasKeywords ? &profile.keywords : nullptr, plan.variants[vi]);
+                job.usage    = usageLog.weight(shaderId, plan.variants[vi]);
+                job.tier     = job.distance == 0 ? 0u : (job.usage > 0 ? 1u : 2u);
+            }
+            jobs.push_back(job);
+        }
+
+        plans.push_back(std::move(plan));
+    }
+
+    if (progressive)
+    {
+        // Default variants first, so every shader has a fallback in the first snapshot; then used
+        // variants by usage count; then the rest, closest to the defaults first.
+        std::stable_sort(jobs.begin(), jobs.end(), [](const BuildJob& a, const BuildJob& b) {
+            if (a.tier != b.tier)
+                return a.tier < b.tier;
+            if (a.usage != b.usage)
+                return a.usage > b.usage;
+            return a.distance < b.distance;
+        });
+    }
+
+    // Any member profile resolves the same keyword values: engine-set globals are pinned in the defines.
+    auto jobProfile = [&](const BuildJob& job) {
+        return static_cast<uint32_t>(std::countr_zero(plans[job.shader].profileMasks[job.variant]));
+    };
+
+    // Include dirs, keywords and the binding table are shared by every variant request instead of
+    // copied into each.
+    const auto sharedIncludeDirs  = std::make_shared<const std::vector<std::string>>(includeDirs);
+    const auto sharedBindingTable = hasBindingTable ? std::make_shared<const BindingTable>(bindingTable) : nullptr;
+
+    std::vector<std::shared_ptr<const EngineKeywordsFile>> profileKeywords;
+    profileKeywords.reserve(profiles.size());
+    for (const auto& profile : profiles)
+        profileKeywords.push_back(profile.hasKeywords ? std::make_shared<const EngineKeywordsFile>(profile.keywords) :
+                                                        nullptr);
+
+    auto makeRequest = [&](const BuildJob& job) {
+        const auto& plan = plans[job.shader];
+
+        BuildRequest req;
+        req.source.virtualPath        = plan.virtualPath;
+        req.source.sharedSourceText   = plan.src;
+        req.options.stage             = plan.stage;
+        req.options.sharedIncludeDirs = sharedIncludeDirs;
+        req.options.defines           = plan.variants[job.variant];
+        req.sharedEngineKeywords      = profileKeywords[jobProfile(job)];
+        req.sharedBindingTable        = sharedBindingTable;
+
+        if (plan.stage == ShaderStage::eComp)
+            req.workgroupSizes = workgroupSizes;
+
+        req.enableCache     = enableCache;
+        req.cacheDir        = cacheDir;
+        req.projectRoot     = projectRoot;
+        req.fileHashCache   = &fileHashCache;
+        req.linkModules     = linkModules;
+        req.linkModuleCache = &linkModuleCache;
+        return req;
+    };
+
+    // Compiles run on the executor, or in `vshaderc worker` subprocesses with --workers, and their
+    // results are consumed in job order, so everything after the compile stays sequential and
+    // deterministic. Submission does not wait for that order: two jobs per compile slot stay in flight
+    // however far the consumer lags behind one slow variant, and finished results queue up until they
+    // hold kBuildBufferBytes. A worker crash fails only the variant it was compiling.
+    constexpr size_t kBuildBufferBytes = size_t(256) * 1024 * 1024;
+
+    struct PooledBuild
+    {
+        std::optional<Result<BuildResult>> result;
+        bool                               workerDied = false;
+        size_t                             bytes      = 0; // counted in bufferedBytes until consumed
+    };
+
+    std::vector<PooledBuild> pooled(jobs.size());
+    std::mutex               pooledMutex;
+    std::condition_variable  pooledReady;
+    size_t                   submitted     = 0;
+    size_t                   inFlight      = 0;
+    size_t                   completed     = 0;
+    size_t                   bufferedBytes = 0;
+    size_t                   deadWorkers   = 0;
+
+    auto finishBuild = [&](size_t k, PooledBuild pb) {
+        pb.bytes = build_result_bytes(*pb.result);
+        {
+            std::lock_guard<std::mutex> lock(pooledMutex);
+            pooled[k] = std::move(pb);
+            bufferedBytes += pooled[k].bytes;
+            --inFlight;
+            ++completed;
+        }
+        pooledReady.notify_all();
+    };
+
+    // --validate: each unique module is validated at low priority on the build's executor, behind the
+    // compiles, and modules validated by earlier builds are skipped through the cache.
+    std::unique_ptr<SpirvValidationCache> validation;
+    std::vector<std::string>              validationErrors;
+    std::mutex                            validationMutex;
+    std::unordered_set<uint64_t>          validationSubmitted;
+
+    if (validate)
+        validation = std::make_unique<SpirvValidationCache>(enableCache ? cacheDir : std::string());
+
+    // Declared after the state their tasks and callbacks touch, so they drain before it goes away.
+    std::unique_ptr<ProcessPool> workerPool;
+    std::unique_ptr<ThreadPool>  executor;
+    std::unique_ptr<TaskGroup>   compileTasks;
+    std::unique_ptr<TaskGroup>   validationTasks;
+
+    if (useWorkers)
+    {
+        ProcessPoolOptions po;
+        po.command           = {argv[0], "worker", "--project-root", projectRoot};
+        po.processCount      = workerCount;
+        po.maxJobsPerProcess = workerJobs;
+        po.maxResidentBytes  = workerMaxMb * 1024 * 1024;
+
+        for (const auto& dir : includeDirs)
+            po.command.insert(po.command.end(), {"-I", dir});
+        for (const auto& profile : profiles)
+            po.command.insert(po.command.end(),
+                              {"--profile-keywords", profile.keywordsPath.empty() ? "-" : profile.keywordsPath});
+        if (hasBindingTable)
+            po.command.insert(po.command.end(), {"--binding-table", bindingTablePath});
+        if (!workgroupSizesArg.empty())
+            po.command.insert(po.command.end(), {"--workgroup-sizes", workgroupSizesArg});
+        if (enableCache)
+            po.command.insert(po.command.end(), {"--cache", cacheDir});
+        else
+            po.command.push_back("--no-cache");
+        for (const auto& module : linkModules)
+            po.command.insert(po.command.end(), {"--link-module", module});
+
+        workerPool = std::make_unique<ProcessPool>(std::move(po));
+        log_info("build: worker processes=" + std::to_string(workerPool->processCount()));
+    }
+
+    // One executor for in-process compiles and validation; with --workers it only validates, on the
+    // threads the worker processes leave free.
+    if (!workerPool || validation)
+    {
+        uint32_t executorThreads = threadCount;
+        if (executorThreads == 0 && workerPool)
+        {
+            const uint32_t hw = std::max(1u, std::thread::hardware_concurrency());
+            executorThreads   = hw > workerPool->processCount() ? hw - workerPool->processCount() : 1u;
+        }
+        executor = std::make_unique<ThreadPool>(executorThreads);
+        if (!workerPool)
+            compileTasks = std::make_unique<TaskGroup>(*executor, TaskPriority::eNormal);
+        if (validation)
+            validationTasks = std::make_unique<TaskGroup>(*executor, TaskPriority::eLow);
+        log_info("build: threads=" + std::to_string(executor->concurrency()));
+    }
+
+    auto submitBuild = [&](size_t k) {
+        auto& buildPlan = plans[jobs[k].shader];
+        if (buildPlan.reuse && buildPlan.reused.empty())
+        {
+            buildPlan.reused = read_build_record(build_record_path(cacheDir, buildPlan.virtualPath),
+                                                 buildPlan.node.inputsHash,
+                                                 buildPlan.variants.size());
+            if (buildPlan.reused.empty())
+            {
+                log_verbose("build: no usable build record for " + buildPlan.virtualPath + ", compiling it");
+                buildPlan.reuse = false;
+            }
+            else
+            {
+                ++reusedShaders;
+            }
+        }
+        if (buildPlan.reuse)
+        {
+            auto&       slot = buildPlan.reused[jobs[k].variant];
+            PooledBuild pb;
+            pb.result.emplace(std::move(*slot));
+            slot.reset();
+            finishBuild(k, std::move(pb));
+            return;
+        }
+
+        if (!workerPool)
+        {
+            compileTasks->run([&, k]() {
+                PooledBuild pb;
+                pb.result.emplace(build_shader(makeRequest(jobs[k])));
+                finishBuild(k, std::move(pb));
+            });
+            return;
+        }
+
+        const auto& job  = jobs[k];
+        const auto& plan = plans[job.shader];
+
+        auto msg =
+            encode_build_job(plan.virtualPath, *plan.src, plan.stage, plan.variants[job.variant], jobProfile(job));
+        workerPool->submit(std::move(msg), [&, k](Result<std::vector<uint8_t>> reply) {
+            PooledBuild pb;
+            pb.workerDied = !reply.isOk();
+            pb.result.emplace(pb.workerDied ? Result<BuildResult>::err(reply.error()) :
+                                              decode_build_reply(reply.value()));
+            finishBuild(k, std::move(pb));
+        });
+    };
+
+    // Tops up the compile slots while the consumer waits for job `next`. Jobs go out in order, so every
+    // buffered result is ahead of `next` and a full buffer never holds back `next` itself.
+    const size_t compileSlots = workerPool ? workerPool->processCount() : executor->concurrency();
+
+    auto submitAhead = [&](size_t next) {
+        for (;;)
+        {
+            size_t k = 0;
+            {
+                std::lock_guard<std::mutex> lock(pooledMutex);
+                if (submitted == jobs.size() || inFlight >= 2 * compileSlots ||
+                    (submitted > next && bufferedBytes >= kBuildBufferBytes))
+                    return;
+                k = submitted++;
+                ++inFlight;
+            }
+            submitBuild(k);
+        }
+    };
+
+    auto validateAsync = [&](const ShaderBinary& b, const std::string& what) {
+        if (!validation || !validationSubmitted.insert(b.spirvHash).second)
+            return;
+
+        auto spirv = std::make_shared<const std::vector<uint32_t>>(b.spirv);
+        validation->validateAsync(spirv, b.spirvHash, *validationTasks, [&, what](const Result<void>& vr) {
+            if (vr.isOk())
+                return;
+
+            std::lock_guard<std::mutex> lock(validationMutex);
+            validationErrors.push_back(what + ": " + vr.error().message);
+        });
+    };
+
+    auto lastSnapshot = std::chrono::steady_clock::now();
+
+    for (size_t ji = 0; ji < jobs.size() && firstError.empty(); ++ji)
+    {
+        const BuildJob& job  = jobs[ji];
+        auto&           plan = plans[job.shader];
+
+        if (progressive && ji > 0)
+        {
+            const auto now = std::chrono::steady_clock::now();
+            if (jobs[ji - 1].tier != job.tier || now - lastSnapshot >= std::chrono::seconds(snapshotInterval))
+            {
+                log_info("build: snapshot " + std::to_string(ji) + "/" + std::to_string(jobs.size()) +
+                         " variants, entries=" + std::to_string(entries.size()) + " -> " + outLibPath);
+                if (!publish_library_snapshot(outLibPath, entries, keywordsBytes, libraryProfilesPtr))
+                    log_error("build: failed to write snapshot " + outLibPath);
+                lastSnapshot = now;
+            }
+        }
+
+        const std::string& virtualPath  = plan.virtualPath;
+        const size_t       variantIndex = job.variant + 1;
+        const size_t       variantCount = plan.variants.size();
+        const uint64_t     profileMask  = plan.profileMasks[job.variant];
+
+        log_verbose("build: compiling " + virtualPath + " variant " + std::to_string(variantIndex) + "/" +
+                    std::to_string(variantCount));
+
+        // Every completion wakes the consumer to refill the slot it freed, not only job ji's.
+        for (;;)
+        {
+            submitAhead(ji);
+
+            std::unique_lock<std::mutex> lock(pooledMutex);
+            const size_t                 seen = completed;
+            pooledReady.wait(lock, [&]() { return pooled[ji].result.has_value() || completed != seen; });
+            if (pooled[ji].result)
+                break;
+        }
+
+        std::optional<Result<BuildResult>> built;
+        {
+            std::lock_guard<std::mutex> lock(pooledMutex);
+            bufferedBytes -= pooled[ji].bytes;
+            built = std::move(pooled[ji].result);
+            pooled[ji].result.reset();
+        }
+
+        if (pooled[ji].workerDied)
+        {
+            ++deadWorkers;
+            log_error("build: worker died compiling " + virtualPath + " variant " + std::to_string(variantIndex) +
+                      "/" + std::to_string(variantCount) + ", skipping it: " + built->error().message);
+            continue;
+        }
+
+        auto br = std::move(*built);
+        if (!br.isOk())
+        {
+            firstError = "build: build failed for " + virtualPath + ": " + br.error().message;
+            break;
+        }
+
+        if (linkReport)
+        {
+            if (!br.value().fromCache)
+            {
+                ++linkedCompiles;
+                linkedMs += br.value().compileMs - br.value().linkMs;
+                linkedLinkMs += br.value().linkMs;
+            }
+
+            if (variantIndex == 1)
+            {
+                BuildRequest sourceReq    = makeRequest(job);
+                sourceReq.linkModules     = {};
+                sourceReq.linkModuleCache = nullptr;
+                sourceReq.enableCache     = false;
+
+                auto sr = build_shader(sourceReq);
+                if (sr.isOk())
+                {
+                    ++sourceCompiles;
+                    sourceMs += sr.value().compileMs;
+                }
+                else
+                {
+                    log_verbose("build: link report: source build failed for " + virtualPath + ": " +
+                                sr.error().message);
+                }
+            }
+        }
+
+        auto& bin = br.value().binary;
+
+        for (const auto& dep : bin.dependencies)
+        {
+            plan.node.includes.push_back(dep.path);
+            plan.inputs.emplace_back(dep.path, dep.contentHash);
+        }
+        ++plan.node.variantCount;
+        if (!br.value().fromCache)
+        {
+            ++plan.freshCompiles;
+            plan.freshCompileMs += br.value().compileMs;
+        }
+
+        // Dependencies are only needed to validate cache entries; keep them out of the library.
+        bin.dependencies.clear();
+
+        if (useRecords && !plan.reuse)
+        {
+            const auto reply = encode_build_reply(br);
+            put_u32(plan.record, job.variant);
+            put_bytes(plan.record, reply.data(), reply.size());
+
+            if (++plan.recordedVariants == variantCount)
+            {
+                plan.node.inputsHash =
+                    shader_inputs_hash(configHash, *plan.src, plan.variantsHash, std::move(plan.inputs));
+                if (plan.node.inputsHash != 0 &&
+                    !write_build_record(build_record_path(cacheDir, virtualPath),
+                                        plan.node.inputsHash,
+                                        static_cast<uint32_t>(variantCount),
+                                        plan.record))
+                {
+                    log_verbose("build: failed to write build record for " + virtualPath);
+                    plan.node.inputsHash = 0;
+                }
+                plan.record = {};
+            }
+        }
+
+        validateAsync(bin,
+                      virtualPath + " variant " + std::to_string(variantIndex) + "/" + std::to_string(variantCount));
+
+        report_material_layout(virtualPath, bin.materialDesc, seenLayouts, layoutSummary);
+
+        if (!write_material_pool_include(materialGlslDir, virtualPath, bin.materialDesc, plan.materialGlsl))
+        {
+            firstError = "build: failed to write material GLSL for " + virtualPath + " to " + materialGlslDir;
+            break;
+        }
+
+        ShaderLibraryEntry e;
+        e.keyHash     = (bin.variantHash != 0) ? bin.variantHash : bin.contentHash;
+        e.stage       = bin.stage;
+        e.profileMask = profileMask;
+
+        const uint64_t sig =
+            xxhash64(&e.keyHash, sizeof(e.keyHash), static_cast<uint64_t>(static_cast<uint8_t>(e.stage)));
+
+        log_info("build: building " + virtualPath + " variant " + std::to_string(variantIndex) + "/" +
+                 std::to_string(variantCount) + " shaderIdHash=" + std::to_string(bin.shaderIdHash) +
+                 " contentHash=" + std::to_string(bin.contentHash) + " variantHash=" +
+                 std::to_string(bin.variantHash) + " stage=" + std::to_string(static_cast<int>(bin.stage)));
+
+        auto bytes = write_vshbin(bin);
+        if (!bytes.isOk())
+        {
+            firstError = "build: failed to serialize vshbin for " + virtualPath + ": " + bytes.error().message;
+            break;
+        }
+        e.blob = std::move(bytes.value());
+
+        if (auto it = seen.find(sig); it != seen.end())
+        {
+            // Skip duplicates: this can happen when different shader files/variants produce the same content hash.
+            // Only a repeat within a profile is pruned; a hit from another profile just adds that profile.
+            auto& existing = entries[it->second];
+            if ((existing.profileMask & profileMask) == profileMask)
+                ++pruned;
+            else
+                ++shared;
+            existing.profileMask |= profileMask;
+            log_verbose("build: skipping duplicate entry for " + virtualPath + " variant " +
+                        std::to_string(variantIndex) + "/" + std::to_string(variantCount) + " keyHash=" +
+                        std::to_string(e.keyHash) + " stage=" + std::to_string(static_cast<int>(e.stage)));
+            continue;
+        }
+
+        seen.emplace(sig, entries.size());
+        entries.push_back(std::move(e));
+
+        for (const auto& sv : br.value().sizeVariants)
+        {
+            validateAsync(sv, virtualPath + " variant " + std::to_string(variantIndex) + " size variant");
+
+            ShaderLibraryEntry se;
+            se.keyHash     = sv.variantHash;
+            se.stage       = sv.stage;
+            se.profileMask = profileMask;
+
+            log_verbose("build:   workgroup size " +
+                        format_workgroup_size({sv.reflection.localSizeX,
+                                               sv.reflection.localSizeY,
+                                               sv.reflection.localSizeZ}) +
+                        " keyHash=" + std::to_string(se.keyHash));
+
+            auto svBytes = write_vshbin(sv);
+            if (!svBytes.isOk())
+            {
+                firstError = "build: failed to serialize vshbin for " + virtualPath + ": " + svBytes.error().message;
+                break;
+            }
+            se.blob = std::move(svBytes.value());
+
+            const uint64_t svSig =
+                xxhash64(&se.keyHash, sizeof(se.keyHash), static_cast<uint64_t>(static_cast<uint8_t>(se.stage)));
+            if (auto [it, inserted] = seen.emplace(svSig, entries.size()); !inserted)
+            {
+                auto& existing = entries[it->second];
+                if ((existing.profileMask & profileMask) != profileMask)
+                    ++shared;
+                existing.profileMask |= profileMask;
+                continue;
+            }
+            entries.push_back(std::move(se));
+        }
+    }
+
+    if (reusedShaders > 0)
+        log_info("build: reused " + std::to_string(reusedShaders) + " unchanged shader(s) from build records");
+
+    if (validationTasks)
+    {
+        validationTasks->wait();
+        log_info("build: validated " + std::to_string(validation->validatedCount()) + " SPIR-V modules in " +
+                 std::to_string(validation->totalValidateMs()) + " ms, " + std::to_string(validation->cachedCount()) +
+                 " already validated");
+
+        std::sort(validationErrors.begin(), validationErrors.end());
+        for (const auto& e : validationErrors)
+            log_error("build: " + e);
+        if (!validationErrors.empty() && firstError.empty())
+            firstError = "build: " + std::to_string(validationErrors.size()) + " SPIR-V module(s) failed validation";
+    }
+
+    if (firstError.empty())
+    {
+        for (auto& plan : plans)
+        {
+            // Keep the last measured timing when every variant came from cache.
+            if (plan.freshCompiles > 0)
+                plan.node.avgCompileMs = plan.freshCompileMs / static_cast<double>(plan.freshCompiles);
+            else if (const auto* prev = graph.findShader(plan.virtualPath))
+                plan.node.avgCompileMs = prev->avgCompileMs;
+
+            graph.setShader(std::move(plan.node));
+        }
+    }
+
+    if (!firstError.empty())
+    {
+        log_error(firstError);
+        return 5;
+    }
+
+    // The libraries are still written without the variants whose worker died; the exit code reports them.
+    const int exitCode = deadWorkers > 0 ? 5 : 0;
+    if (workerPool)
+    {
+        log_info("build: worker restarts: recycled=" + std::to_string(workerPool->recycledCount()) +
+                 " died=" + std::to_string(workerPool->crashedCount()));
+        if (deadWorkers > 0)
+            log_error("build: " + std::to_string(deadWorkers) + " variant(s) skipped after their worker process died");
+    }
+
+    if (enableCache)
+    {
+        std::error_code ec;
+        std::filesystem::create_directories(cacheDir, ec);
+
+        graph.setProjectRoot(projectRootPath.generic_string());
+        auto gw = graph.save(dependency_graph_path(cacheDir));
+        if (!gw.isOk())
+            log_error("build: " + gw.error().message);
+    }
+
+    // Deterministic ordering for stable builds
+    std::sort(entries.begin(), entries.end(), [](const ShaderLibraryEntry& a, const ShaderLibraryEntry& b) {
+        if (a.keyHash != b.keyHash)
+            return a.keyHash < b.keyHash;
+        return static_cast<uint8_t>(a.stage) < static_cast<uint8_t>(b.stage);
+    });
+
+    // Ensure output directory exists
+    auto outDir = std::filesystem::path(outLibPath).parent_path();
+    if (!outDir.empty())
+    {
+        std::error_code ec;
+        std::filesystem::create_directories(outDir, ec);
+        if (ec)
+        {
+            log_error("build: failed to create output directory: " + outDir.generic_string() + ": " + ec.message());
+            return 6;
+        }
+    }
+
+    if (layoutSummary.blocks > 0)
+    {
+        const auto& ls = layoutSummary;
+        log_info("build: material blocks=" + std::to_string(ls.blocks) + " bytes=" + std::to_string(ls.declaredBytes) +
+                 " padding=" + std::to_string(ls.paddingBytes) +
+                 " reorder_saves=" + std::to_string(ls.declaredBytes - std::min(ls.declaredBytes, ls.optimizedBytes)) +
+                 " scalar_saves=" + std::to_string(ls.declaredBytes - std::min(ls.declaredBytes, ls.scalarBytes)));
+    }
+
+    if (linkReport)
+    {
+        auto avg = [](double ms, size_t n) { return n ? std::to_string(ms / static_cast<double>(n)) : "n/a"; };
+
+        log_info("build: link modules=" + std::to_string(linkModuleCache.compiledCount()) + " compiled once in " +
+                 std::to_string(linkModuleCache.totalCompileMs()) + " ms; linked variants=" +
+                 std::to_string(linkedCompiles) + " avg compile " + avg(linkedMs, linkedCompiles) + " ms + link " +
+                 avg(linkedLinkMs, linkedCompiles) + " ms; source inclusion avg " + avg(sourceMs, sourceCompiles) +
+                 " ms over " + std::to_string(sourceCompiles) + " samples");
+    }
+
+    if (split)
+    {
+        std::vector<ShaderLibraryEntryView> views;
+        views.reserve(entries.size());
+        for (const auto& e : entries)
+            views.push_back({e.keyHash, e.stage, e.blob, e.profileMask});
+
+        const auto        outPath = std::filesystem::path(outLibPath);
+        const std::string outDir  = outPath.has_parent_path() ? outPath.parent_path().string() : ".";
+
+        log_info("build: partitioning " + std::to_string(entries.size()) + " entries, pruned=" +
+                 std::to_string(pruned) + (stripper ? " stripped=" + std::to_string(stripped) : ""));
+        if (!write_partitioned_library("build",
+                                       views,
+                                       splitPlan,
+                                       outDir,
+                                       outPath.stem().string(),
+                                       keywordsBytes,
+                                       libraryProfilesPtr))
+            return 7;
+        return exitCode;
+    }
+
+    if (namedProfiles && !mergeProfiles)
+    {
+        // One library per profile, each holding only the variants its keywords enumerate.
+        const auto outPath = std::filesystem::path(outLibPath);
+
+        for (size_t pi = 0; pi < profiles.size(); ++pi)
+        {
+            const auto& profile = profiles[pi];
+
+            std::vector<ShaderLibraryEntryView> views;
+            for (const auto& e : entries)
+            {
+                if ((e.profileMask >> pi) & 1u)
+                    views.push_back({e.keyHash, e.stage, e.blob});
+            }
+
+            const std::string path =
+                (outPath.parent_path() / (outPath.stem().string() + "." + profile.name + ".vshlib")).string();
+            log_info("build: writing vshlib: " + path + " profile=" + profile.name +
+                     " entries=" + std::to_string(views.size()));
+
+            auto w = write_vslib(path,
+                                 std::span<const ShaderLibraryEntryView>(views),
+                                 profile.keywordsBytes.empty() ? nullptr : &profile.keywordsBytes);
+            if (!w.isOk())
+            {
+                log_error("build: write vshlib failed: " + w.error().message);
+                return 7;
+            }
+        }
+
+        log_info("build: OK -> " + std::to_string(profiles.size()) + " profile libraries, compiled entries=" +
+                 std::to_string(entries.size()) + " pruned=" + std::to_string(pruned) +
+                 " shared=" + std::to_string(shared) + (stripper ? " stripped=" + std::to_string(stripped) : ""));
+        return exitCode;
+    }
+
+    log_info("build: writing vshlib: " + outLibPath + " entries=" + std::to_string(entries.size()) +
+             " pruned=" + std::to_string(pruned) + (stripper ? " stripped=" + std::to_string(stripped) : "") +
+             (mergeProfiles ? " profiles=" + std::to_string(profiles.size()) + " shared=" + std::to_string(shared)
+                            : ""));
+
+    if (progressive)
+    {
+        // Readers may hold earlier snapshots open; replace the file the same way.
+        if (!publish_library_snapshot(outLibPath, entries, keywordsBytes, libraryProfilesPtr))
+        {
+            log_error("build: write vshlib failed: " + outLibPath);
+            return 7;
+        }
+
+        log_info("build: OK -> " + outLibPath);
+        return exitCode;
+    }
+
+    auto w = write_vslib(outLibPath, entries, keywordsBytes, libraryProfilesPtr);
+    if (!w.isOk())
+    {
+        log_error("build: write vshlib failed: " + w.error().message);
+        return 7;
+    }
+
+    log_info("build: OK -> " + outLibPath);
+    return exitCode;
+}
+
+// ============================================================
+// deps
+// ============================================================
+
+static std::string format_ms(double ms)
+{
+    char buf[64];
+    if (ms >= 60000.0)
+        std::snprintf(buf, sizeof(buf), "%.1fmin", ms / 60000.0);
+    else if (ms >= 1000.0)
+        std::snprintf(buf, sizeof(buf), "%.1fs", ms / 1000.0);
+    else
+        std::snprintf(buf, sizeof(buf), "%.0fms", ms);
+    return buf;
+}
+
+static std::string format_impact(const DependencyImpact& im)
+{
+    std::string s = "shaders=" + std::to_string(im.shaders.size()) + " variants=" + std::to_string(im.variants) +
+                    " est=" + format_ms(im.estimatedMs);
+    if (im.untimedVariants > 0)
+        s += " (+" + std::to_string(im.untimedVariants) + " untimed variants)";
+    return s;
+}
+
+static int cmd_deps(int argc, char** argv)
+{
+    // vshaderc deps --shader_root <dir> [-I <dir> ...] [--keywords-file <vkw>] [--cache dir] [--project-root dir]
+    // [--changed <file> ...] [--no-scan] [--top N] [--verbose]
+    std::string              shaderRoot;
+    std::vector<std::string> includeDirs;
+    std::vector<std::string> changed;
+    std::string              keywordsPath;
+    std::string              cacheDir = ".vshader_cache";
+    std::string              projectRoot;
+    bool                     noScan  = false;
+    size_t                   top     = 20;
+    bool                     verbose = false;
+
+    for (int i = 2; i < argc; ++i)
+    {
+        std::string a = argv[i];
+
+        if (a == "--shader_root" && i + 1 < argc)
+        {
+            shaderRoot = normalize_path_slashes(argv[++i]);
+        }
+        else if (a == "-I" && i + 1 < argc)
+        {
+            includeDirs.push_back(normalize_path_slashes(argv[++i]));
+        }
+        else if (a == "--keywords-file" && i + 1 < argc)
+        {
+            keywordsPath = argv[++i];
+        }
+        else if (a == "--changed" && i + 1 < argc)
+        {
+            changed.push_back(normalize_path_slashes(argv[++i]));
+        }
+        else if (a == "--cache" && i + 1 < argc)
+        {
+            cacheDir = argv[++i];
+        }
+        else if (a == "--project-root" && i + 1 < argc)
+        {
+            projectRoot = normalize_path_slashes(argv[++i]);
+        }
+        else if (a == "--no-scan")
+        {
+            noScan = true;
+        }
+        else if (a == "--top" && i + 1 < argc)
+        {
+            top = static_cast<size_t>(std::strtoul(argv[++i], nullptr, 10));
+        }
+        else if (a == "--verbose")
+        {
+            verbose = true;
+        }
+        else if (a == "-h" || a == "--help")
+        {
+            print_usage();
+            return 0;
+        }
+        else
+        {
+            log_error("Unknown deps arg: " + a);
+            return 2;
+        }
+    }
+
+    g_verbose = verbose;
+
+    if (shaderRoot.empty() && !noScan)
+    {
+        log_error("deps: --shader_root <dir> is required (or use --no-scan to read the graph from the last build)");
+        return 2;
+    }
+
+    const std::string graphPath = dependency_graph_path(cacheDir);
+
+    // Timings come from previous builds; keep them even when rescanning.
+    DependencyGraph graph;
+    {
+        auto gr = DependencyGraph::load(graphPath);
+        if (gr.isOk())
+            graph = std::move(gr.value());
+        else if (noScan)
+        {
+            log_error("deps: " + gr.error().message);
+            return 3;
+        }
+    }
+
+    std::filesystem::path shaderRootPath;
+    if (!shaderRoot.empty())
+        shaderRootPath = std::filesystem::absolute(shaderRoot);
+
+    // Without --shader_root (--no-scan), the graph's paths are relative to the root the last build used,
+    // so --changed is resolved against that and not the current directory.
+    if (projectRoot.empty())
+        projectRoot = !shaderRootPath.empty() ? shaderRootPath.generic_string() : graph.projectRoot();
+
+    const auto projectRootPath = resolve_project_root(projectRoot);
+
+    if (!noScan)
+    {
+        add_implicit_include_dirs(shaderRootPath, includeDirs);
+
+        EngineKeywordsFile engineKw;
+        bool               hasEngineKw = false;
+        if (!keywordsPath.empty())
+        {
+            auto kwr = load_engine_keywords_vkw(keywordsPath);
+            if (!kwr.isOk())
+            {
+                log_error("deps: failed to parse keywords file: " + kwr.error().message);
+                return 3;
+            }
+            engineKw    = std::move(kwr.value());
+            hasEngineKw = true;
+        }
+
+        std::vector<std::filesystem::path> shaderFiles;
+        scan_shader_root(shaderRootPath, shaderFiles);
+
+        log_info("deps: scanning shaders=" + std::to_string(shaderFiles.size()));
+
+        for (const auto& shaderPathAbs : shaderFiles)
+        {
+            std::error_code ec;
+            auto            rel = std::filesystem::relative(shaderPathAbs, shaderRootPath, ec);
+            if (ec)
+                rel = shaderPathAbs.filename();
+
+            const std::string virtualPath = normalize_path_slashes(rel.generic_string());
+
+            ShaderStage stage {};
+            if (!infer_stage_from_shader_path(shaderPathAbs, stage))
+            {
+                log_error("deps: failed to infer stage from file name: " + shaderPathAbs.generic_string());
+                return 4;
+            }
+
+            auto src = std::make_shared<std::string>();
+            if (!read_text_file(shaderPathAbs.generic_string(), *src))
+            {
+                log_error("deps: failed to read shader: " + shaderPathAbs.generic_string());
+                return 4;
+            }
+
+            auto mdr = parse_vultra_metadata(*src);
+            if (!mdr.isOk())
+            {
+                log_error("deps: failed to parse metadata: " + virtualPath + ": " + mdr.error().message);
+                return 4;
+            }
+
+            auto enr = enumerate_shader_variants(mdr.value(), hasEngineKw ? &engineKw : nullptr, true);
+            if (!enr.isOk())
+            {
+                log_error("deps: " + virtualPath + ": " + enr.error().message);
+                return 4;
+            }
+
+            DependencyGraphNode node;
+            node.virtualPath  = virtualPath;
+            node.path         = make_portable_path(shaderPathAbs.generic_string(), projectRootPath);
+            node.variantCount = static_cast<uint32_t>(enr.value().variants.size());
+            if (const auto* prev = graph.findShader(virtualPath))
+            {
+                node.avgCompileMs = prev->avgCompileMs;
+                node.inputsHash   = prev->inputsHash; // build re-checks it against the rescanned includes
+            }
+
+            // Includes can differ per variant (#if around #include), so union over all variants.
+            for (const auto& defines : enr.value().variants)
+            {
+                SourceInput input;
+                input.virtualPath      = virtualPath;
+                input.sharedSourceText = src;
+
+                CompileOptions opt;
+                opt.stage       = stage;
+                opt.includeDirs = includeDirs;
+                opt.defines     = defines;
+
+                auto sr = scan_dependencies(input, opt);
+                if (!sr.isOk())
+                {
+                    log_error("deps: preprocess failed for " + virtualPath + ": " + sr.error().message);
+                    return 4;
+                }
+
+                for (const auto& dep : sr.value())
+                    node.includes.push_back(make_portable_path(dep, projectRootPath));
+            }
+
+            log_verbose("deps: " + virtualPath + " variants=" + std::to_string(node.variantCount));
+
+            graph.setShader(std::move(node));
+        }
+
+        std::error_code ec;
+        std::filesystem::create_directories(cacheDir, ec);
+
+        graph.setProjectRoot(projectRootPath.generic_string());
+        auto gw = graph.save(graphPath);
+        if (!gw.isOk())
+            log_error("deps: " + gw.error().message);
+    }
+
+    if (!changed.empty())
+    {
+        for (const auto& c : changed)
+        {
+            const std::string key = make_portable_path(std::filesystem::absolute(c).generic_string(), projectRootPath);
+            const auto        im  = graph.impactOf(key);
+
+            log_info("deps: " + key + " -> " + format_impact(im));
+            for (const auto* n : im.shaders)
+                log_info("deps:   " + n->virtualPath + " variants=" + std::to_string(n->variantCount));
+        }
+        return 0;
+    }
+
+    // No query: rank includes by how many variants they fan out into.
+    struct Row
+    {
+        std::string      path;
+        DependencyImpact impact;
+    };
+
+    std::vector<Row> rows;
+    for (const auto& inc : graph.includeFiles())
+        rows.push_back({inc, graph.impactOf(inc)});
+
+    std::sort(rows.begin(), rows.end(), [](const Row& a, const Row& b) {
+        if (a.impact.variants != b.impact.variants)
+            return a.impact.variants > b.impact.variants;
+        return a.path < b.path;
+    });
+
+    log_info("deps: shaders=" + std::to_string(graph.shaders().size()) +
+             " includes=" + std::to_string(rows.size()));
+
+    for (size_t i = 0; i < rows.size() && i < top; ++i)
+        log_info("deps:   " + rows[i].path + " -> " + format_impact(rows[i].impact));
+
+    return 0;
+}
+
+// ============================================================
+// analyze
+// ============================================================
+
+// Consolidation thresholds, as a share of the variant's static cost.
+static constexpr double kRuntimeCostPct = 2.0;  // below: a uniform branch is practically free
+static constexpr double kSpecialCostPct = 10.0; // below: a specialization constant is a good trade
+
+struct AnalyzeSample
+{
+    SpirvStats       stats;
+    ShaderReflection reflection;
+    double           compileMs = 0.0;
+};
+
+struct AnalyzeKeywordReport
+{
+    const KeywordDecl* decl       = nullptr;
+    size_t             valueCount = 0;
+    size_t             pairs      = 0;
+
+    double avgInstrDelta = 0.0;
+    double avgCostDelta  = 0.0;
+    double avgCostPct    = 0.0;
+    bool   interfaceDiff = false;
+
+    // Variants removed if this keyword stops being a permutation, and the build time that saves
+    // (0 = unknown: every sample was cached and no build has recorded timings).
+    size_t variantsSaved = 0;
+    double buildSavingMs = 0.0;
+
+    // variantsSaved / (1 + avgCostDelta): higher means cheaper to consolidate.
+    double ratio = 0.0;
+
+    std::string recommendation;
+};
+
+static bool same_interface(const AnalyzeSample& a, const AnalyzeSample& b)
+{
+    if (a.stats.inputVariableCount != b.stats.inputVariableCount ||
+        a.stats.outputVariableCount != b.stats.outputVariableCount)
+        return false;
+
+    const auto& da = a.reflection.descriptors;
+    const auto& db = b.reflection.descriptors;
+    if (da.size() != db.size())
+        return false;
+    for (size_t i = 0; i < da.size(); ++i)
+    {
+        if (da[i].name != db[i].name || da[i].set != db[i].set || da[i].binding != db[i].binding ||
+            da[i].kind != db[i].kind || da[i].count != db[i].count)
+            return false;
+    }
+
+    const auto& ba = a.reflection.blocks;
+    const auto& bb = b.reflection.blocks;
+    if (ba.size() != bb.size())
+        return false;
+    for (size_t i = 0; i < ba.size(); ++i)
+    {
+        if (ba[i].name != bb[i].name || ba[i].size != bb[i].size)
+            return false;
+    }
+
+    return true;
+}
+
+static const char* dispatch_name(KeywordDispatch d)
+{
+    switch (d)
+    {
+        case KeywordDispatch::ePermutation:
+            return "permute";
+        case KeywordDispatch::eRuntime:
+            return "runtime";
+        case KeywordDispatch::eSpecialization:
+            return "special";
+    }
+    return "?";
+}
+
+static int cmd_analyze(int argc, char** argv)
+{
+    // vshaderc analyze --shader_root <dir> [--shader <path> ...] [-I <dir> ...] [--keywords-file <vkw>]
+    // [--samples N] [--cache dir] [--no-cache] [--project-root dir] [--verbose]
+    std::string              shaderRoot;
+    std::vector<std::string> shaders;
+    std::vector<std::string> includeDirs;
+    std::string              keywordsPath;
+    size_t                   samples     = 4;
+    bool                     enableCache = true;
+    std::string              cacheDir    = ".vshader_cache";
+    std::string              projectRoot;
+    bool                     verbose = false;
+
+    for (int i = 2; i < argc; ++i)
+    {
+        std::string a = argv[i];
+
+        if (a == "--shader_root" && i + 1 < argc)
+        {
+            shaderRoot = normalize_path_slashes(argv[++i]);
+        }
+        else if (a == "--shader" && i + 1 < argc)
+        {
+            shaders.push_back(normalize_path_slashes(argv[++i]));
+        }
+        else if (a == "-I" && i + 1 < argc)
+        {
+            includeDirs.push_back(normalize_path_slashes(argv[++i]));
+        }
+        else if (a == "--keywords-file" && i + 1 < argc)
+        {
+            keywordsPath = argv[++i];
+        }
+        else if (a == "--samples" && i + 1 < argc)
+        {
+            samples = std::max<size_t>(1, static_cast<size_t>(std::strtoul(argv[++i], nullptr, 10)));
+        }
+        else if (a == "--no-cache")
+        {
+            enableCache = false;
+        }
+        else if (a == "--cache" && i + 1 < argc)
+        {
+            cacheDir = argv[++i];
+        }
+        else if (a == "--project-root" && i + 1 < argc)
+        {
+            projectRoot = normalize_path_slashes(argv[++i]);
+        }
+        else if (a == "--verbose")
+        {
+            verbose = true;
+        }
+        else if (a == "-h" || a == "--help")
+        {
+            print_usage();
+            return 0;
+        }
+        else
+        {
+            log_error("Unknown analyze arg: " + a);
+            return 2;
+        }
+    }
+
+    g_verbose = verbose;
+
+    if (shaderRoot.empty())
+    {
+        log_error("analyze: --shader_root <dir> is required");
+        return 2;
+    }
+
+    std::filesystem::path shaderRootPath = std::filesystem::absolute(shaderRoot);
+
+    if (projectRoot.empty())
+        projectRoot = shaderRootPath.generic_string();
+
+    add_implicit_include_dirs(shaderRootPath, includeDirs);
+
+    EngineKeywordsFile engineKw;
+    bool               hasEngineKw = false;
+    if (!keywordsPath.empty())
+    {
+        auto kwr = load_engine_keywords_vkw(keywordsPath);
+        if (!kwr.isOk())
+        {
+            log_error("analyze: failed to parse keywords file: " + kwr.error().message);
+            return 3;
+        }
+        engineKw    = std::move(kwr.value());
+        hasEngineKw = true;
+    }
+
+    std::vector<std::filesystem::path> shaderFiles;
+    resolve_shader_files(shaderRootPath, shaders, shaderFiles);
+
+    if (shaderFiles.empty())
+    {
+        log_error("analyze: no shaders found under: " + shaderRootPath.generic_string());
+        return 4;
+    }
+
+    FileHashCache fileHashCache;
+
+    const auto sharedIncludeDirs = std::make_shared<const std::vector<std::string>>(includeDirs);
+    const auto sharedEngineKw    = hasEngineKw ? std::make_shared<const EngineKeywordsFile>(engineKw) : nullptr;
+
+    // Samples answered from the build cache have no compile time; estimate with the per-variant
+    // average the last build recorded instead. Read even with --no-cache, it only supplies timings.
+    DependencyGraph graph;
+    {
+        auto gr = DependencyGraph::load(dependency_graph_path(cacheDir));
+        if (gr.isOk())
+            graph = std::move(gr.value());
+    }
+
+    for (const auto& shaderPathAbs : shaderFiles)
+    {
+        std::error_code ec;
+        auto            rel = std::filesystem::relative(shaderPathAbs, shaderRootPath, ec);
+        if (ec)
+            rel = shaderPathAbs.filename();
+
+        const std::string virtualPath = normalize_path_slashes(rel.generic_string());
+
+        const DependencyGraphNode* graphNode = graph.findShader(virtualPath);
+        const double               graphMs   = graphNode ? graphNode->avgCompileMs : 0.0;
+
+        ShaderStage stage {};
+        if (!infer_stage_from_shader_path(shaderPathAbs, stage))
+        {
+            log_error("analyze: failed to infer stage from file name: " + shaderPathAbs.generic_string());
+            return 4;
+        }
+
+        auto src = std::make_shared<std::string>();
+        if (!read_text_file(shaderPathAbs.generic_string(), *src))
+        {
+            log_error("analyze: failed to read shader: " + shaderPathAbs.generic_string());
+            return 4;
+        }
+
+        auto mdr = parse_vultra_metadata(*src);
+        if (!mdr.isOk())
+        {
+            log_error("analyze: failed to parse metadata: " + virtualPath + ": " + mdr.error().message);
+            return 4;
+        }
+        const ParsedMetadata md = std::move(mdr.value());
+
+        auto enr = enumerate_shader_variants(md, hasEngineKw ? &engineKw : nullptr, true);
+        if (!enr.isOk())
+        {
+            log_error("analyze: " + virtualPath + ": " + enr.error().message);
+            return 4;
+        }
+        const auto& variants = enr.value().variants;
+
+        std::unordered_map<std::string, size_t> variantIndex;
+        for (size_t i = 0; i < variants.size(); ++i)
+            variantIndex[normalize_define_set(variants[i])] = i;
+
+        // Each variant is compiled at most once; pairs share samples (and the build cache).
+        std::unordered_map<size_t, AnalyzeSample> compiled;
+        std::string                               firstError;
+
+        auto compile_variant = [&](size_t idx) -> const AnalyzeSample* {
+            auto it = compiled.find(idx);
+            if (it != compiled.end())
+                return &it->second;
+
+            BuildRequest req;
+            req.source.virtualPath        = virtualPath;
+            req.source.sharedSourceText   = src;
+            req.options.stage             = stage;
+            req.options.sharedIncludeDirs = sharedIncludeDirs;
+            req.options.defines           = variants[idx];
+            req.sharedEngineKeywords      = sharedEngineKw;
+
+            req.enableCache   = enableCache;
+            req.cacheDir      = cacheDir;
+            req.projectRoot   = projectRoot;
+            req.fileHashCache = &fileHashCache;
+
+            auto br = build_shader(req);
+            if (!br.isOk())
+            {
+                firstError = "analyze: build failed for " + virtualPath + ": " + br.error().message;
+                return nullptr;
+            }
+
+            auto st = analyze_spirv(br.value().binary.spirv);
+            if (!st.isOk())
+            {
+                firstError = "analyze: " + virtualPath + ": " + st.error().message;
+                return nullptr;
+            }
+
+            AnalyzeSample sample;
+            sample.stats      = st.value();
+            sample.reflection = std::move(br.value().binary.reflection);
+            sample.compileMs  = br.value().compileMs;
+
+            return &compiled.emplace(idx, std::move(sample)).first->second;
+        };
+
+        std::vector<AnalyzeKeywordReport> reports;
+
+        for (const auto& kd : md.keywords)
+        {
+            if (kd.dispatch != KeywordDispatch::ePermutation)
+                continue;
+
+            AnalyzeKeywordReport rep;
+            rep.decl       = &kd;
+            rep.valueCount = (kd.kind == KeywordValueKind::eBool) ? 2 : kd.enumValues.size();
+
+            double sumInstr = 0.0, sumCost = 0.0, sumPct = 0.0, sumMs = 0.0;
+            size_t timed = 0;
+
+            // Evenly spread base variants; the partner differs only in this keyword.
+            const size_t stride = std::max<size_t>(1, variants.size() / samples);
+            for (size_t b = 0; b < variants.size() && rep.pairs < samples; b += stride)
+            {
+                std::vector<Define> partner = variants[b];
+                for (auto& d : partner)
+                {
+                    if (d.name != kd.name)
+                        continue;
+
+                    if (kd.kind == KeywordValueKind::eBool)
+                    {
+                        d.value = (d.value == "1") ? "0" : "1";
+                    }
+                    else
+                    {
+                        auto ev = std::find(kd.enumValues.begin(), kd.enumValues.end(), d.value);
+                        auto ix = static_cast<size_t>(ev - kd.enumValues.begin());
+                        d.value = kd.enumValues[(ix + 1) % kd.enumValues.size()];
+                    }
+                }
+
+                auto pit = variantIndex.find(normalize_define_set(partner));
+                if (pit == variantIndex.end() || pit->second == b)
+                    continue; // partner pruned by only_if
+
+                const AnalyzeSample* sa = compile_variant(b);
+                const AnalyzeSample* sb = sa ? compile_variant(pit->second) : nullptr;
+                if (!sa || !sb)
+                    break;
+
+                const double instrA = sa->stats.functionInstructionCount;
+                const double instrB = sb->stats.functionInstructionCount;
+                const double costA  = static_cast<double>(sa->stats.staticCost);
+                const double costB  = static_cast<double>(sb->stats.staticCost);
+
+                sumInstr += std::abs(instrA - instrB);
+                sumCost += std::abs(costA - costB);
+                sumPct += 100.0 * std::abs(costA - costB) / std::max(1.0, std::max(costA, costB));
+
+                if (!same_interface(*sa, *sb))
+                    rep.interfaceDiff = true;
+
+                for (const auto* smp : {sa, sb})
+                {
+                    if (smp->compileMs > 0.0)
+                    {
+                        sumMs += smp->compileMs;
+                        ++timed;
+                    }
+                }
+
+                ++rep.pairs;
+            }
+
+            if (!firstError.empty())
+                break;
+
+            if (rep.pairs > 0)
+            {
+                rep.avgInstrDelta = sumInstr / static_cast<double>(rep.pairs);
+                rep.avgCostDelta  = sumCost / static_cast<double>(rep.pairs);
+                rep.avgCostPct    = sumPct / static_cast<double>(rep.pairs);
+            }
+
+            rep.variantsSaved      = rep.valueCount > 0 ? variants.size() - variants.size() / rep.valueCount : 0;
+            const double variantMs = timed > 0 ? sumMs / static_cast<double>(timed) : graphMs;
+            rep.buildSavingMs      = variantMs * static_cast<double>(rep.variantsSaved);
+            rep.ratio              = static_cast<double>(rep.variantsSaved) / (1.0 + rep.avgCostDelta);
+
+            if (rep.pairs == 0)
+                rep.recommendation = "keep (no valid sample pairs)";
+            else if (rep.avgInstrDelta == 0.0 && !rep.interfaceDiff)
+                rep.recommendation = "runtime (no SPIR-V difference)";
+            else if (rep.interfaceDiff)
+                rep.recommendation = "keep permute (changes resource/IO interface)";
+            else if (rep.avgCostPct <= kRuntimeCostPct)
+                rep.recommendation = "runtime";
+            else if (rep.avgCostPct <= kSpecialCostPct)
+                rep.recommendation = "special";
+            else
+                rep.recommendation = "keep permute";
+
+            reports.push_back(std::move(rep));
+        }
+
+        if (!firstError.empty())
+        {
+            log_error(firstError);
+            return 5;
+        }
+
+        std::sort(reports.begin(), reports.end(), [](const AnalyzeKeywordReport& a, const AnalyzeKeywordReport& b) {
+            return a.ratio > b.ratio;
+        });
+
+        log_info("analyze: " + virtualPath + " variants=" + std::to_string(variants.size()) +
+                 " compiled=" + std::to_string(compiled.size()));
+
+        char buf[256];
+        for (const auto& r : reports)
+        {
+            std::snprintf(buf,
+                          sizeof(buf),
+                          "analyze:   %-24s %s -> %-44s pairs=%zu dInstr=%.1f dCost=%.1f (%.1f%%) saves=%zu variants "
+                          "(~%s) ratio=%.2f",
+                          r.decl->name.c_str(),
+                          dispatch_name(r.decl->dispatch),
+                          r.recommendation.c_str(),
+                          r.pairs,
+                          r.avgInstrDelta,
+                          r.avgCostDelta,
+                          r.avgCostPct,
+                          r.variantsSaved,
+                          r.buildSavingMs > 0.0 ? format_ms(r.buildSavingMs).c_str() : "? ms",
+                          r.ratio);
+            log_info(buf);
+        }
+    }
+
+    return 0;
+}
+
+// ============================================================
+// query
+// ============================================================
+
+static int cmd_query(int argc, char** argv)
+{
+    // vshaderc query <lib.vshlib> [--shader <id>] [-S <stage>] [--where <expr>] [--count]
+    std::string libPath;
+    std::string shaderId;
+    std::string where;
+    ShaderStage stage     = ShaderStage::eUnknown;
+    bool        countOnly = false;
+
+    for (int i = 2; i < argc; ++i)
+    {
+        std::string a = argv[i];
+        if (a == "-h" || a == "--help")
+        {
+            print_usage();
+            return 0;
+        }
+        else if (a == "--shader" && i + 1 < argc)
+        {
+            shaderId = argv[++i];
+        }
+        else if ((a == "-S" || a == "--stage") && i + 1 < argc)
+        {
+            if (!parse_stage(argv[++i], stage))
+            {
+                log_error(std::string("query: invalid stage: ") + argv[i]);
+                return 2;
+            }
+        }
+        else if (a == "--where" && i + 1 < argc)
+        {
+            where = argv[++i];
+        }
+        else if (a == "--count")
+        {
+            countOnly = true;
+        }
+        else if (a == "--verbose")
+        {
+            g_verbose = true;
+        }
+        else if (!a.empty() && a[0] != '-' && libPath.empty())
+        {
+            libPath = a;
+        }
+        else
+        {
+            log_error("query: unknown/invalid arg: " + a);
+            return 2;
+        }
+    }
+
+    if (libPath.empty())
+    {
+        log_error("query: <lib.vshlib> is required");
+        return 2;
+    }
+
+    auto lr = read_vshlib_file(libPath);
+    if (!lr.isOk())
+    {
+        log_error("query: failed to read " + libPath + ": " + lr.error().message);
+        return 3;
+    }
+    const auto& lib = lr.value();
+    const auto& kb  = lib.keywordBitsets;
+
+    if (kb.entryCount != lib.entries.size())
+        log_info("query: " + libPath + " has no keyword bitsets (written by an older vshaderc); rebuild it");
+
+    KeywordQueryFilter filter;
+    filter.stage        = stage;
+    filter.shaderIdHash = shaderId.empty() ? 0 : shader_id_hash(shaderId);
+
+    auto start = std::chrono::steady_clock::now();
+    auto qr    = query_vshlib(lib, where, filter);
+    auto end   = std::chrono::steady_clock::now();
+
+    if (!qr.isOk())
+    {
+        log_error("query: " + qr.error().message);
+        return 4;
+    }
+
+    const auto& hits = qr.value();
+    const auto  us   = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+    log_verbose("query: evaluated " + std::to_string(lib.entries.size()) + " entries in " + std::to_string(us) +
+                " us");
+
+    if (countOnly)
+    {
+        std::cout << hits.size() << "\n";
+        return 0;
+    }
+
+    for (uint32_t idx : hits)
+    {
+        const auto& e = lib.entries[idx];
+
+        std::string line = "keyHash=" + std::to_string(e.keyHash) + " stage=" + shader_stage_name(e.stage) +
+                           " layoutClass=" + std::to_string(e.layoutClass);
+        for (const auto& f : kb.fields)
+        {
+            uint32_t v = 0;
+            if (!kb.get(idx, f, v))
+                continue;
+            const bool named = f.kind == KeywordValueKind::eEnum && v < f.enumValues.size();
+            line += " " + f.name + "=" + (named ? f.enumValues[v] : std::to_string(v));
+        }
+        std::cout << line << "\n";
+    }
+
+    log_info("query: " + std::to_string(hits.size()) + " of " + std::to_string(lib.entries.size()) + " entries");
+    return 0;
+}
+
+// ============================================================
+// split
+// ============================================================
+
+static int cmd_split(int argc, char** argv)
+{
+    // vshaderc split <lib.vshlib> -o <dir> [--manifest <file>] [--group <name>=<id>,...] [--by-keyword <name>]
+    // [--default <name>]
+    std::string          libPath;
+    std::string          outDir;
+    std::string          manifestPath;
+    LibraryPartitionPlan plan;
+
+    for (int i = 2; i < argc; ++i)
+    {
+        std::string a = argv[i];
+        if (a == "-h" || a == "--help")
+        {
+            print_usage();
+            return 0;
+        }
+        else if (a == "-o" && i + 1 < argc)
+        {
+            outDir = argv[++i];
+        }
+        else if (a == "--manifest" && i + 1 < argc)
+        {
+            manifestPath = argv[++i];
+        }
+        else if (a == "--group" && i + 1 < argc)
+        {
+            ShaderGroup g;
+            if (!parse_shader_group_spec(argv[++i], g))
+            {
+                log_error(std::string("split: invalid --group (expected <name>=<id>[,<id>...]): ") + argv[i]);
+                return 2;
+            }
+            plan.groups.push_back(std::move(g));
+        }
+        else if (a == "--by-keyword" && i + 1 < argc)
+        {
+            plan.keyword = argv[++i];
+        }
+        else if (a == "--default" && i + 1 < argc)
+        {
+            plan.defaultPartition = argv[++i];
+        }
+        else if (a == "--verbose")
+        {
+            g_verbose = true;
+        }
+        else if (!a.empty() && a[0] != '-' && libPath.empty())
+        {
+            libPath = a;
+        }
+        else
+        {
+            log_error("split: unknown/invalid arg: " + a);
+            return 2;
         }
-        return;
     }
 
-    // Enum: use enumerant strings
-    for (const auto& ev : kd->enumValues)
+    if (libPath.empty() || outDir.empty())
     {
-        Define d;
-        d.name  = kd->name;
-        d.value = ev;
-        cur.push_back(std::move(d));
-        enumerate_permutation_variants(permuteDecls, idx + 1, cur, out);
-        cur.pop_back();
+        log_error("split: <lib.vshlib> and -o <dir> are required");
+        return 2;
+    }
+
+    if (!manifestPath.empty())
+    {
+        auto mr = load_partition_manifest(manifestPath);
+        if (!mr.isOk())
+        {
+            log_error("split: " + mr.error().message);
+            return 3;
+        }
+        plan.groups.insert(plan.groups.begin(), mr.value().begin(), mr.value().end());
+    }
+
+    if (plan.groups.empty() && plan.keyword.empty())
+    {
+        log_error("split: nothing to split by; pass --manifest, --group or --by-keyword");
+        return 2;
+    }
+
+    auto lr = read_vshlib_file(libPath);
+    if (!lr.isOk())
+    {
+        log_error("split: failed to read " + libPath + ": " + lr.error().message);
+        return 3;
+    }
+    const auto& lib = lr.value();
+
+    std::vector<ShaderLibraryEntryView> views;
+    views.reserve(lib.entries.size());
+    for (size_t i = 0; i < lib.entries.size(); ++i)
+    {
+        const auto&    e   = lib.entries[i];
+        const uint64_t rel = e.offset - lib.blobOffset;
+        if (e.offset < lib.blobOffset || rel + e.size > lib.blobData.size())
+        {
+            log_error("split: " + libPath + ": entry keyHash=" + std::to_string(e.keyHash) + " is out of range");
+            return 3;
+        }
+        views.push_back({e.keyHash,
+                         e.stage,
+                         {lib.blobData.data() + rel, static_cast<size_t>(e.size)},
+                         lib.profileMasks.empty() ? 0 : lib.profileMasks[i]});
     }
+
+    const std::string baseName = std::filesystem::path(libPath).stem().string();
+    const auto*       keywords = lib.engineKeywordsVkw.empty() ? nullptr : &lib.engineKeywordsVkw;
+    const auto*       profiles = lib.profiles.empty() ? nullptr : &lib.profiles;
+
+    log_info("split: " + libPath + " entries=" + std::to_string(views.size()));
+    return write_partitioned_library("split", views, plan, outDir, baseName, keywords, profiles) ? 0 : 4;
 }
 
-static int cmd_build(int argc, char** argv)
+// ============================================================
+// watch
+// ============================================================
+
+struct WatchedFile
 {
-    // vshaderc build --shader_root <dir> [--shader <path> ...] [-I <dir> ...] [--keywords-file <vkw>] -o <vshlib>
-    // [--cache dir] [--no-cache] [--skip-invalid] [--verbose]
-    std::string              shaderRoot;
-    std::vector<std::string> shaders;
-    std::vector<std::string> includeDirs;
-    std::string              keywordsPath;
-    std::string              outLibPath;
-    bool                     enableCache = true;
-    std::string              cacheDir    = ".vshader_cache";
-    bool                     skipInvalid = false;
-    bool                     verbose     = false;
+    std::filesystem::path           path;
+    std::filesystem::file_time_type mtime {};
+};
+
+struct WatchedShader
+{
+    std::filesystem::path           path;
+    std::string                     virtualPath;
+    ShaderStage                     stage {};
+    std::vector<WatchedFile>        files;   // source + includes of the last build; empty = never built
+    std::vector<ShaderLibraryEntry> entries; // last successful build, for -o
+};
+
+static int cmd_watch(int argc, char** argv)
+{
+    // vshaderc watch --shader_root <dir> [--shader <path> ...] [-I <dir> ...] [--keywords-file <vkw>]
+    // [--live <socket>] [-o <vshlib>] [--interval <ms>] [-j N] [--cache dir] [--no-cache] [--project-root dir]
+    std::string                shaderRoot;
+    std::vector<std::string>   shaders;
+    std::vector<std::string>   includeDirs;
+    std::string                keywordsPath;
+    std::string                bindingTablePath;
+    std::string                outLibPath;
+    std::string                livePath;
+    uint32_t                   intervalMs  = 200;
+    uint32_t                   jobs        = 0;
+    bool                       enableCache = true;
+    std::string                cacheDir    = ".vshader_cache";
+    std::string                projectRoot;
+    std::vector<WorkgroupSize> workgroupSizes;
+    bool                       skipInvalid = false;
+    bool                       verbose     = false;
 
     for (int i = 2; i < argc; ++i)
     {
@@ -782,26 +4058,40 @@ static int cmd_build(int argc, char** argv)
         {
             includeDirs.push_back(normalize_path_slashes(argv[++i]));
         }
-        else if ((a == "--keywords-file" || a.rfind("--keywords-file=", 0) == 0))
+        else if (a == "--keywords-file" && i + 1 < argc)
         {
-            if (a == "--keywords-file")
-            {
-                if (i + 1 >= argc)
-                {
-                    log_error("--keywords-file requires a path");
-                    return 2;
-                }
-                keywordsPath = argv[++i];
-            }
-            else
+            keywordsPath = argv[++i];
+        }
+        else if (a == "--binding-table" && i + 1 < argc)
+        {
+            bindingTablePath = argv[++i];
+        }
+        else if (a == "--workgroup-sizes" && i + 1 < argc)
+        {
+            auto wr = parse_workgroup_sizes(argv[++i]);
+            if (!wr.isOk())
             {
-                keywordsPath = a.substr(std::string("--keywords-file=").size());
+                log_error("watch: " + wr.error().message);
+                return 2;
             }
+            workgroupSizes = std::move(wr.value());
+        }
+        else if (a == "--live" && i + 1 < argc)
+        {
+            livePath = argv[++i];
         }
         else if (a == "-o" && i + 1 < argc)
         {
             outLibPath = argv[++i];
         }
+        else if (a == "--interval" && i + 1 < argc)
+        {
+            intervalMs = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        }
+        else if ((a == "-j" || a == "--jobs") && i + 1 < argc)
+        {
+            jobs = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        }
         else if (a == "--no-cache")
         {
             enableCache = false;
@@ -810,6 +4100,10 @@ static int cmd_build(int argc, char** argv)
         {
             cacheDir = argv[++i];
         }
+        else if (a == "--project-root" && i + 1 < argc)
+        {
+            projectRoot = normalize_path_slashes(argv[++i]);
+        }
         else if (a == "--skip-invalid")
         {
             skipInvalid = true;
@@ -825,7 +4119,7 @@ static int cmd_build(int argc, char** argv)
         }
         else
         {
-            log_error("Unknown build arg: " + a);
+            log_error("Unknown watch arg: " + a);
             return 2;
         }
     }
@@ -834,345 +4128,314 @@ static int cmd_build(int argc, char** argv)
 
     if (shaderRoot.empty())
     {
-        log_error("build: --shader_root <dir> is required");
+        log_error("watch: --shader_root <dir> is required");
         return 2;
     }
-    if (outLibPath.empty())
+    if (livePath.empty() && outLibPath.empty())
     {
-        log_error("build: -o <output.vshlib> is required");
+        log_error("watch: nothing to update; give --live <socket> and/or -o <output.vshlib>");
         return 2;
     }
 
-    std::filesystem::path shaderRootPath = std::filesystem::absolute(shaderRoot);
-
-    // Implicit include dirs: shader_root and shader_root/include if present.
-    {
-        includeDirs.push_back(shaderRootPath.generic_string());
-        const auto      inc = shaderRootPath / "include";
-        std::error_code ec;
-        if (std::filesystem::exists(inc, ec))
-            includeDirs.push_back(inc.generic_string());
-    }
+    const std::filesystem::path shaderRootPath = std::filesystem::absolute(shaderRoot);
+    if (projectRoot.empty())
+        projectRoot = shaderRootPath.generic_string();
+    const auto projectRootPath = resolve_project_root(projectRoot);
 
-    EngineKeywordsFile   engineKw;
-    bool                 hasEngineKw = false;
-    std::vector<uint8_t> keywordsBytes;
+    add_implicit_include_dirs(shaderRootPath, includeDirs);
 
+    // Loaded once and shared by every variant request; null when not given.
+    std::shared_ptr<const EngineKeywordsFile> keywords;
+    std::vector<uint8_t>                      keywordsBytes;
     if (!keywordsPath.empty())
     {
-        log_info("build: loading engine keywords: " + keywordsPath);
         auto kwr = load_engine_keywords_vkw(keywordsPath);
-        if (!kwr.isOk())
+        if (!kwr.isOk() || !read_binary_file(keywordsPath, keywordsBytes))
         {
-            log_error("build: failed to parse keywords file: " + kwr.error().message);
+            log_error("watch: failed to load keywords file: " + keywordsPath);
             return 3;
         }
-        engineKw    = std::move(kwr.value());
-        hasEngineKw = true;
+        keywords = std::make_shared<const EngineKeywordsFile>(std::move(kwr.value()));
+    }
 
-        if (!read_binary_file(keywordsPath, keywordsBytes))
+    std::shared_ptr<const BindingTable> bindingTable;
+    if (!bindingTablePath.empty())
+    {
+        auto btr = load_binding_table(bindingTablePath);
+        if (!btr.isOk())
         {
-            log_error("build: failed to read keywords bytes: " + keywordsPath);
+            log_error("watch: failed to load binding table: " + btr.error().message);
             return 3;
         }
+        bindingTable = std::make_shared<const BindingTable>(std::move(btr.value()));
     }
 
-    // Resolve shader list.
-    std::vector<std::filesystem::path> shaderFiles;
+    const auto sharedIncludeDirs = std::make_shared<const std::vector<std::string>>(includeDirs);
 
-    if (shaders.empty())
-    {
-        scan_shader_root(shaderRootPath, shaderFiles);
-    }
-    else
+    LiveLinkServer live;
+    if (!livePath.empty())
     {
-        shaderFiles.reserve(shaders.size());
-        for (const auto& s : shaders)
+        auto lr = live.open(livePath);
+        if (!lr.isOk())
         {
-            std::filesystem::path p = s;
-            if (p.is_relative())
-                p = shaderRootPath / p;
-            shaderFiles.push_back(std::filesystem::weakly_canonical(p));
+            log_error("watch: " + lr.error().message);
+            return 3;
         }
-        std::sort(shaderFiles.begin(), shaderFiles.end());
-    }
-
-    if (shaderFiles.empty())
-    {
-        log_error("build: no shaders found under: " + shaderRootPath.generic_string());
-        return 4;
+        log_info("watch: live link listening on " + livePath);
     }
 
-    log_info("build: shaders=" + std::to_string(shaderFiles.size()));
-
-    std::vector<ShaderLibraryEntry> entries;
-    entries.reserve(1024);
-
-    std::unordered_set<uint64_t> seen;
-    seen.reserve(4096);
+    FileHashCache fileHashCache;
+    ThreadPool    pool(jobs);
 
-    size_t      pruned     = 0;
-    std::string firstError = {};
+    std::vector<WatchedShader> watched;
 
-    size_t shaderIndex = 0;
+    // mtimes are read once per pass; a missing file reads as the minimum time.
+    std::unordered_map<std::string, std::filesystem::file_time_type> mtimes;
+    auto mtimeOf = [&](const std::filesystem::path& p) {
+        auto [it, inserted] = mtimes.try_emplace(p.generic_string());
+        if (inserted)
+        {
+            std::error_code ec;
+            it->second = std::filesystem::last_write_time(p, ec);
+            if (ec)
+                it->second = std::filesystem::file_time_type::min();
+        }
+        return it->second;
+    };
 
-    for (const auto& shaderPathAbs : shaderFiles)
+    bool firstPass = true;
+    for (;; std::this_thread::sleep_for(std::chrono::milliseconds(intervalMs)))
     {
-        ++shaderIndex;
+        mtimes.clear();
 
-        std::error_code ec;
-        auto            rel = std::filesystem::relative(shaderPathAbs, shaderRootPath, ec);
-        if (ec)
-            rel = shaderPathAbs.filename();
+        if (live.accept() > 0)
+            log_info("watch: live clients=" + std::to_string(live.clientCount()));
 
-        const std::string virtualPath = normalize_path_slashes(rel.generic_string());
+        // Pick up added and removed shaders.
+        std::vector<std::filesystem::path> shaderFiles;
+        resolve_shader_files(shaderRootPath, shaders, shaderFiles);
 
-        ShaderStage stage {};
-        if (!infer_stage_from_shader_path(shaderPathAbs, stage))
+        bool                            removed = false;
+        std::unordered_set<std::string> known;
+        for (auto it = watched.begin(); it != watched.end();)
         {
-            firstError = "build: failed to infer stage from file name: " + shaderPathAbs.generic_string();
-            break;
+            if (std::binary_search(shaderFiles.begin(), shaderFiles.end(), it->path))
+            {
+                known.insert(it->path.generic_string());
+                ++it;
+                continue;
+            }
+            log_info("watch: removed " + it->virtualPath);
+            it      = watched.erase(it);
+            removed = true;
         }
+        for (const auto& p : shaderFiles)
+        {
+            if (known.count(p.generic_string()))
+                continue;
 
-        log_info("build: [" + std::to_string(shaderIndex) + "/" + std::to_string(shaderFiles.size()) + "] " +
-                 virtualPath);
+            WatchedShader w;
+            w.path = p;
 
-        std::string src;
-        if (!read_text_file(shaderPathAbs.generic_string(), src))
-        {
-            firstError = "build: failed to read shader: " + shaderPathAbs.generic_string();
-            break;
+            std::error_code ec;
+            auto            rel = std::filesystem::relative(p, shaderRootPath, ec);
+            w.virtualPath       = normalize_path_slashes((ec ? p.filename() : rel).generic_string());
+            if (!infer_stage_from_shader_path(p, w.stage))
+            {
+                log_verbose("watch: skipping " + w.virtualPath + " (cannot infer stage)");
+                continue;
+            }
+            watched.push_back(std::move(w));
         }
 
-        auto mdr = parse_vultra_metadata(src);
-        if (!mdr.isOk())
+        // Dirty: never built, or any recorded file changed since its build.
+        std::vector<size_t> dirty;
+        for (size_t si = 0; si < watched.size(); ++si)
         {
-            firstError = "build: failed to parse metadata: " + virtualPath + ": " + mdr.error().message;
-            break;
+            const auto& files   = watched[si].files;
+            auto        changed = [&](const WatchedFile& f) { return mtimeOf(f.path) != f.mtime; };
+            if (files.empty() || std::any_of(files.begin(), files.end(), changed))
+                dirty.push_back(si);
         }
 
-        ParsedMetadata md = std::move(mdr.value());
-
-        // Collect permutation keyword decls
-        std::vector<const KeywordDecl*> permuteDecls;
-        permuteDecls.reserve(md.keywords.size());
-
-        for (const auto& kd : md.keywords)
+        if (dirty.empty() && !removed)
         {
-            if (kd.dispatch == KeywordDispatch::ePermutation)
-                permuteDecls.push_back(&kd);
+            firstPass = false;
+            continue;
         }
 
-        // Enumerate all combinations
-        std::vector<std::vector<Define>> variantDefines;
+        const auto start = std::chrono::steady_clock::now();
+
+        // Every variant of every dirty shader goes to the pool at once; pendingShader[i] owns requests[i].
+        std::vector<BuildRequest> requests;
+        std::vector<size_t>       pendingShader;
+        std::vector<std::string>  errors(watched.size());
+        for (size_t si : dirty)
         {
-            std::vector<Define> cur;
-            enumerate_permutation_variants(permuteDecls, 0, cur, variantDefines);
-        }
+            const auto& w = watched[si];
+
+            auto src = std::make_shared<std::string>();
+            if (!read_text_file(w.path.generic_string(), *src))
+            {
+                errors[si] = "failed to read shader";
+                continue;
+            }
 
-        if (variantDefines.empty())
-            variantDefines.push_back({});
+            auto mdr = parse_vultra_metadata(*src);
+            if (!mdr.isOk())
+            {
+                errors[si] = mdr.error().message;
+                continue;
+            }
 
-        log_info("build: variants=" + std::to_string(variantDefines.size()));
+            auto enr = enumerate_shader_variants(mdr.value(), keywords.get(), skipInvalid);
+            if (!enr.isOk())
+            {
+                errors[si] = enr.error().message;
+                continue;
+            }
 
-        size_t variantIndex = 0;
+            for (auto& defines : enr.value().variants)
+            {
+                BuildRequest req;
+                req.source.virtualPath        = w.virtualPath;
+                req.source.sharedSourceText   = src;
+                req.options.stage             = w.stage;
+                req.options.sharedIncludeDirs = sharedIncludeDirs;
+                req.options.defines           = std::move(defines);
+                req.sharedEngineKeywords      = keywords;
+                req.sharedBindingTable        = bindingTable;
+                if (w.stage == ShaderStage::eComp)
+                    req.workgroupSizes = workgroupSizes;
+                req.enableCache   = enableCache;
+                req.cacheDir      = cacheDir;
+                req.projectRoot   = projectRoot;
+                req.fileHashCache = &fileHashCache;
+
+                requests.push_back(std::move(req));
+                pendingShader.push_back(si);
+            }
+        }
 
-        for (auto& defines : variantDefines)
+        auto results = build_shaders(requests, pool);
+        for (size_t j = 0; j < results.size(); ++j)
         {
-            ++variantIndex;
-
-            // Constraint pruning (only_if)
-            bool skipThisVariant = false;
+            if (!results[j].isOk() && errors[pendingShader[j]].empty())
+                errors[pendingShader[j]] = results[j].error().message;
+        }
 
-            {
-                KeywordValueContext ctx;
-                ctx.values.reserve(md.keywords.size() * 2);
-                ctx.decls.reserve(md.keywords.size() * 2);
+        const double compileMs =
+            std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
 
-                for (const auto& kd : md.keywords)
-                    ctx.decls[kd.name] = &kd;
+        // Publish per shader: all of its binaries, or its error and nothing else.
+        size_t sent   = 0;
+        size_t failed = 0;
+        for (size_t si : dirty)
+        {
+            auto&          w            = watched[si];
+            const uint64_t shaderIdHash = shader_id_hash(shader_id_from_virtual_path(w.virtualPath));
 
-                std::unordered_map<std::string, std::string> defMap;
-                defMap.reserve(defines.size() * 2);
-                for (const auto& d : defines)
-                    defMap[d.name] = d.value;
+            std::vector<WatchedFile> files = {{w.path, mtimeOf(w.path)}};
 
-                // resolve values for all keywords: defaults -> defines -> engineKw (global only)
-                for (const auto& kd : md.keywords)
+            if (!errors[si].empty())
+            {
+                ++failed;
+                log_error("watch: " + w.virtualPath + ": " + errors[si]);
+
+                LiveLinkMessage m;
+                m.kind         = LiveLinkMessageKind::eError;
+                m.stage        = w.stage;
+                m.shaderIdHash = shaderIdHash;
+                m.payload.assign(errors[si].begin(), errors[si].end());
+                if (!firstPass)
+                    live.publish(m);
+
+                // Keep the previous includes so an include fix still triggers a rebuild.
+                for (const auto& f : w.files)
                 {
-                    uint32_t v = kd.defaultValue;
+                    if (f.path != w.path)
+                        files.push_back({f.path, mtimeOf(f.path)});
+                }
+                w.files = std::move(files);
+                continue;
+            }
 
-                    auto it = defMap.find(kd.name);
-                    if (it != defMap.end())
-                    {
-                        auto pv = parse_keyword_value_local(kd, it->second);
-                        if (!pv.isOk())
-                        {
-                            firstError = "build: invalid keyword value for " + kd.name + " in " + virtualPath + ": " +
-                                         pv.error().message;
-                            break;
-                        }
-                        v = pv.value();
-                    }
-                    else if (hasEngineKw && kd.scope == KeywordScope::eGlobal)
-                    {
-                        auto iv = engineKw.values.find(kd.name);
-                        if (iv != engineKw.values.end())
-                        {
-                            auto pv = parse_keyword_value_local(kd, iv->second);
-                            if (!pv.isOk())
-                            {
-                                firstError =
-                                    "build: invalid engine keyword value for " + kd.name + ": " + pv.error().message;
-                                break;
-                            }
-                            v = pv.value();
-                        }
-                    }
+            std::vector<ShaderLibraryEntry> entries;
+            std::unordered_set<std::string> deps;
+            for (size_t j = 0; j < results.size(); ++j)
+            {
+                if (pendingShader[j] != si)
+                    continue;
 
-                    ctx.values[kd.name] = v;
+                auto& br = results[j].value();
+                for (const auto& dep : br.binary.dependencies)
+                {
+                    std::filesystem::path p = dep.path;
+                    if (p.is_relative())
+                        p = projectRootPath / p;
+                    if (deps.insert(p.generic_string()).second)
+                        files.push_back({p, mtimeOf(p)});
                 }
+                br.binary.dependencies.clear();
 
-                if (!firstError.empty())
-                    break;
+                std::vector<ShaderBinary*> binaries = {&br.binary};
+                for (auto& sv : br.sizeVariants)
+                    binaries.push_back(&sv);
 
-                for (const auto& kd : md.keywords)
+                for (ShaderBinary* bin : binaries)
                 {
-                    if (kd.constraint.empty())
-                        continue;
-
-                    auto er = eval_only_if(kd.constraint, ctx);
-                    if (!er.isOk())
+                    auto bytes = write_vshbin(*bin);
+                    if (!bytes.isOk())
                     {
-                        firstError = "build: failed to eval only_if for keyword '" + kd.name + "' in " + virtualPath +
-                                     ": " + er.error().message;
-                        break;
+                        log_error("watch: " + w.virtualPath + ": " + bytes.error().message);
+                        continue;
                     }
-                    if (!er.value())
-                    {
-                        ++pruned;
 
-                        if (!skipInvalid)
-                        {
-                            firstError =
-                                "build: variant violates only_if constraint: " + virtualPath + " (" + kd.name + ")";
-                            break;
-                        }
-
-                        skipThisVariant = true;
-                        break;
-                    }
+                    ShaderLibraryEntry e;
+                    e.keyHash = (bin->variantHash != 0) ? bin->variantHash : bin->contentHash;
+                    e.stage   = bin->stage;
+                    e.blob    = std::move(bytes.value());
+                    entries.push_back(std::move(e));
                 }
-
-                if (!firstError.empty())
-                    break;
             }
 
-            if (skipThisVariant)
-                continue;
-
-            BuildRequest req;
-            req.source.virtualPath  = virtualPath;
-            req.source.sourceText   = src;
-            req.options.stage       = stage;
-            req.options.includeDirs = includeDirs;
-            req.options.defines     = defines;
-
-            req.hasEngineKeywords = hasEngineKw;
-            if (hasEngineKw)
-                req.engineKeywords = engineKw;
-
-            req.enableCache = enableCache;
-            req.cacheDir    = cacheDir;
-
-            log_verbose("build: compiling variant " + std::to_string(variantIndex) + "/" +
-                        std::to_string(variantDefines.size()));
-
-            auto br = build_shader(req);
-            if (!br.isOk())
+            if (!firstPass)
             {
-                firstError = "build: build failed for " + virtualPath + ": " + br.error().message;
-                break;
+                for (const auto& e : entries)
+                    live.publish({LiveLinkMessageKind::eBinary, e.stage, e.keyHash, shaderIdHash, e.blob});
+                sent += entries.size();
+                log_info("watch: rebuilt " + w.virtualPath + " entries=" + std::to_string(entries.size()));
             }
 
-            const auto& bin = br.value().binary;
-
-            ShaderLibraryEntry e;
-            e.keyHash = (bin.variantHash != 0) ? bin.variantHash : bin.contentHash;
-            e.stage   = bin.stage;
-
-            const uint64_t sig =
-                xxhash64(&e.keyHash, sizeof(e.keyHash), static_cast<uint64_t>(static_cast<uint8_t>(e.stage)));
+            w.entries = std::move(entries);
+            w.files   = std::move(files);
+        }
 
-            log_info("build: building " + virtualPath + " variant " + std::to_string(variantIndex) + "/" +
-                     std::to_string(variantDefines.size()) + " shaderIdHash=" + std::to_string(bin.shaderIdHash) +
-                     " contentHash=" + std::to_string(bin.contentHash) + " variantHash=" +
-                     std::to_string(bin.variantHash) + " stage=" + std::to_string(static_cast<int>(bin.stage)));
+        if (!firstPass)
+            live.commit();
 
-            auto bytes = write_vshbin(bin);
-            if (!bytes.isOk())
-            {
-                firstError = "build: failed to serialize vshbin for " + virtualPath + ": " + bytes.error().message;
-                break;
-            }
-            e.blob = std::move(bytes.value());
+        log_info("watch: " + std::string(firstPass ? "initial build" : "rebuild") + " shaders=" +
+                 std::to_string(dirty.size()) + " variants=" + std::to_string(requests.size()) + " failed=" +
+                 std::to_string(failed) + " in " + format_ms(compileMs) +
+                 (firstPass ? "" : ", sent " + std::to_string(sent) + " to " + std::to_string(live.clientCount()) +
+                                       " live client(s)"));
 
-            if (seen.find(sig) != seen.end())
+        if (!outLibPath.empty())
+        {
+            std::vector<ShaderLibraryEntryView> views;
+            for (const auto& w : watched)
             {
-                // Skip duplicates: this can happen when different shader files/variants produce the same content hash.
-                ++pruned;
-                log_verbose("build: skipping duplicate entry for " + virtualPath + " variant " +
-                            std::to_string(variantIndex) + "/" + std::to_string(variantDefines.size()) + " keyHash=" +
-                            std::to_string(e.keyHash) + " stage=" + std::to_string(static_cast<int>(e.stage)));
-                continue;
+                for (const auto& e : w.entries)
+                    views.push_back({e.keyHash, e.stage, e.blob});
             }
 
-            seen.insert(sig);
-            entries.push_back(std::move(e));
-        }
-
-        if (!firstError.empty())
-            break;
-    }
-
-    if (!firstError.empty())
-    {
-        log_error(firstError);
-        return 5;
-    }
-
-    // Deterministic ordering for stable builds
-    std::sort(entries.begin(), entries.end(), [](const ShaderLibraryEntry& a, const ShaderLibraryEntry& b) {
-        if (a.keyHash != b.keyHash)
-            return a.keyHash < b.keyHash;
-        return static_cast<uint8_t>(a.stage) < static_cast<uint8_t>(b.stage);
-    });
-
-    // Ensure output directory exists
-    auto outDir = std::filesystem::path(outLibPath).parent_path();
-    if (!outDir.empty())
-    {
-        std::error_code ec;
-        std::filesystem::create_directories(outDir, ec);
-        if (ec)
-        {
-            log_error("build: failed to create output directory: " + outDir.generic_string() + ": " + ec.message());
-            return 6;
+            const auto* keywordsPtr = keywordsBytes.empty() ? nullptr : &keywordsBytes;
+            if (!publish_library_views(outLibPath, std::move(views), keywordsPtr, nullptr))
+                log_error("watch: failed to write " + outLibPath);
         }
-    }
-
-    log_info("build: writing vshlib: " + outLibPath + " entries=" + std::to_string(entries.size()) +
-             " pruned=" + std::to_string(pruned));
 
-    auto w = write_vslib(outLibPath, entries, keywordsBytes.empty() ? nullptr : &keywordsBytes);
-    if (!w.isOk())
-    {
-        log_error("build: write vshlib failed: " + w.error().message);
-        return 7;
+        firstPass = false;
     }
-
-    log_info("build: OK -> " + outLibPath);
-    return 0;
 }
 
 // ============================================================
@@ -1204,6 +4467,24 @@ int main(int argc, char** argv)
     if (cmd == "packlib")
         return cmd_packlib(argc, argv);
 
+    if (cmd == "deps")
+        return cmd_deps(argc, argv);
+
+    if (cmd == "analyze")
+        return cmd_analyze(argc, argv);
+
+    if (cmd == "query")
+        return cmd_query(argc, argv);
+
+    if (cmd == "split")
+        return cmd_split(argc, argv);
+
+    if (cmd == "watch")
+        return cmd_watch(argc, argv);
+
+    if (cmd == "worker")
+        return cmd_worker(argc, argv);
+
     // Optional backward-compat: if user runs "vshaderc -i ...", treat as compile.
     // This keeps old scripts working.
     if (!cmd.empty() && cmd[0] == '-')
@@ -3,6 +3,7 @@
 #include "vshadersystem/result.hpp"
 #include "vshadersystem/types.hpp"
 
+#include <span>
 #include <string>
 #include <vector>
 
@@ -27,24 +28,49 @@ namespace vshadersystem
     // Known tags:
     //
     // 'SPRV' : SPIR-V bytecode
-    // 'REFL' : reflection info
+    // 'REFL' : reflection info (member types and compute local size in v3+, local size spec ids in v4+,
+    //          shader record block flag in v5+)
     // 'MDES' : material description
     // 'SIDH' : shader id hash (u64). Present in v2+.
     // 'VKEY' : variant key hash (u64). Present in v2+ when computed.
+    // 'DEPS' : resolved includes ([path string][contentHash u64] list). Present in cache entries.
+    // 'KVAL' : permutation keyword values ([name string][kind u8][value u32][enum strings] list).
+    //          Present when the shader declares permute keywords.
+    // 'WGSZ' : workgroup sizes built from this variant ([x u32][y u32][z u32] list).
+    // 'HGRP' : ray tracing hit groups the shader belongs to ([name string] list).
     //
     // Unknown chunks are skipped for forward compatibility.
     //
     // The format can be extended in future versions,
     // e.g.:
     //
-    // 'DEPS' : dependency list
     // 'DXIL' : DirectX backend
     // 'MSL ' : Metal backend
     //
 
     Result<std::vector<uint8_t>> write_vshbin(const ShaderBinary& bin);
-    Result<ShaderBinary>         read_vshbin(const std::vector<uint8_t>& bytes);
+    Result<ShaderBinary>         read_vshbin(std::span<const uint8_t> bytes);
 
     Result<void>         write_vshbin_file(const std::string& path, const ShaderBinary& bin);
     Result<ShaderBinary> read_vshbin_file(const std::string& path);
+
+    // Identity, reflection and keyword values of a .vshbin, without its SPIR-V or material description.
+    struct ShaderBinaryInfo
+    {
+        uint64_t    contentHash  = 0;
+        uint64_t    shaderIdHash = 0;
+        uint64_t    variantHash  = 0;
+        uint64_t    spirvHash    = 0;
+        ShaderStage stage        = ShaderStage::eFrag;
+        uint64_t    byteSize     = 0; // size of the whole .vshbin
+
+        ShaderReflection          reflection;
+        std::vector<KeywordValue> keywordValues;
+        std::vector<std::string>  hitGroups;
+    };
+
+    // Parses the header and the SIDH/VKEY/REFL/KVAL/HGRP chunks only; other chunks are skipped unread and
+    // the SPIR-V hash is not verified. The file variant seeks over skipped chunks instead of reading them.
+    Result<ShaderBinaryInfo> peek_vshbin(std::span<const uint8_t> bytes);
+    Result<ShaderBinaryInfo> peek_vshbin_file(const std::string& path);
 } // namespace vshadersystem
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "vshadersystem/keywords.hpp"
+#include "vshadersystem/result.hpp"
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace vshadersystem
+{
+    // ------------------------------------------------------------
+    // Canonical descriptor binding table (.vbt)
+    //
+    // A project-wide, line-oriented table that assigns every shared resource
+    // a fixed (set, binding), grouped by update frequency so that variants and
+    // shaders declaring the same resources end up with compatible pipeline layouts.
+    //
+    // Lines:
+    //   - Comments start with '#'
+    //   - resource <global|pass|material|local> <NAME> [set=<N>] [binding=<N>]
+    //
+    // Frequency picks the default set:
+    //   global -> 0, pass -> 1, material -> 2, local -> 3
+    //
+    // Bindings not given explicitly are assigned in file order, skipping
+    // bindings taken explicitly in the same set.
+    //
+    // NAME matches the reflected resource name (block name for buffers,
+    // variable name otherwise; the variable instance name also matches).
+    // ------------------------------------------------------------
+
+    struct BindingTableEntry
+    {
+        std::string  name;
+        KeywordScope frequency = KeywordScope::eShaderLocal;
+        uint32_t     set       = 0;
+        uint32_t     binding   = 0;
+    };
+
+    struct BindingTable
+    {
+        std::vector<BindingTableEntry> entries;
+
+        const BindingTableEntry* find(std::string_view name) const;
+    };
+
+    Result<BindingTable> parse_binding_table(std::string_view text);
+    Result<BindingTable> load_binding_table(const std::string& filePath);
+
+    // Rewrites OpDecorate DescriptorSet/Binding of every resource listed in the table.
+    // Resources not in the table keep their bindings; a remap that makes two resources
+    // share a (set, binding) is an error. Returns the number of resources remapped.
+    Result<uint32_t> apply_binding_table(std::vector<uint32_t>& spirv, const BindingTable& table);
+} // namespace vshadersystem
@@ -3,7 +3,12 @@
 #include "vshadersystem/result.hpp"
 #include "vshadersystem/types.hpp"
 
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace vshadersystem
@@ -14,12 +19,51 @@ namespace vshadersystem
         std::string value;
     };
 
+    // ------------------------------------------------------------
+    // IncludeCache
+    //
+    // Include file contents shared across compiles, so a batch whose shaders
+    // include the same headers reads and hashes each header once.
+    // Entries are revalidated by size + mtime. Thread-safe.
+    //
+    // Include guards are detected on load: a header with an #ifndef guard or
+    // #pragma once is included at most once per translation unit, later
+    // #includes of it resolve to empty text instead of being lexed again.
+    // ------------------------------------------------------------
+    class IncludeCache
+    {
+    public:
+        struct File
+        {
+            std::shared_ptr<const std::string> text;
+            uint64_t                           hash = 0; // xxhash64 of text
+
+            std::string              guardMacro; // X of a whole-file #ifndef X / #define X ... #endif, or empty
+            bool                     pragmaOnce = false;
+            std::vector<std::string> undefs; // macros the file #undefs
+        };
+
+        // Returns false if the file cannot be read.
+        bool load(const std::filesystem::path& path, File& outFile);
+
+    private:
+        struct Entry
+        {
+            std::filesystem::file_time_type mtime {};
+            uintmax_t                       size = 0;
+            File                            file;
+        };
+
+        std::mutex                             m_Mutex;
+        std::unordered_map<std::string, Entry> m_Entries;
+    };
+
     struct CompileOptions
     {
         ShaderStage stage = ShaderStage::eUnknown;
 
         // Target SPIR-V version. glslang uses Vulkan/OpenGL envs; we expose a minimal target here.
-        int spirvVersion = 0; // 0 = default for environment
+        int spirvVersion = 0; // header encoding, e.g. 0x10400 for 1.4; 0 = default for environment
 
         bool optimize       = false;
         bool debugInfo      = false;
@@ -28,13 +72,35 @@ namespace vshadersystem
         std::vector<Define>      defines;
         std::vector<std::string> includeDirs;
 
+        // Optional shared include directories, used instead of includeDirs when set. Lets every
+        // variant request of a build reference one list.
+        std::shared_ptr<const std::vector<std::string>> sharedIncludeDirs;
+
+        // Optional include content cache shared between compiles. Not owned.
+        IncludeCache* includeCache = nullptr;
+
+        // Emit a linkable SPIR-V module (Linkage capability) instead of an executable one.
+        // See link_modules.hpp.
+        bool compileOnly = false;
+
         // We can extend this with macro stripping, warnings as errors, etc.
+
+        const std::vector<std::string>& includeDirList() const
+        {
+            return sharedIncludeDirs ? *sharedIncludeDirs : includeDirs;
+        }
     };
 
     struct SourceInput
     {
         std::string virtualPath; // used for includes and diagnostics
         std::string sourceText;
+
+        // Optional shared source text, used instead of sourceText when set. Lets every variant
+        // request of a shader reference one copy of the file.
+        std::shared_ptr<const std::string> sharedSourceText;
+
+        const std::string& text() const { return sharedSourceText ? *sharedSourceText : sourceText; }
     };
 
     struct CompileOutput
@@ -42,7 +108,11 @@ namespace vshadersystem
         std::vector<uint32_t>    spirv;
         std::string              infoLog;
         std::vector<std::string> dependencies;
+        std::vector<uint64_t>    dependencyHashes; // content hash of each dependency, as read by the includer
     };
 
     Result<CompileOutput> compile_glsl_to_spirv(const SourceInput& input, const CompileOptions& opt);
+
+    // Resolve #include dependencies (same include rules and defines as compile) without generating SPIR-V.
+    Result<std::vector<std::string>> scan_dependencies(const SourceInput& input, const CompileOptions& opt);
 } // namespace vshadersystem
@@ -0,0 +1,118 @@
+#pragma once
+
+#include "vshadersystem/result.hpp"
+
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace vshadersystem
+{
+    // ------------------------------------------------------------
+    // Project-relative paths
+    //
+    // Paths recorded in cache entries and the dependency graph are made
+    // relative to a project root, so they stay valid across machines.
+    // ------------------------------------------------------------
+
+    // Canonical project root. Empty input means the current working directory.
+    std::filesystem::path resolve_project_root(const std::string& projectRoot);
+
+    // Relative paths are returned as-is; absolute paths under root become root-relative;
+    // anything else is returned as a canonical absolute path.
+    std::string make_portable_path(const std::string& path, const std::filesystem::path& root);
+
+    // ------------------------------------------------------------
+    // FileHashCache
+    //
+    // Memoized xxhash64 of file contents, revalidated by size + mtime.
+    // Shared across build requests so a large build hashes each include once
+    // instead of once per variant. Thread-safe.
+    // ------------------------------------------------------------
+    class FileHashCache
+    {
+    public:
+        // Returns false if the file cannot be read.
+        bool hash(const std::filesystem::path& path, uint64_t& outHash);
+
+    private:
+        struct Entry
+        {
+            std::filesystem::file_time_type mtime {};
+            uintmax_t                       size = 0;
+            uint64_t                        hash = 0;
+        };
+
+        std::mutex                             m_Mutex;
+        std::unordered_map<std::string, Entry> m_Entries;
+    };
+
+    // ------------------------------------------------------------
+    // Dependency graph
+    //
+    // Shader -> transitive #include edges, aggregated over all variants of a
+    // shader, plus per-variant compile timings observed by `vshaderc build`.
+    // Persisted next to the build cache (see dependency_graph_path).
+    //
+    // Text format (one record per line, tab separated):
+    //   vshdeps <version>
+    //   R <projectRoot>            (absolute root the paths below are relative to)
+    //   S <virtualPath> <path> <variantCount> <avgCompileMs> <inputsHash>
+    //   I <includePath>            (belongs to the preceding S record)
+    // Version 1 graphs (no inputsHash) still load, with inputsHash 0; graphs before
+    // version 3 have no R record and an empty projectRoot.
+    // ------------------------------------------------------------
+
+    struct DependencyGraphNode
+    {
+        std::string              virtualPath;  // shader id path (relative to shader root)
+        std::string              path;         // project-relative source path
+        std::vector<std::string> includes;     // project-relative, sorted, unique
+        uint32_t                 variantCount = 0;
+        double                   avgCompileMs = 0.0; // per variant; 0 = never measured
+        uint64_t                 inputsHash   = 0;   // source, includes and build settings; 0 = unknown
+    };
+
+    struct DependencyImpact
+    {
+        std::vector<const DependencyGraphNode*> shaders;
+
+        uint64_t variants        = 0;
+        uint64_t untimedVariants = 0; // variants of shaders without a measured compile time
+        double   estimatedMs     = 0.0;
+    };
+
+    class DependencyGraph
+    {
+    public:
+        // Inserts or replaces the node with the same virtualPath.
+        void setShader(DependencyGraphNode node);
+
+        const DependencyGraphNode*              findShader(const std::string& virtualPath) const;
+        const std::vector<DependencyGraphNode>& shaders() const { return m_Shaders; }
+
+        // Project root the recorded paths are relative to; empty if unknown.
+        void               setProjectRoot(std::string root) { m_ProjectRoot = std::move(root); }
+        const std::string& projectRoot() const { return m_ProjectRoot; }
+
+        // All distinct include paths, sorted.
+        std::vector<std::string> includeFiles() const;
+
+        // Shaders that rebuild when the given project-relative file changes
+        // (the file may be an include or a shader source itself).
+        DependencyImpact impactOf(const std::string& path) const;
+
+        Result<void>                   save(const std::string& filePath) const;
+        static Result<DependencyGraph> load(const std::string& filePath);
+
+    private:
+        std::string                      m_ProjectRoot;
+        std::vector<DependencyGraphNode> m_Shaders;
+    };
+
+    std::string dependency_graph_path(const std::string& cacheDir);
+} // namespace vshadersystem
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+
+namespace vshadersystem
+{
+    // ------------------------------------------------------------
+    // Executor
+    //
+    // Where the library's parallel and async APIs run their work (batch
+    // builds, entry decoding, SPIR-V validation). A host with its own job
+    // system implements it, so shader work runs on the host's workers at the
+    // priorities it picks instead of on a second set of threads competing for
+    // the same cores. ThreadPool is the default implementation.
+    //
+    // Tasks never wait on other tasks, so an executor may run them in any
+    // order and on any thread, including the submitting one.
+    // ------------------------------------------------------------
+
+    enum class TaskPriority : uint8_t
+    {
+        eHigh   = 0,
+        eNormal = 1,
+        eLow    = 2,
+    };
+
+    inline constexpr size_t kTaskPriorityCount = 3;
+
+    class Executor
+    {
+    public:
+        virtual ~Executor() = default;
+
+        virtual void submit(std::function<void()> task, TaskPriority priority) = 0;
+
+        // Tasks the executor runs at once; batch APIs use it to size their windows.
+        virtual uint32_t concurrency() const = 0;
+
+        void submit(std::function<void()> task) { submit(std::move(task), TaskPriority::eNormal); }
+    };
+
+    // ------------------------------------------------------------
+    // TaskGroup
+    //
+    // Tasks submitted through one executor that a caller can wait for, without
+    // waiting for everything else the executor runs. wait() blocks the calling
+    // thread, so do not call it from a task of the same executor.
+    // ------------------------------------------------------------
+    class TaskGroup
+    {
+    public:
+        explicit TaskGroup(Executor& executor, TaskPriority priority = TaskPriority::eNormal) :
+            m_Executor(executor), m_Priority(priority)
+        {}
+        ~TaskGroup() { wait(); }
+
+        TaskGroup(const TaskGroup&)            = delete;
+        TaskGroup& operator=(const TaskGroup&) = delete;
+
+        void run(std::function<void()> task);
+        void wait();
+
+        Executor&    executor() const { return m_Executor; }
+        TaskPriority priority() const { return m_Priority; }
+
+    private:
+        Executor&               m_Executor;
+        TaskPriority            m_Priority;
+        std::mutex              m_Mutex;
+        std::condition_variable m_Done;
+        size_t                  m_Pending = 0;
+    };
+} // namespace vshadersystem
@@ -7,6 +7,7 @@
 #include <string>
 #include <string_view>
 #include <unordered_map>
+#include <vector>
 
 namespace vshadersystem
 {
@@ -35,6 +36,40 @@ namespace vshadersystem
         std::unordered_map<std::string, const KeywordDecl*> decls;
     };
 
+    // Parsed expression tree. Nodes are stored flat; children are indices into nodes.
+    // Identifiers are kept unresolved so the same tree can be evaluated against a single
+    // variant (eval_only_if) or compiled into a library query (keyword_query.hpp).
+    struct KeywordExprNode
+    {
+        enum class Op : uint8_t
+        {
+            eIdent,  // text
+            eNumber, // number
+            eBool,   // value of a parenthesized expression: lhs != 0
+            eEq,     // lhs == rhs
+            eNotEq,  // lhs != rhs
+            eAnd,    // lhs && rhs
+            eOr,     // lhs || rhs
+        };
+
+        Op          op = Op::eNumber;
+        std::string text;
+        uint32_t    number = 0;
+        uint32_t    lhs    = 0;
+        uint32_t    rhs    = 0;
+    };
+
+    struct KeywordExpr
+    {
+        std::vector<KeywordExprNode> nodes;
+        uint32_t                     root  = 0;
+        bool                         empty = true; // empty constraint, always true
+    };
+
+    // Parse an only_if(...) constraint.
+    // The input may be either "only_if(<expr>)" or just "<expr>".
+    Result<KeywordExpr> parse_keyword_expr(std::string_view constraint);
+
     // Parse and evaluate an only_if(...) constraint.
     // The input may be either "only_if(<expr>)" or just "<expr>".
     Result<bool> eval_only_if(std::string_view constraint, const KeywordValueContext& ctx);
@@ -0,0 +1,71 @@
+#pragma once
+
+#include "vshadersystem/library.hpp"
+#include "vshadersystem/result.hpp"
+#include "vshadersystem/types.hpp"
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace vshadersystem
+{
+    // ------------------------------------------------------------
+    // Keyword predicate queries over a .vshlib
+    //
+    // Selects library entries by their permutation keyword values without
+    // decoding any blob, e.g. "all fragment variants of base.frag where
+    // VTX_HAS_NORMAL==1".
+    //
+    // Predicates use the only_if grammar (keyword_expr.hpp). Identifiers
+    // resolve to keyword fields of the library, enumerants of the keyword
+    // they are compared with, or true/false. A comparison only matches
+    // entries that declare the keyword, so "K==0" and "K!=1" both skip
+    // shaders without K.
+    //
+    // Compilation lowers each comparison to (word & mask) == expect tests on
+    // the column-major KWBS words; evaluation produces one bit per entry and
+    // combines the bit vectors with and/or/not. The column tests use SSE2
+    // when available.
+    // ------------------------------------------------------------
+
+    struct KeywordQueryOp
+    {
+        enum class Kind : uint8_t
+        {
+            eMatch, // push: (words[word] & mask) == expect
+            eTrue,  // push: all entries
+            eFalse, // push: no entries
+            eNot,   // pop a, push ~a
+            eAnd,   // pop b, a, push a & b
+            eOr,    // pop b, a, push a | b
+        };
+
+        Kind     kind   = Kind::eTrue;
+        uint32_t word   = 0;
+        uint32_t mask   = 0;
+        uint32_t expect = 0;
+    };
+
+    // Postfix program; an empty predicate compiles to a single eTrue.
+    struct KeywordQuery
+    {
+        std::vector<KeywordQueryOp> ops;
+    };
+
+    struct KeywordQueryFilter
+    {
+        uint64_t    shaderIdHash = 0;                    // 0 = any shader (see shader_id_hash)
+        ShaderStage stage        = ShaderStage::eUnknown; // eUnknown = any stage
+    };
+
+    Result<KeywordQuery> compile_keyword_query(std::string_view predicate, const KeywordBitsets& bitsets);
+
+    // Returns matching indices into lib.entries in ascending order.
+    std::vector<uint32_t>
+    run_keyword_query(const ShaderLibrary& lib, const KeywordQuery& query, const KeywordQueryFilter& filter = {});
+
+    // compile_keyword_query + run_keyword_query.
+    Result<std::vector<uint32_t>>
+    query_vshlib(const ShaderLibrary& lib, std::string_view predicate, const KeywordQueryFilter& filter = {});
+} // namespace vshadersystem
@@ -47,4 +47,15 @@ namespace vshadersystem
         // Example: "only_if(SURFACE==CUTOUT)"
         std::string constraint;
     };
+
+    // Resolved value of one permutation keyword in a compiled variant.
+    struct KeywordValue
+    {
+        std::string      name;
+        KeywordValueKind kind  = KeywordValueKind::eBool;
+        uint32_t         value = 0;
+
+        // Enum values (only used when kind == eEnum), so the value can be matched by name.
+        std::vector<std::string> enumValues;
+    };
 } // namespace vshadersystem
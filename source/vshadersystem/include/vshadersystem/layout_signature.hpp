@@ -0,0 +1,35 @@
+#pragma once
+
+#include "vshadersystem/types.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace vshadersystem
+{
+    // ------------------------------------------------------------
+    // Descriptor layout signatures
+    //
+    // Canonical 64-bit hashes of what a Vulkan-style renderer turns into
+    // descriptor set layouts and pipeline layouts. Two shaders with equal
+    // set signatures can share descriptor sets for that set index; equal
+    // pipeline signatures mean the whole pipeline layout is compatible.
+    //
+    // A set signature covers, per binding (sorted by binding number):
+    //   binding, DescriptorKind, count, runtimeSized, stageFlags
+    //
+    // A pipeline signature covers every set signature from set 0 to the
+    // highest used set (unused sets hash as 0) plus all push-constant
+    // ranges (size, stageFlags).
+    //
+    // Resource names are ignored on purpose.
+    // ------------------------------------------------------------
+
+    // 0 when the set has no bindings.
+    uint64_t descriptor_set_signature(const ShaderReflection& refl, uint32_t set);
+
+    // Per-set signatures indexed by set number, up to the highest set with bindings.
+    std::vector<uint64_t> descriptor_set_signatures(const ShaderReflection& refl);
+
+    uint64_t pipeline_layout_signature(const ShaderReflection& refl);
+} // namespace vshadersystem
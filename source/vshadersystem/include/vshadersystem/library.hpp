@@ -1,10 +1,13 @@
 #pragma once
 
+#include "vshadersystem/binary.hpp"
 #include "vshadersystem/result.hpp"
 #include "vshadersystem/types.hpp"
 
 #include <cstdint>
+#include <span>
 #include <string>
+#include <string_view>
 #include <vector>
 
 namespace vshadersystem
@@ -16,11 +19,11 @@ namespace vshadersystem
     // - packaging many precompiled shader binaries (typically .vshbin)
     // - mapping them by a 64-bit key hash (e.g., VariantKey hash)
     //
-    // File format (version 2):
+    // File format (version 3; version 2 files are still readable):
     //
-    // Header (fixed 48 bytes):
+    // Header (fixed 72 bytes; 56 bytes in version 2, without extOffset/extSize):
     // - magic[8]       : "VSHLIB\0\0"
-    // - version u32    : 1
+    // - version u32    : 3
     // - flags u32      : reserved
     // - entryCount u32 : number of entries
     // - reserved u32   : reserved
@@ -28,54 +31,238 @@ namespace vshadersystem
     // - tocSize u64        : size of TOC bytes
     // - keywordsOffset u64 : optional engine_keywords.vkw bytes offset (0 if absent)
     // - keywordsSize u64   : optional engine_keywords.vkw bytes size
+    // - extOffset u64      : optional extension chunks offset (0 if absent)
+    // - extSize u64        : extension chunks size
     //
     // TOC (table of contents):
     // - entryCount * Entry
     // Entry:
-    // - keyHash  u64
-    // - stage    u8   (ShaderStage)
-    // - reserved u8[7]
-    // - offset   u64  (blob offset)
-    // - size     u64  (blob size)
+    // - keyHash     u64
+    // - stage       u8   (ShaderStage)
+    // - reserved    u8[3]
+    // - layoutClass u32  (pipeline layout compatibility class, 0 = unknown; always 0 in version 2)
+    // - offset      u64  (blob offset)
+    // - size        u64  (blob size)
     //
     // Blobs:
     // - raw bytes for each shader binary (commonly .vshbin)
+    //
+    // Extension chunks (tag u32, size u32, payload), unknown tags are skipped:
+    // - LAYC : layout compatibility classes
+    //     setLayoutCount u32, setLayoutCount * signature u64
+    //     layoutClassCount u32, layoutClassCount * {signature u64, setCount u32, setCount * setLayout u32}
+    //   Set layout and layout class ids are 1-based indices into these arrays; 0 means "unused/unknown".
+    // - KWBS : permutation keyword bitsets (see KeywordBitsets), rows in TOC order
+    //     entryCount u32, wordCount u32, fieldCount u32
+    //     fieldCount * {name string, kind u8, word u32, shift u8, width u8, enumCount u32, enum strings}
+    //     entryCount * shaderIdHash u64
+    //     wordCount * entryCount * u32 (column-major)
+    // - HGRP : ray tracing hit groups (see ShaderLibraryHitGroup), sorted by name
+    //     groupCount u32, groupCount * {name string, type u8, closestHit u64, anyHit u64, intersection u64,
+    //                                   recordSize u32, memberCount u32, memberCount * {name string, offset u32,
+    //                                   size u32, type u8}}
+    // - PROF : keyword profiles of a multi-profile build (see ShaderLibraryProfile)
+    //     profileCount u32, profileCount * {name string, vkwSize u32, vkw bytes}
+    //     entryCount u32, entryCount * profileMask u64 (TOC order)
     // ------------------------------------------------------------
 
     struct ShaderLibraryEntry
     {
         uint64_t             keyHash = 0;
         ShaderStage          stage   = ShaderStage::eUnknown;
-        std::vector<uint8_t> blob; // typically a .vshbin payload
+        std::vector<uint8_t> blob;            // typically a .vshbin payload
+        uint64_t             profileMask = 0; // bit i = member of profile i; only written with profiles
+    };
+
+    // Non-owning entry, for blobs that already live elsewhere (another library, a mapped file).
+    struct ShaderLibraryEntryView
+    {
+        uint64_t                 keyHash = 0;
+        ShaderStage              stage   = ShaderStage::eUnknown;
+        std::span<const uint8_t> blob;
+        uint64_t                 profileMask = 0;
+    };
+
+    // One engine keyword profile (e.g. desktop-high, handheld) of a library built for several.
+    // Each entry records the profiles whose variant set contains it.
+    struct ShaderLibraryProfile
+    {
+        std::string          name;
+        std::vector<uint8_t> engineKeywordsVkw; // the profile's .vkw bytes
     };
 
+    inline constexpr size_t kMaxLibraryProfiles = 64;
+
     struct ShaderLibraryTOCEntry
     {
-        uint64_t    keyHash = 0;
-        ShaderStage stage   = ShaderStage::eUnknown;
-        uint64_t    offset  = 0;
-        uint64_t    size    = 0;
+        uint64_t    keyHash     = 0;
+        ShaderStage stage       = ShaderStage::eUnknown;
+        uint32_t    layoutClass = 0; // entries with equal non-zero classes share a pipeline layout
+        uint64_t    offset      = 0;
+        uint64_t    size        = 0;
+    };
+
+    // Descriptor set layouts of one pipeline layout class, indexed by set number.
+    // setLayouts[set] is a 1-based set layout id (0 = set unused); equal ids mean the
+    // descriptor set bound at that index can be kept across a pipeline switch.
+    struct ShaderLibraryLayoutClass
+    {
+        uint64_t              signature = 0; // pipeline_layout_signature()
+        std::vector<uint32_t> setLayouts;
+    };
+
+    // One permutation keyword packed into a bitset word:
+    // bit `shift` is set when the entry declares the keyword, the value occupies the `width` bits above it.
+    // Enum values are re-indexed into the library-wide enumValues list.
+    struct KeywordBitField
+    {
+        std::string              name;
+        KeywordValueKind         kind = KeywordValueKind::eBool;
+        std::vector<std::string> enumValues;
+
+        uint32_t word  = 0;
+        uint8_t  shift = 0;
+        uint8_t  width = 1;
+    };
+
+    // Per-entry permutation keyword values of a library, stored column-major so that a predicate
+    // over one keyword scans a single contiguous u32 array (see keyword_query.hpp).
+    struct KeywordBitsets
+    {
+        std::vector<KeywordBitField> fields;
+        uint32_t                     entryCount = 0;
+        uint32_t                     wordCount  = 0;
+        std::vector<uint64_t>        shaderIdHashes; // [entry], 0 when the blob is not a .vshbin
+        std::vector<uint32_t>        words;          // [word * entryCount + entry]
+
+        const KeywordBitField* find(std::string_view name) const;
+
+        // False when the entry does not declare the keyword.
+        bool get(uint32_t entry, const KeywordBitField& field, uint32_t& outValue) const;
+    };
+
+    enum class HitGroupType : uint8_t
+    {
+        eTriangles = 0,
+        eProcedural // has an intersection shader
+    };
+
+    // A hit group assembled from the entries whose .vshbin declares `#pragma vultra hit_group <name>`.
+    // Members are shader id hashes (0 = unused); pick their variants with VariantKey as for any other
+    // entry. The shader record layout is the shaderRecordEXT block of the members (every member that
+    // declares one must declare the same layout), so an SBT record is the group handle followed by
+    // recordSize bytes written at the reflected member offsets.
+    struct ShaderLibraryHitGroup
+    {
+        std::string  name;
+        HitGroupType type = HitGroupType::eTriangles;
+
+        uint64_t closestHit   = 0;
+        uint64_t anyHit       = 0;
+        uint64_t intersection = 0;
+
+        uint32_t                 recordSize = 0; // 0 = no shader record data
+        std::vector<BlockMember> recordMembers;
     };
 
     struct ShaderLibrary
     {
         std::vector<ShaderLibraryTOCEntry> entries;
         std::vector<uint8_t>               blobData;          // concatenated blob storage
+        uint64_t                           blobOffset = 0;    // file offset of blobData[0]
         std::vector<uint8_t>               engineKeywordsVkw; // optional raw bytes
+
+        std::vector<uint64_t>                 setLayoutSignatures; // [setLayout - 1]
+        std::vector<ShaderLibraryLayoutClass> layoutClasses;       // [layoutClass - 1]
+
+        KeywordBitsets keywordBitsets; // empty for libraries written before KWBS
+
+        std::vector<ShaderLibraryHitGroup> hitGroups; // sorted by name
+
+        std::vector<ShaderLibraryProfile> profiles;
+        std::vector<uint64_t>             profileMasks; // [entry], empty when the library has no profiles
     };
 
-    Result<void> write_vslib(const std::string&                     filePath,
-                             const std::vector<ShaderLibraryEntry>& entries,
-                             const std::vector<uint8_t>*            engineKeywordsVkw = nullptr);
+    // With profiles (at most kMaxLibraryProfiles), each entry's profileMask is stored in a PROF chunk.
+    Result<void> write_vslib(const std::string&                       filePath,
+                             const std::vector<ShaderLibraryEntry>&   entries,
+                             const std::vector<uint8_t>*              engineKeywordsVkw = nullptr,
+                             const std::vector<ShaderLibraryProfile>* profiles          = nullptr);
 
     inline Result<void> write_vslib(const std::string& filePath, const std::vector<ShaderLibraryEntry>& entries)
     {
         return write_vslib(filePath, entries, nullptr);
     }
 
+    // Same as above; blobs are streamed from the views without being copied.
+    Result<void> write_vslib(const std::string&                       filePath,
+                             std::span<const ShaderLibraryEntryView>  entries,
+                             const std::vector<uint8_t>*              engineKeywordsVkw = nullptr,
+                             const std::vector<ShaderLibraryProfile>* profiles          = nullptr);
+
+    // ------------------------------------------------------------
+    // ShaderLibraryWriter
+    //
+    // Writes a .vshlib without holding blobs in memory, for packing large numbers of
+    // .vshbin files. add() keeps only what the TOC and extension chunks need; write()
+    // copies each blob from its file into the output through a fixed-size buffer.
+    // ------------------------------------------------------------
+    class ShaderLibraryWriter
+    {
+    public:
+        // info is peek_vshbin_file(blobPath); the blob must not change before write().
+        void add(uint64_t keyHash, ShaderStage stage, std::string blobPath, const ShaderBinaryInfo& info);
+
+        size_t entryCount() const { return m_Entries.size(); }
+
+        Result<void> write(const std::string&          filePath,
+                           const std::vector<uint8_t>* engineKeywordsVkw = nullptr,
+                           size_t                      bufferSize        = 1u << 20) const;
+
+    private:
+        struct Entry
+        {
+            uint64_t                  keyHash = 0;
+            ShaderStage               stage   = ShaderStage::eUnknown;
+            std::string               blobPath;
+            uint64_t                  blobSize        = 0;
+            uint64_t                  layoutSignature = 0;
+            std::vector<uint64_t>     setSignatures;
+            uint64_t                  shaderIdHash = 0;
+            std::vector<KeywordValue> keywordValues;
+            std::vector<std::string>  hitGroups;
+            BlockLayout               shaderRecord; // size 0 = none
+        };
+
+        std::vector<Entry> m_Entries;
+    };
+
     // Read the library file and return TOC + blob data.
     Result<ShaderLibrary> read_vshlib_file(const std::string& filePath);
 
-    // Find a shader blob by (keyHash, stage). Returns empty span if not found.
+    // Entry with this (keyHash, stage), nullptr if absent. Binary search: writers sort the TOC by (keyHash, stage).
+    const ShaderLibraryTOCEntry* find_vshlib_entry(const ShaderLibrary& lib, uint64_t keyHash, ShaderStage stage);
+
+    // Find a shader blob by (keyHash, stage) and return a copy of it.
     Result<std::vector<uint8_t>> extract_vshlib_blob(const ShaderLibrary& lib, uint64_t keyHash, ShaderStage stage);
+
+    // Find a shader blob by (keyHash, stage) without copying. Returns an empty span if not found;
+    // the span points into lib.blobData.
+    std::span<const uint8_t> find_vshlib_blob(const ShaderLibrary& lib, uint64_t keyHash, ShaderStage stage);
+
+    // Set layout id used by a layout class at the given set index, 0 if unused or unknown.
+    uint32_t vshlib_set_layout(const ShaderLibrary& lib, uint32_t layoutClass, uint32_t set);
+
+    // Index of the profile with this name, -1 if absent.
+    int32_t find_vshlib_profile(const ShaderLibrary& lib, std::string_view name);
+
+    // True when the entry belongs to the profile; always true for libraries without profiles.
+    bool vshlib_entry_in_profile(const ShaderLibrary& lib, size_t entry, uint32_t profile);
+
+    // Hit group by name, nullptr if the library has none of that name.
+    const ShaderLibraryHitGroup* find_vshlib_hit_group(const ShaderLibrary& lib, std::string_view name);
+
+    // Size of one SBT record of the group: the shader group handle plus its record data, rounded up to
+    // shaderGroupHandleAlignment (a power of two).
+    uint32_t hit_group_record_stride(const ShaderLibraryHitGroup& group, uint32_t handleSize, uint32_t handleAlignment);
 } // namespace vshadersystem
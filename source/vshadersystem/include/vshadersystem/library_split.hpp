@@ -0,0 +1,119 @@
+#pragma once
+
+#include "vshadersystem/library.hpp"
+#include "vshadersystem/result.hpp"
+
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace vshadersystem
+{
+    // ------------------------------------------------------------
+    // Library partitioning
+    //
+    // Splits one set of library entries into several .vshlib files so a streaming
+    // runtime can open only the shaders a level or render pass needs:
+    //
+    //   <base>.<partition>.vshlib   one library per partition
+    //   <base>.vshroute             routing index: shaderIdHash -> partitions
+    //
+    // Entries are assigned by shader id groups (from the command line or a usage
+    // manifest), then optionally split further by the value of one permutation
+    // keyword. Layout classes, keyword bitsets and hit groups are rebuilt per
+    // partition, so members of one hit group should share a group. Profiles of a
+    // multi-profile library are kept in every partition, with each entry's mask.
+    //
+    // Usage manifest format (one shader id per line, '#' starts a comment):
+    //   [forest]
+    //   terrain.vert
+    //   terrain.frag
+    //   [city]
+    //   pbr.frag
+    // ------------------------------------------------------------
+
+    struct ShaderGroup
+    {
+        std::string              name;
+        std::vector<std::string> shaderIds; // e.g. "pbr.frag" (see shader_id.hpp)
+    };
+
+    struct LibraryPartitionPlan
+    {
+        std::vector<ShaderGroup> groups;
+
+        // Optional permutation keyword: entries declaring it move to "<partition>.<value>".
+        // Two partitions ending up with one name (e.g. group "a.x" and group "a" split by x) is an error.
+        std::string keyword;
+
+        std::string defaultPartition = "common"; // entries of shaders no group lists
+        std::string sharedPartition  = "shared"; // shaders listed by more than one group, stored once
+    };
+
+    struct LibraryPartition
+    {
+        std::string                         name;
+        std::vector<ShaderLibraryEntryView> entries;
+        std::vector<uint64_t>               shaderIdHashes; // shaders with entries here, sorted, unique
+    };
+
+    Result<std::vector<ShaderGroup>> load_partition_manifest(const std::string& filePath);
+
+    // Partitions in group order, then the default and shared partitions; empty partitions are dropped.
+    // Entry views keep pointing at the caller's blobs.
+    Result<std::vector<LibraryPartition>> partition_library_entries(std::span<const ShaderLibraryEntryView> entries,
+                                                                    const LibraryPartitionPlan&             plan);
+
+    // ------------------------------------------------------------
+    // Routing index (.vshroute)
+    //
+    // Text format (one record per line, tab separated):
+    //   vshroute <version>
+    //   P <name> <file>                       partition library, relative to the index
+    //   R <shaderIdHash hex> <partition>...   0-based P record indices
+    // ------------------------------------------------------------
+
+    struct LibraryRoute
+    {
+        uint64_t              shaderIdHash = 0;
+        std::vector<uint32_t> partitions; // sorted
+    };
+
+    class LibraryRoutingIndex
+    {
+    public:
+        struct Partition
+        {
+            std::string name;
+            std::string file;
+        };
+
+        uint32_t addPartition(std::string name, std::string file);
+        void     addRoute(uint64_t shaderIdHash, uint32_t partition);
+
+        const std::vector<Partition>& partitions() const { return m_Partitions; }
+
+        // Nullptr if no partition holds the shader.
+        const LibraryRoute* find(uint64_t shaderIdHash) const;
+
+        // Sorted, unique partitions holding any of the shaders.
+        std::vector<uint32_t> partitionsFor(std::span<const uint64_t> shaderIdHashes) const;
+
+        Result<void>                       save(const std::string& filePath) const;
+        static Result<LibraryRoutingIndex> load(const std::string& filePath);
+
+    private:
+        std::vector<Partition>    m_Partitions;
+        std::vector<LibraryRoute> m_Routes; // sorted by shaderIdHash
+    };
+
+    // Writes <outDir>/<baseName>.<partition>.vshlib for each partition and <outDir>/<baseName>.vshroute.
+    // With profiles, every partition gets a PROF chunk from the entries' profileMask.
+    Result<LibraryRoutingIndex>
+    write_library_partitions(const std::vector<LibraryPartition>&     partitions,
+                             const std::string&                       outDir,
+                             const std::string&                       baseName,
+                             const std::vector<uint8_t>*              engineKeywords = nullptr,
+                             const std::vector<ShaderLibraryProfile>* profiles       = nullptr);
+} // namespace vshadersystem
@@ -0,0 +1,80 @@
+#pragma once
+
+#include "vshadersystem/compiler.hpp"
+#include "vshadersystem/result.hpp"
+#include "vshadersystem/types.hpp"
+
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace vshadersystem
+{
+    // ------------------------------------------------------------
+    // Link modules (experimental)
+    //
+    // Shared include modules (lighting, BRDF, ...) compiled once into linkable SPIR-V
+    // and linked into every variant, instead of being compiled from source by each one.
+    // A module is an ordinary include whose function bodies are hidden behind
+    // VSS_LINK_MODULES, so shaders keep including it either way:
+    //
+    //   vec3 brdf_ggx(vec3 n, vec3 v, vec3 l, float roughness);
+    //   #ifndef VSS_LINK_MODULES
+    //   vec3 brdf_ggx(vec3 n, vec3 v, vec3 l, float roughness) { ... }
+    //   #endif
+    //
+    // Variants are compiled with VSS_LINK_MODULES defined (prototypes become imports),
+    // the module without it (bodies become exports), and the SPIRV-Tools linker joins them.
+    // Modules see no variant defines and should only hold functions: resources declared
+    // in a module would be duplicated in the linked shader.
+    //
+    // Requires a build with the vshadersystem_spirv_tools option.
+    // ------------------------------------------------------------
+
+    inline constexpr const char* kLinkModulesDefine = "VSS_LINK_MODULES";
+
+    // False when vshadersystem was built without SPIRV-Tools.
+    bool spirv_linking_available();
+
+    struct LinkModule
+    {
+        std::string           path;
+        uint64_t              hash = 0; // module text + resolved includes; folded into variant cache keys
+        std::vector<uint32_t> spirv;    // compile-only module with exported functions
+        double                compileMs = 0.0;
+    };
+
+    // Compiles each module once per (content hash, stage, include dirs) and shares the result
+    // between all variants of a build. Thread-safe: a module compiles outside the cache lock, so
+    // only requests for that same module wait for it. Module sources and their includes are read
+    // through an IncludeCache, revalidated by size + mtime instead of reread on every request.
+    class LinkModuleCache
+    {
+    public:
+        using ModuleResult = Result<std::shared_ptr<const LinkModule>>;
+
+        ModuleResult get(const std::string& path, ShaderStage stage, const std::vector<std::string>& includeDirs);
+
+        // Modules compiled so far and their total compile time.
+        size_t compiledCount() const;
+        double totalCompileMs() const;
+
+    private:
+        IncludeCache                                                   m_Files;
+        mutable std::mutex                                             m_Mutex;
+        std::unordered_map<uint64_t, std::shared_future<ModuleResult>> m_Modules; // first request compiles
+        size_t                                                         m_Compiled       = 0;
+        double                                                         m_TotalCompileMs = 0.0;
+    };
+
+    // Links a compile-only shader module with its modules. Every import must be resolved;
+    // the result carries no Linkage capability and is ready for reflection. spirvVersion is
+    // CompileOptions::spirvVersion and picks the Vulkan environment the linker validates against.
+    Result<std::vector<uint32_t>> link_spirv_modules(const std::vector<uint32_t>&                          shader,
+                                                     const std::vector<std::shared_ptr<const LinkModule>>& modules,
+                                                     int spirvVersion = 0);
+} // namespace vshadersystem
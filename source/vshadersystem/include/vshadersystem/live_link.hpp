@@ -0,0 +1,154 @@
+#pragma once
+
+#include "vshadersystem/library.hpp"
+#include "vshadersystem/result.hpp"
+#include "vshadersystem/types.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <span>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace vshadersystem
+{
+    // ------------------------------------------------------------
+    // Live link
+    //
+    // Streams freshly compiled .vshbin payloads from `vshaderc watch --live`
+    // to running processes over a Unix domain socket, so an edited shader
+    // reaches the screen without writing and re-reading a library.
+    //
+    // Stream format (little-endian):
+    //   hello   : magic "VSLL", version u32            (server -> client, once)
+    //   message : size u32, kind u8, stage u8, reserved u16,
+    //             keyHash u64, shaderIdHash u64, payload[size - 20]
+    //
+    // A rebuild sends its binaries and errors followed by an eCommit message;
+    // receivers only hand out complete batches, so the stages and variants of
+    // one edit are swapped in together.
+    // ------------------------------------------------------------
+
+    inline constexpr uint32_t kLiveLinkVersion = 1;
+
+    enum class LiveLinkMessageKind : uint8_t
+    {
+        eBinary = 1, // payload: .vshbin of (keyHash, stage)
+        eError  = 2, // payload: UTF-8 compile log of shaderIdHash
+        eCommit = 3, // end of a rebuild batch, no payload
+    };
+
+    struct LiveLinkMessage
+    {
+        LiveLinkMessageKind  kind         = LiveLinkMessageKind::eBinary;
+        ShaderStage          stage        = ShaderStage::eUnknown;
+        uint64_t             keyHash      = 0;
+        uint64_t             shaderIdHash = 0;
+        std::vector<uint8_t> payload;
+    };
+
+    // Tool side. Single-threaded: accept and publish from the same thread.
+    class LiveLinkServer
+    {
+    public:
+        LiveLinkServer() = default;
+        ~LiveLinkServer();
+
+        LiveLinkServer(const LiveLinkServer&)            = delete;
+        LiveLinkServer& operator=(const LiveLinkServer&) = delete;
+
+        // Binds and listens on socketPath, replacing a stale socket file left by a previous run.
+        Result<void> open(const std::string& socketPath);
+        void         close();
+
+        // Accepts pending connections without blocking. New clients first receive every binary published
+        // so far (latest per key) and a commit, so a restarted editor catches up with the session's edits.
+        // Returns the number of clients accepted.
+        size_t accept();
+
+        // Sends to every client. Clients that fail or stall for more than a few seconds are dropped.
+        void publish(const LiveLinkMessage& message);
+        void commit();
+
+        size_t clientCount() const { return m_Clients.size(); }
+
+    private:
+        bool sendTo(intptr_t client, const std::vector<uint8_t>& frame);
+
+        intptr_t                                                         m_Listener = -1;
+        std::string                                                      m_Path;
+        std::vector<intptr_t>                                            m_Clients;
+        std::map<std::pair<uint64_t, ShaderStage>, std::vector<uint8_t>> m_Replay; // (keyHash, stage) -> binary frame
+    };
+
+    // Runtime side. A background thread reads the stream; poll() is called from the host's thread.
+    class LiveLinkReceiver
+    {
+    public:
+        LiveLinkReceiver() = default;
+        ~LiveLinkReceiver();
+
+        LiveLinkReceiver(const LiveLinkReceiver&)            = delete;
+        LiveLinkReceiver& operator=(const LiveLinkReceiver&) = delete;
+
+        // Fails with eIO when nothing listens on socketPath. Does not wait for the server: the hello is
+        // checked by the reader thread, which drops a connection of another version.
+        Result<void> connect(const std::string& socketPath);
+        void         disconnect();
+
+        // False once the server closed the connection; connect() again to resume.
+        bool connected() const { return m_Connected.load(); }
+
+        // Messages of every batch committed since the last call, in arrival order, without the commits.
+        std::vector<LiveLinkMessage> poll();
+
+    private:
+        void readLoop();
+
+        intptr_t                     m_Socket = -1;
+        std::thread                  m_Thread;
+        std::atomic<bool>            m_Connected = false;
+        std::mutex                   m_Mutex;
+        std::vector<LiveLinkMessage> m_Pending;   // current batch, not committed yet (reader thread only)
+        std::deque<LiveLinkMessage>  m_Committed; // guarded by m_Mutex
+    };
+
+    // ------------------------------------------------------------
+    // ShaderLibraryOverlay
+    //
+    // In-memory entries layered over a loaded library: lookups check the
+    // overlay first, so live-linked binaries replace library entries (or add
+    // variants the library does not have) without touching the file.
+    // ------------------------------------------------------------
+    class ShaderLibraryOverlay
+    {
+    public:
+        // The base library must outlive the overlay; null means overlay entries only.
+        explicit ShaderLibraryOverlay(const ShaderLibrary* base = nullptr) : m_Base(base) {}
+
+        void setBase(const ShaderLibrary* base) { m_Base = base; }
+
+        void insert(uint64_t keyHash, ShaderStage stage, std::vector<uint8_t> blob);
+
+        // Inserts the binaries among messages; returns how many.
+        size_t apply(std::span<const LiveLinkMessage> messages);
+
+        // Empty span if neither the overlay nor the base has the entry.
+        std::span<const uint8_t> findBlob(uint64_t keyHash, ShaderStage stage) const;
+        Result<ShaderBinary>     read(uint64_t keyHash, ShaderStage stage) const;
+
+        bool overrides(uint64_t keyHash, ShaderStage stage) const;
+
+        size_t size() const { return m_Entries.size(); }
+        void   clear() { m_Entries.clear(); }
+
+    private:
+        const ShaderLibrary*                                             m_Base = nullptr;
+        std::map<std::pair<uint64_t, ShaderStage>, std::vector<uint8_t>> m_Entries; // (keyHash, stage) -> .vshbin
+    };
+} // namespace vshadersystem
@@ -0,0 +1,39 @@
+#pragma once
+
+#include "vshadersystem/types.hpp"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace vshadersystem
+{
+    // ------------------------------------------------------------
+    // Material block layout analysis
+    //
+    // Measures how much of a std140 Material block is padding and how small
+    // it could be with a different member order or with scalar block layout
+    // (GL_EXT_scalar_block_layout). Member alignment follows std140:
+    //
+    //   4-byte scalars  : align 4
+    //   vec2            : align 8
+    //   vec3 / vec4     : align 16
+    //   matrices/arrays : align 16 (reflected size is kept as-is)
+    //
+    // The block itself is rounded up to 16 bytes.
+    // ------------------------------------------------------------
+
+    struct MaterialLayoutReport
+    {
+        uint32_t declaredSize  = 0; // materialParamSize as reflected
+        uint32_t payloadBytes  = 0; // bytes the members actually need (scalar sizes)
+        uint32_t paddingBytes  = 0; // declaredSize - payloadBytes
+        uint32_t optimizedSize = 0; // std140 size with suggestedOrder
+        uint32_t scalarSize    = 0; // size with scalar block layout, declaration order
+
+        // Member names in a tighter std140 order. Empty when the declared order is already optimal.
+        std::vector<std::string> suggestedOrder;
+    };
+
+    MaterialLayoutReport analyze_material_layout(const MaterialDescription& mdesc);
+} // namespace vshadersystem
@@ -0,0 +1,91 @@
+#pragma once
+
+#include "vshadersystem/types.hpp"
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace vshadersystem
+{
+    // ------------------------------------------------------------
+    // GPU-driven material parameter pool
+    //
+    // All material instances live in one storage buffer of 32-bit words. Each
+    // instance occupies a block with the std140 layout of its Material block
+    // (the reflected MaterialParamDesc offsets), starting at a 16-byte aligned
+    // byte offset that a material table entry points at, as in
+    // examples/keywords/shaders/include/common/gpu_scene.glsl:
+    //
+    //   struct MaterialEntry { uint model; uint blockOffsetBytes; ... };
+    //   s_Materials.materials[]  : MaterialEntry table
+    //   s_MaterialParams.words[] : the pool
+    //
+    // generate_material_pool_glsl() writes the shader side (one decode function
+    // per parameter), MaterialParameterPool packs the host side.
+    // ------------------------------------------------------------
+
+    struct MaterialPoolGlslOptions
+    {
+        // Function name prefix, e.g. "pbr_frag" -> pbr_frag_baseColor(materialIndex).
+        std::string prefix = "material";
+
+        // Expressions the generated code reads from; the defaults match gpu_scene.glsl.
+        std::string tableExpr       = "s_Materials.materials";
+        std::string blockOffsetExpr = "blockOffsetBytes";
+        std::string poolWordsExpr   = "s_MaterialParams.words";
+
+        // Shown in the header comment.
+        std::string sourceName;
+    };
+
+    // Turns a shader id such as "pbr.frag" into an identifier prefix ("pbr_frag").
+    std::string material_pool_prefix(std::string_view shaderId);
+
+    std::string generate_material_pool_glsl(const MaterialDescription& mdesc, const MaterialPoolGlslOptions& opt);
+
+    // Parameter values of one material, stored as its std140 Material block.
+    // Starts from the parameter defaults (zero where none is declared); mdesc
+    // must outlive the instance.
+    class MaterialInstance
+    {
+    public:
+        explicit MaterialInstance(const MaterialDescription& mdesc);
+
+        // Floats for float/vecN, column-major floats for matN (9 for mat3, 16 for mat4).
+        // Returns false if the parameter does not exist or count does not match its type.
+        bool setFloats(std::string_view name, const float* values, uint32_t count);
+        bool setFloat(std::string_view name, float value) { return setFloats(name, &value, 1); }
+        bool setInt(std::string_view name, int32_t value);
+        bool setUInt(std::string_view name, uint32_t value);
+        bool setBool(std::string_view name, bool value);
+
+        const std::vector<uint8_t>& data() const { return m_Data; }
+
+    private:
+        const MaterialParamDesc* find(std::string_view name) const;
+
+        const MaterialDescription* m_Desc = nullptr;
+        std::vector<uint8_t>       m_Data;
+    };
+
+    class MaterialParameterPool
+    {
+    public:
+        // Appends the instance block and returns its byte offset (MaterialEntry::blockOffsetBytes).
+        uint32_t add(const MaterialInstance& instance);
+
+        // Overwrites a block previously returned by add(); the instance must have the same size.
+        bool update(uint32_t blockOffsetBytes, const MaterialInstance& instance);
+
+        void clear() { m_Words.clear(); }
+
+        // Upload as the parameter pool buffer.
+        const std::vector<uint32_t>& words() const { return m_Words; }
+        size_t                       byteSize() const { return m_Words.size() * sizeof(uint32_t); }
+
+    private:
+        std::vector<uint32_t> m_Words;
+    };
+} // namespace vshadersystem
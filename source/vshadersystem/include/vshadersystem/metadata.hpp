@@ -37,6 +37,9 @@ namespace vshadersystem
 
         RenderState renderState {};
         bool        renderStateExplicit = false;
+
+        // Ray tracing hit groups from #pragma vultra hit_group <name> lines, in declaration order.
+        std::vector<std::string> hitGroups;
     };
 
     // Parse `#pragma vultra ...` lines. We keep grammar intentionally small and strict.
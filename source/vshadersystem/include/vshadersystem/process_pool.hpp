@@ -0,0 +1,97 @@
+#pragma once
+
+#include "vshadersystem/result.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <span>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace vshadersystem
+{
+    // ------------------------------------------------------------
+    // ProcessPool
+    //
+    // Runs requests in long-lived worker subprocesses instead of threads, so a
+    // crash or leak inside a compile takes down one worker rather than the tool.
+    // Each pool thread owns one worker and exchanges length-prefixed messages
+    // with it over the worker's stdin/stdout:
+    //
+    //   request : size u32, payload
+    //   reply   : size u32, residentBytes u64, payload
+    //
+    // Workers are started on first use and restarted after maxJobsPerProcess
+    // requests, once their reported resident memory exceeds maxResidentBytes, or
+    // after they die. A request in flight on a dead worker fails on its own; the
+    // next request gets a fresh process. On POSIX the pool ignores SIGPIPE for
+    // the whole process, so a dead worker surfaces as a write error instead.
+    //
+    // The worker side is run_process_pool_worker().
+    // ------------------------------------------------------------
+
+    struct ProcessPoolOptions
+    {
+        std::vector<std::string> command;               // worker executable (searched in PATH) and arguments
+        uint32_t                 processCount      = 0; // 0 = std::thread::hardware_concurrency()
+        uint32_t                 maxJobsPerProcess = 0; // 0 = never recycle by count
+        uint64_t                 maxResidentBytes  = 0; // 0 = no memory threshold
+    };
+
+    class ProcessPool
+    {
+    public:
+        // Receives the reply payload, or an eIO error when the worker could not be started or died.
+        using ReplyHandler = std::function<void(Result<std::vector<uint8_t>>)>;
+
+        explicit ProcessPool(ProcessPoolOptions options);
+        ~ProcessPool();
+
+        ProcessPool(const ProcessPool&)            = delete;
+        ProcessPool& operator=(const ProcessPool&) = delete;
+
+        // The handler runs on a pool thread.
+        void submit(std::vector<uint8_t> request, ReplyHandler onReply);
+
+        // Blocks until every submitted request has been answered.
+        void wait();
+
+        uint32_t processCount() const { return static_cast<uint32_t>(m_Threads.size()); }
+
+        // Workers restarted by job count or memory threshold, and workers that died.
+        uint32_t recycledCount() const { return m_Recycled.load(); }
+        uint32_t crashedCount() const { return m_Crashed.load(); }
+
+    private:
+        struct Task
+        {
+            std::vector<uint8_t> request;
+            ReplyHandler         onReply;
+        };
+
+        void workerLoop();
+
+        ProcessPoolOptions       m_Options;
+        std::vector<std::thread> m_Threads;
+        std::deque<Task>         m_Tasks;
+        std::mutex               m_Mutex;
+        std::condition_variable  m_TaskReady;
+        std::condition_variable  m_Idle;
+        size_t                   m_Running  = 0;
+        bool                     m_Stopping = false;
+        std::atomic<uint32_t>    m_Recycled = 0;
+        std::atomic<uint32_t>    m_Crashed  = 0;
+    };
+
+    using ProcessPoolHandler = std::function<std::vector<uint8_t>(std::span<const uint8_t> request)>;
+
+    // Worker main loop: answers requests read from stdin on stdout until stdin is closed.
+    // stdout is pointed at stderr first, so stray prints cannot corrupt the reply stream.
+    // Returns the process exit code.
+    int run_process_pool_worker(const ProcessPoolHandler& handler);
+} // namespace vshadersystem
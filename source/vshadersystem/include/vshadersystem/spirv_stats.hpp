@@ -0,0 +1,46 @@
+#pragma once
+
+#include "vshadersystem/result.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace vshadersystem
+{
+    // ------------------------------------------------------------
+    // Static SPIR-V statistics
+    //
+    // A single linear pass over the instruction stream. Intended for tooling
+    // (variant analysis, size reports), not for precise performance prediction:
+    // staticCost is a weighted instruction count with no control-flow awareness.
+    //
+    // Weights (per instruction inside function bodies):
+    //   arithmetic 1, load/store/access chain 1, extended instruction (GLSL.std.450) 4,
+    //   image sample/fetch/gather/read/write 8, conditional branch/switch 2, function call 2,
+    //   everything else 0.
+    // ------------------------------------------------------------
+
+    struct SpirvStats
+    {
+        uint32_t wordCount        = 0;
+        uint32_t instructionCount = 0;
+
+        // Instructions inside function bodies (excludes types, constants, decorations, debug info).
+        uint32_t functionInstructionCount = 0;
+
+        uint32_t arithmeticCount   = 0;
+        uint32_t memoryCount       = 0;
+        uint32_t extInstCount      = 0;
+        uint32_t imageCount        = 0;
+        uint32_t branchCount       = 0; // OpBranchConditional + OpSwitch
+        uint32_t functionCount     = 0;
+        uint32_t specConstantCount = 0;
+
+        uint32_t inputVariableCount  = 0;
+        uint32_t outputVariableCount = 0;
+
+        uint64_t staticCost = 0;
+    };
+
+    Result<SpirvStats> analyze_spirv(const std::vector<uint32_t>& spirv);
+} // namespace vshadersystem
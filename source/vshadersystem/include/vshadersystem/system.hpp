@@ -1,11 +1,18 @@
 #pragma once
 
+#include "vshadersystem/binding_table.hpp"
 #include "vshadersystem/compiler.hpp"
+#include "vshadersystem/deps.hpp"
 #include "vshadersystem/engine_keywords.hpp"
+#include "vshadersystem/executor.hpp"
+#include "vshadersystem/link_modules.hpp"
 #include "vshadersystem/result.hpp"
 #include "vshadersystem/types.hpp"
 
+#include <memory>
+#include <span>
 #include <string>
+#include <vector>
 
 namespace vshadersystem
 {
@@ -19,9 +26,53 @@ namespace vshadersystem
         bool              hasEngineKeywords = false;
         EngineKeywordsFile engineKeywords;
 
+        // Optional canonical set/binding table. Applied to the SPIR-V after compile/cache lookup,
+        // so editing the table does not invalidate cached SPIR-V.
+        bool         hasBindingTable = false;
+        BindingTable bindingTable;
+
+        // Optional shared keywords and binding table, used instead of the inline copies (and their
+        // has* flags) when set. Lets every variant request of a build reference one copy.
+        std::shared_ptr<const EngineKeywordsFile> sharedEngineKeywords;
+        std::shared_ptr<const BindingTable>       sharedBindingTable;
+
+        // Extra workgroup sizes for compute shaders using local_size_*_id. Each one is emitted into
+        // BuildResult::sizeVariants from the same compile (see workgroup.hpp).
+        std::vector<WorkgroupSize> workgroupSizes;
+
         // Cache behavior
         bool        enableCache = true;
         std::string cacheDir    = ".vshader_cache";
+
+        // Paths under this root are hashed relative to it, so cache entries can be shared across
+        // machines and checkouts. Empty means the current working directory.
+        std::string projectRoot;
+
+        // Optional memo of include content hashes, shared across requests of one build so cache
+        // lookups do not rehash the same include for every variant. Not owned.
+        FileHashCache* fileHashCache = nullptr;
+
+        // Experimental: include modules linked as precompiled SPIR-V instead of being compiled
+        // with every variant (see link_modules.hpp). Requires spirv_linking_available().
+        std::vector<std::string> linkModules;
+
+        // Module cache shared across the requests of one build. Not owned; when null, modules are
+        // compiled for this request only.
+        LinkModuleCache* linkModuleCache = nullptr;
+
+        // nullptr when the request has no engine keywords / binding table.
+        const EngineKeywordsFile* engineKeywordsOrNull() const
+        {
+            if (sharedEngineKeywords)
+                return sharedEngineKeywords.get();
+            return hasEngineKeywords ? &engineKeywords : nullptr;
+        }
+        const BindingTable* bindingTableOrNull() const
+        {
+            if (sharedBindingTable)
+                return sharedBindingTable.get();
+            return hasBindingTable ? &bindingTable : nullptr;
+        }
     };
 
     struct BuildResult
@@ -29,10 +80,24 @@ namespace vshadersystem
         ShaderBinary binary;
         std::string  log;
         bool         fromCache = false;
+        double       compileMs = 0.0; // wall time of compile + reflect; 0 on cache hit
+        double       linkMs    = 0.0; // part of compileMs spent linking link modules
+
+        // One binary per BuildRequest::workgroupSizes entry, keyed by workgroup_variant_hash().
+        std::vector<ShaderBinary> sizeVariants;
     };
 
     Result<BuildResult> build_shader(const BuildRequest& req);
 
+    // Builds every request as a task on the executor and waits for them; results are in request order.
+    // Requests may share caches (fileHashCache, includeCache, linkModuleCache), which are thread-safe.
+    // Blocks the calling thread, so do not call it from a task of the same executor.
+    std::vector<Result<BuildResult>> build_shaders(std::span<const BuildRequest> requests,
+                                                   Executor&                     executor,
+                                                   TaskPriority                  priority = TaskPriority::eNormal);
+
     // Utility: build from SPIR-V input and still generate reflection + material description.
+    // The rvalue overload takes ownership of the words instead of copying them into the binary.
     Result<ShaderBinary> build_from_spirv(const std::vector<uint32_t>& spirv, ShaderStage stage);
+    Result<ShaderBinary> build_from_spirv(std::vector<uint32_t>&& spirv, ShaderStage stage);
 } // namespace vshadersystem
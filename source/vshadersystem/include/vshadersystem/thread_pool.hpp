@@ -0,0 +1,66 @@
+#pragma once
+
+#include "vshadersystem/executor.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace vshadersystem
+{
+    // ------------------------------------------------------------
+    // ThreadPool
+    //
+    // Default Executor: a fixed set of worker threads, each with its own
+    // queue per priority. Tasks submitted from a worker stay on its queue;
+    // other submissions are spread round-robin. An idle worker takes the
+    // highest-priority task available, from its own queue first and then by
+    // stealing from the others, so one long queue does not leave workers
+    // idle. Within a priority, each queue runs in submission order.
+    // ------------------------------------------------------------
+    class ThreadPool final : public Executor
+    {
+    public:
+        // 0 = std::thread::hardware_concurrency() (at least 1).
+        explicit ThreadPool(uint32_t threadCount = 0);
+        ~ThreadPool() override;
+
+        ThreadPool(const ThreadPool&)            = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        using Executor::submit;
+        void     submit(std::function<void()> task, TaskPriority priority) override;
+        uint32_t concurrency() const override { return threadCount(); }
+
+        // Blocks until every submitted task has finished.
+        void wait();
+
+        uint32_t threadCount() const { return static_cast<uint32_t>(m_Threads.size()); }
+
+    private:
+        struct WorkerQueue
+        {
+            std::mutex                        mutex;
+            std::deque<std::function<void()>> tasks[kTaskPriorityCount];
+        };
+
+        bool take(size_t self, std::function<void()>& out);
+        void workerLoop(size_t index);
+
+        std::vector<std::unique_ptr<WorkerQueue>> m_Queues;
+        std::vector<std::thread>                  m_Threads;
+        std::atomic<size_t>                       m_NextQueue = 0;
+        std::mutex                                m_Mutex;
+        std::condition_variable                   m_TaskReady;
+        std::condition_variable                   m_Idle;
+        size_t                                    m_Queued   = 0; // submitted, not yet claimed by a worker
+        size_t                                    m_Running  = 0;
+        bool                                      m_Stopping = false;
+    };
+} // namespace vshadersystem
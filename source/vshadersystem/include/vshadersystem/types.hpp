@@ -1,5 +1,7 @@
 #pragma once
 
+#include "vshadersystem/keywords.hpp"
+
 #include <cstdint>
 #include <string>
 #include <vector>
@@ -24,6 +26,36 @@ namespace vshadersystem
         eRint,
     };
 
+    // File extension name of the stage ("vert", "frag", "comp", ...); "unknown" for eUnknown.
+    inline constexpr const char* shader_stage_name(ShaderStage s)
+    {
+        switch (s)
+        {
+            case ShaderStage::eVert:
+                return "vert";
+            case ShaderStage::eFrag:
+                return "frag";
+            case ShaderStage::eComp:
+                return "comp";
+            case ShaderStage::eTask:
+                return "task";
+            case ShaderStage::eMesh:
+                return "mesh";
+            case ShaderStage::eRgen:
+                return "rgen";
+            case ShaderStage::eRmiss:
+                return "rmiss";
+            case ShaderStage::eRchit:
+                return "rchit";
+            case ShaderStage::eRahit:
+                return "rahit";
+            case ShaderStage::eRint:
+                return "rint";
+            default:
+                return "unknown";
+        }
+    }
+
     using ShaderStageFlags = uint32_t;
 
     enum ShaderStageFlagBits : ShaderStageFlags
@@ -266,12 +298,16 @@ namespace vshadersystem
         uint32_t size = 0;
 
         bool isPushConstant = false;
+        bool isShaderRecord = false; // shaderRecordEXT buffer (ray tracing); no set/binding
 
         ShaderStageFlags stageFlags = 0;
 
         std::vector<BlockMember> members;
     };
 
+    // Marks a local size dimension that is not driven by a specialization constant.
+    inline constexpr uint32_t kNoSpecId = 0xFFFFFFFFu;
+
     struct ShaderReflection
     {
         std::vector<DescriptorBinding> descriptors;
@@ -282,6 +318,21 @@ namespace vshadersystem
         uint32_t localSizeX = 1;
         uint32_t localSizeY = 1;
         uint32_t localSizeZ = 1;
+
+        // SpecId of layout(local_size_x_id = N) and friends, kNoSpecId for fixed dimensions.
+        uint32_t localSizeSpecIdX = kNoSpecId;
+        uint32_t localSizeSpecIdY = kNoSpecId;
+        uint32_t localSizeSpecIdZ = kNoSpecId;
+    };
+
+    // ------------------------------------------------------------
+    // Compute workgroup size
+    // ------------------------------------------------------------
+    struct WorkgroupSize
+    {
+        uint32_t x = 1;
+        uint32_t y = 1;
+        uint32_t z = 1;
     };
 
     // ------------------------------------------------------------
@@ -342,6 +393,16 @@ namespace vshadersystem
         RenderState renderState;
     };
 
+    // ------------------------------------------------------------
+    // Build dependency (resolved #include)
+    // ------------------------------------------------------------
+    struct ShaderDependency
+    {
+        // Relative to the project root when the file lives under it, absolute otherwise.
+        std::string path;
+        uint64_t    contentHash = 0;
+    };
+
     // ------------------------------------------------------------
     // Shader binary
     // ------------------------------------------------------------
@@ -362,5 +423,18 @@ namespace vshadersystem
         MaterialDescription materialDesc;
 
         std::vector<uint32_t> spirv;
+
+        // Resolved includes used to validate cache entries. Empty for binaries not produced by build_shader.
+        std::vector<ShaderDependency> dependencies;
+
+        // Permutation keyword values this variant was built with (the inputs of variantHash).
+        std::vector<KeywordValue> keywordValues;
+
+        // Workgroup sizes built as separate entries from this variant's SPIR-V (see workgroup.hpp).
+        // Only set on the base compute variant.
+        std::vector<WorkgroupSize> workgroupSizes;
+
+        // Hit groups this shader belongs to (#pragma vultra hit_group). Ray tracing hit stages only.
+        std::vector<std::string> hitGroups;
     };
 } // namespace vshadersystem
\ No newline at end of file
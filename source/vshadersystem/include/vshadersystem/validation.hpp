@@ -0,0 +1,88 @@
+#pragma once
+
+#include "vshadersystem/executor.hpp"
+#include "vshadersystem/result.hpp"
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace vshadersystem
+{
+    // ------------------------------------------------------------
+    // SPIR-V validation
+    //
+    // Runs the SPIRV-Tools validator with the compiler's target environment
+    // (Vulkan 1.2), so invalid modules are reported at build time instead of
+    // by the driver.
+    //
+    // Requires a build with the vshadersystem_spirv_tools option.
+    // ------------------------------------------------------------
+
+    // False when vshadersystem was built without SPIRV-Tools.
+    bool spirv_validation_available();
+
+    // eCompileError with the validator's diagnostics when the module is invalid.
+    Result<void> validate_spirv(const std::vector<uint32_t>& spirv);
+
+    // ------------------------------------------------------------
+    // SpirvValidationCache
+    //
+    // Validity depends only on the module words, and many variants compile to
+    // the same SPIR-V, so each spirvHash is validated once. Passing hashes are
+    // appended to <cacheDir>/spirv_validated (keyed together with the
+    // validator version), so later builds only validate new modules.
+    // Failures are remembered for the lifetime of the cache only.
+    //
+    // Thread-safe: concurrent requests for one hash wait for a single run.
+    // ------------------------------------------------------------
+    class SpirvValidationCache
+    {
+    public:
+        using Callback = std::function<void(const Result<void>&)>;
+
+        // Empty cacheDir keeps results in memory only.
+        explicit SpirvValidationCache(std::string cacheDir = {});
+
+        Result<void> validate(const std::vector<uint32_t>& spirv, uint64_t spirvHash);
+
+        // Validates on the group's executor and returns at once. onDone runs inline when the result is
+        // already known, otherwise on the executor's thread; a request for a hash that is being validated
+        // is answered by that run instead of occupying a worker while it waits.
+        void validateAsync(std::shared_ptr<const std::vector<uint32_t>> spirv,
+                           uint64_t                                     spirvHash,
+                           TaskGroup&                                   group,
+                           Callback                                     onDone);
+
+        // Modules run through the validator, and requests answered from the cache.
+        size_t validatedCount() const;
+        size_t cachedCount() const;
+        double totalValidateMs() const;
+
+    private:
+        uint64_t key(uint64_t spirvHash) const;
+
+        // Under m_Mutex: the known result for k, if any.
+        std::optional<Result<void>> lookup(uint64_t k);
+        // Validates a hash this caller has marked running, records the result and answers its waiters.
+        Result<void> run(uint64_t k, const std::vector<uint32_t>& spirv);
+
+        std::string                                         m_File;
+        mutable std::mutex                                  m_Mutex;
+        std::condition_variable                             m_Done;
+        std::unordered_set<uint64_t>                        m_Passed;
+        std::unordered_map<uint64_t, std::string>           m_Failed;
+        std::unordered_set<uint64_t>                        m_Running;
+        std::unordered_map<uint64_t, std::vector<Callback>> m_Waiters; // validateAsync requests for running hashes
+        size_t                                              m_Validated = 0;
+        size_t                                              m_Cached    = 0;
+        double                                              m_TotalMs   = 0.0;
+    };
+} // namespace vshadersystem
@@ -0,0 +1,112 @@
+#pragma once
+
+#include "vshadersystem/compiler.hpp"
+#include "vshadersystem/engine_keywords.hpp"
+#include "vshadersystem/metadata.hpp"
+#include "vshadersystem/result.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace vshadersystem
+{
+    // ------------------------------------------------------------
+    // Permutation variant enumeration
+    //
+    // Expands every `#pragma keyword permute ...` declaration of a shader into
+    // the full cartesian product of -D define sets:
+    //   - Bool keywords expand to NAME=0 / NAME=1
+    //   - Enum keywords expand to NAME=<enumerant> for each enumerant
+    //   - Global keywords set by the engine keywords file expand to that value only
+    //
+    // Each combination is then checked against all only_if(...) constraints,
+    // resolving keyword values as: default -> variant define -> engine keywords (global scope only).
+    // ------------------------------------------------------------
+
+    struct VariantEnumeration
+    {
+        // One define set per surviving variant. A shader without permutation
+        // keywords yields a single empty define set.
+        std::vector<std::vector<Define>> variants;
+
+        // Number of combinations dropped by only_if constraints.
+        size_t pruned = 0;
+
+        // Number of combinations dropped by the stripper.
+        size_t stripped = 0;
+    };
+
+    // ------------------------------------------------------------
+    // Variant stripping
+    //
+    // Drops variants for reasons the shader cannot state in only_if: platform
+    // capabilities, features disabled in the project, keywords no material
+    // sets. The stripper sees each variant that passed the only_if
+    // constraints, with the value of every permutation keyword.
+    // ------------------------------------------------------------
+    struct VariantStripQuery
+    {
+        std::string_view        shaderId; // shader_id_from_virtual_path()
+        ShaderStage             stage = ShaderStage::eUnknown;
+        std::span<const Define> defines; // the variant's -D set, one per permutation keyword
+    };
+
+    // Returns true to strip the variant.
+    using VariantStripper = std::function<bool(const VariantStripQuery& query)>;
+
+    // When skipInvalid is false, the first combination violating an only_if constraint is an error.
+    Result<VariantEnumeration>
+    enumerate_shader_variants(const ParsedMetadata& meta, const EngineKeywordsFile* engineKeywords, bool skipInvalid);
+
+    // As above, then drops the variants the stripper rejects (an empty stripper keeps all).
+    Result<VariantEnumeration> enumerate_shader_variants(const ParsedMetadata&     meta,
+                                                         const EngineKeywordsFile* engineKeywords,
+                                                         bool                      skipInvalid,
+                                                         std::string_view          shaderId,
+                                                         ShaderStage               stage,
+                                                         const VariantStripper&    stripper);
+
+    // Loads a strip plugin: a shared library exporting the C function
+    //   int vshaderc_strip_variant(const char* shaderId, const char* stage,
+    //                              const char* const* names, const char* const* values, uint32_t count);
+    // returning nonzero to strip. stage is the file extension name ("vert", "frag", "comp", ...).
+    // The library stays loaded while the returned stripper or a copy of it exists.
+    Result<VariantStripper> load_variant_strip_plugin(const std::string& path);
+
+    // Number of permutation keywords the variant sets to something other than the value a shader
+    // gets without defines (the declared default, or the engine value for global keywords).
+    // 0 means the default variant.
+    uint32_t variant_default_distance(const ParsedMetadata&      meta,
+                                      const EngineKeywordsFile*  engineKeywords,
+                                      const std::vector<Define>& defines);
+
+    // ------------------------------------------------------------
+    // Variant usage log
+    //
+    // Variant requests observed at runtime, used to order builds. Text format,
+    // one record per line ('#' starts a comment):
+    //   <count> <shaderId> [NAME=VALUE ...]
+    // Keywords a record does not list match any value.
+    // ------------------------------------------------------------
+    struct VariantUsageRecord
+    {
+        uint64_t            count = 0;
+        std::string         shaderId;
+        std::vector<Define> values;
+    };
+
+    struct VariantUsageLog
+    {
+        std::vector<VariantUsageRecord> records;
+
+        // Sum of the counts of the records matching the variant; 0 when never used.
+        uint64_t weight(std::string_view shaderId, const std::vector<Define>& defines) const;
+
+        static Result<VariantUsageLog> load(const std::string& filePath);
+    };
+} // namespace vshadersystem
@@ -0,0 +1,106 @@
+#pragma once
+
+#include "vshadersystem/executor.hpp"
+#include "vshadersystem/library.hpp"
+#include "vshadersystem/result.hpp"
+#include "vshadersystem/types.hpp"
+#include "vshadersystem/variants.hpp"
+
+#include <cstdint>
+#include <functional>
+#include <set>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace vshadersystem
+{
+    // ------------------------------------------------------------
+    // WarmupScheduler
+    //
+    // Spreads the lookup and decode of library entries over frames. The host
+    // enqueues a prioritized variant list (from a usage log, or a whole library
+    // or profile at startup), then calls update() once per frame with the time
+    // it can spare; each decoded binary is handed to the callback, typically to
+    // create its pipeline.
+    //
+    // An entry is never split across frames. update() stops before an entry
+    // whose predicted decode time (measured ns/byte so far) would overrun the
+    // budget, except for the first entry of a frame, so warmup always makes
+    // progress. Priorities can be recomputed at any time, e.g. as the camera
+    // moves toward other materials.
+    //
+    // The scheduler holds a reference to the library, which must outlive it.
+    // Not thread-safe; call it from one thread.
+    // ------------------------------------------------------------
+
+    struct WarmupItem
+    {
+        uint64_t    keyHash  = 0;
+        ShaderStage stage    = ShaderStage::eUnknown;
+        float       priority = 0.0f; // higher is decoded first
+    };
+
+    struct WarmupProgress
+    {
+        size_t completed = 0; // handed to the callback, including failures
+        size_t failed    = 0; // not in the library, or not a readable .vshbin
+        size_t remaining = 0;
+        double spentMs   = 0.0; // by the last update()
+    };
+
+    class WarmupScheduler
+    {
+    public:
+        // Receives the decoded binary, or the reason the item could not be decoded.
+        using Callback = std::function<void(const WarmupItem& item, Result<ShaderBinary> binary)>;
+
+        WarmupScheduler(const ShaderLibrary& lib, Callback onReady);
+
+        // Items already queued or completed are ignored; re-queue with reprioritize() instead.
+        void enqueue(const WarmupItem& item);
+        void enqueue(std::span<const WarmupItem> items);
+
+        // Recomputes the priority of every pending item.
+        void reprioritize(const std::function<float(const WarmupItem& item)>& score);
+
+        // Decodes pending items, highest priority first, within budgetMs of wall time.
+        WarmupProgress update(double budgetMs);
+
+        // Decodes everything still pending (loading screens, tools).
+        WarmupProgress finish();
+
+        void clear();
+
+        const WarmupProgress& progress() const { return m_Progress; }
+        bool                  done() const { return m_Pending.empty(); }
+
+    private:
+        void decodeNext();
+
+        const ShaderLibrary&                       m_Library;
+        Callback                                   m_OnReady;
+        std::vector<WarmupItem>                    m_Pending; // max-heap on priority
+        std::set<std::pair<uint64_t, ShaderStage>> m_Known;   // (keyHash, stage) of every item ever enqueued
+        WarmupProgress                             m_Progress;
+
+        // Decode cost model for the budget check.
+        double   m_DecodedNs    = 0.0;
+        uint64_t m_DecodedBytes = 0;
+    };
+
+    // Decodes the items as tasks of the group, highest priority submitted first, and returns at once; for
+    // loading screens and background prefetch that need no frame budget. onReady runs on the executor's
+    // threads, possibly concurrently. Wait on the group before the library goes away.
+    void warmup_async(const ShaderLibrary&        lib,
+                      std::span<const WarmupItem> items,
+                      TaskGroup&                  group,
+                      WarmupScheduler::Callback   onReady);
+
+    // One item per library entry matched by the usage log, with the summed record counts as priority.
+    // Entries are matched through the library's keyword bitsets (KWBS); unlisted keywords match any value.
+    std::vector<WarmupItem> warmup_items_from_usage_log(const ShaderLibrary& lib, const VariantUsageLog& log);
+
+    // Every entry of the library, or of one profile of a merged library (profile < 0 = all), at priority 0.
+    std::vector<WarmupItem> warmup_items_from_library(const ShaderLibrary& lib, int32_t profile = -1);
+} // namespace vshadersystem
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "vshadersystem/result.hpp"
+#include "vshadersystem/types.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace vshadersystem
+{
+    // ------------------------------------------------------------
+    // Compute workgroup size variants
+    //
+    // A compute shader that takes its local size from specialization constants
+    //
+    //   layout(local_size_x_id = 0, local_size_y_id = 1) in;
+    //
+    // is compiled once and re-emitted for other sizes by rewriting the default
+    // values of those constants in the SPIR-V. Each size is stored as its own
+    // library entry keyed by workgroup_variant_hash(variantHash, size), so
+    // backends without specialization support still get a ready-made module.
+    //
+    // Size lists use "X[xY[xZ]]" items separated by ',' or ';', e.g. "64,128,8x8".
+    // ------------------------------------------------------------
+
+    Result<std::vector<WorkgroupSize>> parse_workgroup_sizes(std::string_view list);
+
+    std::string format_workgroup_size(const WorkgroupSize& size);
+
+    // Returns a copy of spirv whose local size is `size`. Dimensions without a spec id must
+    // keep their fixed size.
+    Result<std::vector<uint32_t>> specialize_workgroup_size(const std::vector<uint32_t>& spirv,
+                                                            const ShaderReflection&      refl,
+                                                            const WorkgroupSize&         size);
+
+    uint64_t workgroup_variant_hash(uint64_t variantHash, const WorkgroupSize& size);
+
+    // Picks the candidate that launches the fewest invocations for a dispatch covering
+    // threadsX * threadsY * threadsZ invocations; ties go to the larger workgroup, then to
+    // the earlier candidate. Returns an index into candidates (0 when candidates is empty).
+    size_t select_workgroup_size(const std::vector<WorkgroupSize>& candidates,
+                                 uint32_t                          threadsX,
+                                 uint32_t                          threadsY = 1,
+                                 uint32_t                          threadsZ = 1);
+} // namespace vshadersystem
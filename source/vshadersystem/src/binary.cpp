@@ -2,6 +2,8 @@
 #include "vshadersystem/hash.hpp"
 #include "vshadersystem/types.hpp"
 
+#include <algorithm>
+#include <atomic>
 #include <cstdint>
 #include <cstring>
 #include <filesystem>
@@ -18,7 +20,7 @@
 namespace vshadersystem
 {
     static constexpr uint8_t  kMagic[8] = {'V', 'S', 'H', 'B', 'I', 'N', 0, 0};
-    static constexpr uint32_t kVersion  = 2;
+    static constexpr uint32_t kVersion  = 5;
 
     static inline void write_u32(std::vector<uint8_t>& out, uint32_t v)
     {
@@ -120,6 +122,7 @@ namespace vshadersystem
             write_u32(out, b.binding);
             write_u32(out, b.size);
             write_u8(out, static_cast<uint8_t>(b.isPushConstant ? 1 : 0));
+            write_u8(out, static_cast<uint8_t>(b.isShaderRecord ? 1 : 0)); // v5+
             write_u32(out, b.stageFlags);
 
             write_u32(out, static_cast<uint32_t>(b.members.size()));
@@ -128,13 +131,25 @@ namespace vshadersystem
                 write_string(out, m.name);
                 write_u32(out, m.offset);
                 write_u32(out, m.size);
+                write_u8(out, static_cast<uint8_t>(m.type));
             }
         }
 
+        // v3+: compute local size, so cached reflection is complete.
+        write_u8(out, static_cast<uint8_t>(r.hasLocalSize ? 1 : 0));
+        write_u32(out, r.localSizeX);
+        write_u32(out, r.localSizeY);
+        write_u32(out, r.localSizeZ);
+
+        // v4+: local size specialization constant ids.
+        write_u32(out, r.localSizeSpecIdX);
+        write_u32(out, r.localSizeSpecIdY);
+        write_u32(out, r.localSizeSpecIdZ);
+
         return out;
     }
 
-    static Result<ShaderReflection> deserialize_reflection(const uint8_t* p0, size_t n)
+    static Result<ShaderReflection> deserialize_reflection(const uint8_t* p0, size_t n, uint32_t version)
     {
         const uint8_t* p = p0;
         const uint8_t* e = p0 + n;
@@ -208,6 +223,15 @@ namespace vshadersystem
                     {ErrorCode::eDeserializeError, "REFL: failed to read block push flag."});
             b.isPushConstant = (isPush != 0);
 
+            if (version >= 5)
+            {
+                uint8_t isRecord = 0;
+                if (!read_u8(p, e, isRecord))
+                    return Result<ShaderReflection>::err(
+                        {ErrorCode::eDeserializeError, "REFL: failed to read block shader record flag."});
+                b.isShaderRecord = (isRecord != 0);
+            }
+
             uint32_t stageFlags = 0;
             if (!read_u32(p, e, stageFlags))
                 return Result<ShaderReflection>::err(
@@ -231,12 +255,38 @@ namespace vshadersystem
                 if (!read_u32(p, e, m.size))
                     return Result<ShaderReflection>::err(
                         {ErrorCode::eDeserializeError, "REFL: failed to read member size."});
+                if (version >= 3)
+                {
+                    uint8_t type = 0;
+                    if (!read_u8(p, e, type))
+                        return Result<ShaderReflection>::err(
+                            {ErrorCode::eDeserializeError, "REFL: failed to read member type."});
+                    m.type = static_cast<ParamType>(type);
+                }
                 b.members.push_back(std::move(m));
             }
 
             r.blocks.push_back(std::move(b));
         }
 
+        if (version >= 3)
+        {
+            uint8_t hasLocalSize = 0;
+            if (!read_u8(p, e, hasLocalSize) || !read_u32(p, e, r.localSizeX) || !read_u32(p, e, r.localSizeY) ||
+                !read_u32(p, e, r.localSizeZ))
+                return Result<ShaderReflection>::err(
+                    {ErrorCode::eDeserializeError, "REFL: failed to read local size."});
+            r.hasLocalSize = hasLocalSize != 0;
+        }
+
+        if (version >= 4)
+        {
+            if (!read_u32(p, e, r.localSizeSpecIdX) || !read_u32(p, e, r.localSizeSpecIdY) ||
+                !read_u32(p, e, r.localSizeSpecIdZ))
+                return Result<ShaderReflection>::err(
+                    {ErrorCode::eDeserializeError, "REFL: failed to read local size spec ids."});
+        }
+
         if (p != e)
         {
             // We tolerate extra bytes for forward compatibility in chunk payloads,
@@ -534,6 +584,148 @@ namespace vshadersystem
         return Result<MaterialDescription>::ok(std::move(m));
     }
 
+    // ------------------------------------------------------------
+    // DEPS chunk
+    // ------------------------------------------------------------
+    static std::vector<uint8_t> serialize_dependencies(const std::vector<ShaderDependency>& deps)
+    {
+        std::vector<uint8_t> out;
+
+        write_u32(out, static_cast<uint32_t>(deps.size()));
+        for (const auto& d : deps)
+        {
+            write_string(out, d.path);
+            write_u64(out, d.contentHash);
+        }
+
+        return out;
+    }
+
+    static Result<std::vector<ShaderDependency>> deserialize_dependencies(const uint8_t* p0, size_t n)
+    {
+        const uint8_t* p = p0;
+        const uint8_t* e = p0 + n;
+
+        uint32_t count = 0;
+        if (!read_u32(p, e, count))
+            return Result<std::vector<ShaderDependency>>::err(
+                {ErrorCode::eDeserializeError, "DEPS: failed to read dependency count."});
+
+        std::vector<ShaderDependency> deps;
+        deps.reserve(count);
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            ShaderDependency d;
+            if (!read_string(p, e, d.path))
+                return Result<std::vector<ShaderDependency>>::err(
+                    {ErrorCode::eDeserializeError, "DEPS: failed to read dependency path."});
+            if (!read_u64(p, e, d.contentHash))
+                return Result<std::vector<ShaderDependency>>::err(
+                    {ErrorCode::eDeserializeError, "DEPS: failed to read dependency hash."});
+            deps.push_back(std::move(d));
+        }
+
+        if (p != e)
+            return Result<std::vector<ShaderDependency>>::err(
+                {ErrorCode::eDeserializeError, "DEPS: trailing bytes detected."});
+
+        return Result<std::vector<ShaderDependency>>::ok(std::move(deps));
+    }
+
+    static std::vector<uint8_t> serialize_keyword_values(const std::vector<KeywordValue>& values)
+    {
+        std::vector<uint8_t> out;
+
+        write_u32(out, static_cast<uint32_t>(values.size()));
+        for (const auto& v : values)
+        {
+            write_string(out, v.name);
+            write_u8(out, static_cast<uint8_t>(v.kind));
+            write_u32(out, v.value);
+            write_u32(out, static_cast<uint32_t>(v.enumValues.size()));
+            for (const auto& ev : v.enumValues)
+                write_string(out, ev);
+        }
+
+        return out;
+    }
+
+    static Result<std::vector<KeywordValue>> deserialize_keyword_values(const uint8_t* p0, size_t n)
+    {
+        const uint8_t* p = p0;
+        const uint8_t* e = p0 + n;
+
+        uint32_t count = 0;
+        if (!read_u32(p, e, count))
+            return Result<std::vector<KeywordValue>>::err(
+                {ErrorCode::eDeserializeError, "KVAL: failed to read keyword count."});
+
+        std::vector<KeywordValue> values;
+        values.reserve(count);
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            KeywordValue v;
+            uint8_t      kind      = 0;
+            uint32_t     enumCount = 0;
+            if (!read_string(p, e, v.name) || !read_u8(p, e, kind) || !read_u32(p, e, v.value) ||
+                !read_u32(p, e, enumCount) || enumCount > static_cast<size_t>(e - p) / 4)
+                return Result<std::vector<KeywordValue>>::err(
+                    {ErrorCode::eDeserializeError, "KVAL: failed to read keyword value."});
+            v.kind = static_cast<KeywordValueKind>(kind);
+
+            v.enumValues.resize(enumCount);
+            for (auto& ev : v.enumValues)
+            {
+                if (!read_string(p, e, ev))
+                    return Result<std::vector<KeywordValue>>::err(
+                        {ErrorCode::eDeserializeError, "KVAL: failed to read enum value."});
+            }
+            values.push_back(std::move(v));
+        }
+
+        if (p != e)
+            return Result<std::vector<KeywordValue>>::err(
+                {ErrorCode::eDeserializeError, "KVAL: trailing bytes detected."});
+
+        return Result<std::vector<KeywordValue>>::ok(std::move(values));
+    }
+
+    static std::vector<uint8_t> serialize_hit_groups(const std::vector<std::string>& groups)
+    {
+        std::vector<uint8_t> out;
+
+        write_u32(out, static_cast<uint32_t>(groups.size()));
+        for (const auto& g : groups)
+            write_string(out, g);
+
+        return out;
+    }
+
+    static Result<std::vector<std::string>> deserialize_hit_groups(const uint8_t* p0, size_t n)
+    {
+        const uint8_t* p = p0;
+        const uint8_t* e = p0 + n;
+
+        uint32_t count = 0;
+        if (!read_u32(p, e, count) || count > static_cast<size_t>(e - p) / 4)
+            return Result<std::vector<std::string>>::err(
+                {ErrorCode::eDeserializeError, "HGRP: failed to read hit group count."});
+
+        std::vector<std::string> groups(count);
+        for (auto& g : groups)
+        {
+            if (!read_string(p, e, g))
+                return Result<std::vector<std::string>>::err(
+                    {ErrorCode::eDeserializeError, "HGRP: failed to read hit group name."});
+        }
+
+        if (p != e)
+            return Result<std::vector<std::string>>::err(
+                {ErrorCode::eDeserializeError, "HGRP: trailing bytes detected."});
+
+        return Result<std::vector<std::string>>::ok(std::move(groups));
+    }
+
     // ------------------------------------------------------------
     // Public API
     // ------------------------------------------------------------
@@ -599,10 +791,36 @@ namespace vshadersystem
         // MDES
         write_chunk("MDES", serialize_mdesc(bin.materialDesc));
 
+        // DEPS (optional)
+        if (!bin.dependencies.empty())
+            write_chunk("DEPS", serialize_dependencies(bin.dependencies));
+
+        // KVAL (optional)
+        if (!bin.keywordValues.empty())
+            write_chunk("KVAL", serialize_keyword_values(bin.keywordValues));
+
+        // WGSZ (optional)
+        if (!bin.workgroupSizes.empty())
+        {
+            std::vector<uint8_t> wgsz;
+            write_u32(wgsz, static_cast<uint32_t>(bin.workgroupSizes.size()));
+            for (const auto& ws : bin.workgroupSizes)
+            {
+                write_u32(wgsz, ws.x);
+                write_u32(wgsz, ws.y);
+                write_u32(wgsz, ws.z);
+            }
+            write_chunk("WGSZ", wgsz);
+        }
+
+        // HGRP (optional)
+        if (!bin.hitGroups.empty())
+            write_chunk("HGRP", serialize_hit_groups(bin.hitGroups));
+
         return Result<std::vector<uint8_t>>::ok(std::move(out));
     }
 
-    Result<ShaderBinary> read_vshbin(const std::vector<uint8_t>& bytes)
+    Result<ShaderBinary> read_vshbin(std::span<const uint8_t> bytes)
     {
         if (bytes.size() < 32)
             return Result<ShaderBinary>::err({ErrorCode::eDeserializeError, "File too small to be a valid .vshbin."});
@@ -711,7 +929,7 @@ namespace vshadersystem
             }
             else if (tag == tag_u32("REFL"))
             {
-                auto rr = deserialize_reflection(payload, size);
+                auto rr = deserialize_reflection(payload, size, version);
 
                 if (!rr.isOk())
                     return Result<ShaderBinary>::err(rr.error());
@@ -731,6 +949,49 @@ namespace vshadersystem
 
                 hasMDES = true;
             }
+            else if (tag == tag_u32("DEPS"))
+            {
+                auto dr = deserialize_dependencies(payload, size);
+
+                if (!dr.isOk())
+                    return Result<ShaderBinary>::err(dr.error());
+
+                out.dependencies = std::move(dr.value());
+            }
+            else if (tag == tag_u32("KVAL"))
+            {
+                auto kr = deserialize_keyword_values(payload, size);
+
+                if (!kr.isOk())
+                    return Result<ShaderBinary>::err(kr.error());
+
+                out.keywordValues = std::move(kr.value());
+            }
+            else if (tag == tag_u32("WGSZ"))
+            {
+                const uint8_t* p2    = payload;
+                const uint8_t* e2    = payload + size;
+                uint32_t       count = 0;
+                if (!read_u32(p2, e2, count) || static_cast<uint64_t>(count) * 12 != size - 4u)
+                    return Result<ShaderBinary>::err({ErrorCode::eDeserializeError, "WGSZ chunk size invalid."});
+
+                out.workgroupSizes.resize(count);
+                for (auto& ws : out.workgroupSizes)
+                {
+                    read_u32(p2, e2, ws.x);
+                    read_u32(p2, e2, ws.y);
+                    read_u32(p2, e2, ws.z);
+                }
+            }
+            else if (tag == tag_u32("HGRP"))
+            {
+                auto gr = deserialize_hit_groups(payload, size);
+
+                if (!gr.isOk())
+                    return Result<ShaderBinary>::err(gr.error());
+
+                out.hitGroups = std::move(gr.value());
+            }
             else
             {
                 // Skip unknown chunks (forward compatibility)
@@ -771,8 +1032,12 @@ namespace vshadersystem
             std::filesystem::create_directories(parentPath);
 
         // Production-grade atomic write:
-        // write to a temp file then rename.
-        const std::string tmpPath = path + ".tmp." + std::to_string(static_cast<uint64_t>(VSS_GETPID()));
+        // write to a temp file then rename. The temp name is unique per process and per call, since several
+        // threads of one build may write the same cache entry or output at once.
+        static std::atomic<uint64_t> tmpCounter {0};
+
+        const std::string tmpPath = path + ".tmp." + std::to_string(static_cast<uint64_t>(VSS_GETPID())) + "." +
+                                    std::to_string(tmpCounter.fetch_add(1, std::memory_order_relaxed));
 
         {
             std::ofstream f(tmpPath, std::ios::binary);
@@ -822,4 +1087,208 @@ namespace vshadersystem
 
         return read_vshbin(bytes);
     }
+
+    // ------------------------------------------------------------
+    // Peek (header + identity chunks)
+    // ------------------------------------------------------------
+    static constexpr size_t kHeaderSize = 32;
+
+    static Result<uint32_t> peek_header(const uint8_t* p, size_t n, ShaderBinaryInfo& info)
+    {
+        if (n < kHeaderSize)
+            return Result<uint32_t>::err({ErrorCode::eDeserializeError, "File too small to be a valid .vshbin."});
+
+        const uint8_t* e = p + n;
+        if (std::memcmp(p, kMagic, sizeof(kMagic)) != 0)
+            return Result<uint32_t>::err({ErrorCode::eDeserializeError, "Invalid magic header (not a .vshbin)."});
+        p += sizeof(kMagic);
+
+        uint32_t version = 0;
+        uint32_t flags   = 0;
+        read_u32(p, e, version);
+        read_u32(p, e, flags);
+        read_u64(p, e, info.contentHash);
+        read_u64(p, e, info.spirvHash);
+
+        if (version < 1 || version > kVersion)
+            return Result<uint32_t>::err({ErrorCode::eDeserializeError, "Unsupported .vshbin version."});
+
+        info.stage = static_cast<ShaderStage>(flags & 0xFF);
+        return Result<uint32_t>::ok(version);
+    }
+
+    static bool is_peeked_chunk(uint32_t tag)
+    {
+        return tag == tag_u32("SIDH") || tag == tag_u32("VKEY") || tag == tag_u32("REFL") || tag == tag_u32("KVAL") ||
+               tag == tag_u32("HGRP");
+    }
+
+    static Result<void>
+    peek_chunk(uint32_t tag, const uint8_t* payload, uint32_t size, uint32_t version, ShaderBinaryInfo& info)
+    {
+        const uint8_t* p = payload;
+        const uint8_t* e = payload + size;
+
+        if (tag == tag_u32("SIDH"))
+        {
+            if (size != 8 || !read_u64(p, e, info.shaderIdHash))
+                return Result<void>::err({ErrorCode::eDeserializeError, "SIDH chunk size invalid."});
+        }
+        else if (tag == tag_u32("VKEY"))
+        {
+            if (size != 8 || !read_u64(p, e, info.variantHash))
+                return Result<void>::err({ErrorCode::eDeserializeError, "VKEY chunk size invalid."});
+        }
+        else if (tag == tag_u32("REFL"))
+        {
+            auto rr = deserialize_reflection(payload, size, version);
+            if (!rr.isOk())
+                return Result<void>::err(rr.error());
+            info.reflection = std::move(rr.value());
+        }
+        else if (tag == tag_u32("KVAL"))
+        {
+            auto kr = deserialize_keyword_values(payload, size);
+            if (!kr.isOk())
+                return Result<void>::err(kr.error());
+            info.keywordValues = std::move(kr.value());
+        }
+        else if (tag == tag_u32("HGRP"))
+        {
+            auto gr = deserialize_hit_groups(payload, size);
+            if (!gr.isOk())
+                return Result<void>::err(gr.error());
+            info.hitGroups = std::move(gr.value());
+        }
+        return Result<void>::ok();
+    }
+
+    static Result<void> check_required_chunks(bool hasSPRV, bool hasREFL, bool hasMDES)
+    {
+        if (!hasSPRV)
+            return Result<void>::err({ErrorCode::eDeserializeError, "Missing SPRV chunk."});
+        if (!hasREFL)
+            return Result<void>::err({ErrorCode::eDeserializeError, "Missing REFL chunk."});
+        if (!hasMDES)
+            return Result<void>::err({ErrorCode::eDeserializeError, "Missing MDES chunk."});
+        return Result<void>::ok();
+    }
+
+    Result<ShaderBinaryInfo> peek_vshbin(std::span<const uint8_t> bytes)
+    {
+        ShaderBinaryInfo info;
+        info.byteSize = bytes.size();
+
+        auto hr = peek_header(bytes.data(), bytes.size(), info);
+        if (!hr.isOk())
+            return Result<ShaderBinaryInfo>::err(hr.error());
+        const uint32_t version = hr.value();
+
+        const uint8_t* p = bytes.data() + kHeaderSize;
+        const uint8_t* e = bytes.data() + bytes.size();
+
+        bool hasSPRV = false;
+        bool hasREFL = false;
+        bool hasMDES = false;
+
+        while (p < e)
+        {
+            uint32_t tag  = 0;
+            uint32_t size = 0;
+            if (!read_u32(p, e, tag) || !read_u32(p, e, size))
+                return Result<ShaderBinaryInfo>::err({ErrorCode::eDeserializeError, "Failed to read chunk header."});
+            if (size > static_cast<size_t>(e - p))
+                return Result<ShaderBinaryInfo>::err(
+                    {ErrorCode::eDeserializeError, "Chunk size exceeds file bounds."});
+
+            hasSPRV |= tag == tag_u32("SPRV");
+            hasREFL |= tag == tag_u32("REFL");
+            hasMDES |= tag == tag_u32("MDES");
+
+            auto cr = peek_chunk(tag, p, size, version, info);
+            if (!cr.isOk())
+                return Result<ShaderBinaryInfo>::err(cr.error());
+
+            p += size;
+        }
+
+        auto rc = check_required_chunks(hasSPRV, hasREFL, hasMDES);
+        if (!rc.isOk())
+            return Result<ShaderBinaryInfo>::err(rc.error());
+
+        return Result<ShaderBinaryInfo>::ok(std::move(info));
+    }
+
+    Result<ShaderBinaryInfo> peek_vshbin_file(const std::string& path)
+    {
+        std::ifstream f(path, std::ios::binary);
+        if (!f)
+            return Result<ShaderBinaryInfo>::err({ErrorCode::eIO, "Failed to open file: " + path});
+
+        f.seekg(0, std::ios::end);
+        const auto fileSize = static_cast<uint64_t>(f.tellg());
+        f.seekg(0, std::ios::beg);
+
+        ShaderBinaryInfo info;
+        info.byteSize = fileSize;
+
+        uint8_t      header[kHeaderSize] = {};
+        const size_t headerBytes         = static_cast<size_t>(std::min<uint64_t>(fileSize, kHeaderSize));
+        f.read(reinterpret_cast<char*>(header), static_cast<std::streamsize>(headerBytes));
+
+        auto hr = peek_header(header, headerBytes, info);
+        if (!hr.isOk())
+            return Result<ShaderBinaryInfo>::err(hr.error());
+        const uint32_t version = hr.value();
+
+        bool hasSPRV = false;
+        bool hasREFL = false;
+        bool hasMDES = false;
+
+        std::vector<uint8_t> payload;
+        uint64_t             pos = kHeaderSize;
+        while (pos < fileSize)
+        {
+            uint8_t chunkHeader[8];
+            if (fileSize - pos < sizeof(chunkHeader) ||
+                !f.read(reinterpret_cast<char*>(chunkHeader), sizeof(chunkHeader)))
+                return Result<ShaderBinaryInfo>::err({ErrorCode::eDeserializeError, "Failed to read chunk header."});
+            pos += sizeof(chunkHeader);
+
+            const uint8_t* p    = chunkHeader;
+            uint32_t       tag  = 0;
+            uint32_t       size = 0;
+            read_u32(p, chunkHeader + sizeof(chunkHeader), tag);
+            read_u32(p, chunkHeader + sizeof(chunkHeader), size);
+            if (size > fileSize - pos)
+                return Result<ShaderBinaryInfo>::err(
+                    {ErrorCode::eDeserializeError, "Chunk size exceeds file bounds."});
+
+            hasSPRV |= tag == tag_u32("SPRV");
+            hasREFL |= tag == tag_u32("REFL");
+            hasMDES |= tag == tag_u32("MDES");
+
+            if (is_peeked_chunk(tag))
+            {
+                payload.resize(size);
+                if (!f.read(reinterpret_cast<char*>(payload.data()), static_cast<std::streamsize>(size)))
+                    return Result<ShaderBinaryInfo>::err({ErrorCode::eIO, "Failed to read file: " + path});
+
+                auto cr = peek_chunk(tag, payload.data(), size, version, info);
+                if (!cr.isOk())
+                    return Result<ShaderBinaryInfo>::err(cr.error());
+            }
+            else
+            {
+                f.seekg(static_cast<std::streamoff>(size), std::ios::cur);
+            }
+            pos += size;
+        }
+
+        auto rc = check_required_chunks(hasSPRV, hasREFL, hasMDES);
+        if (!rc.isOk())
+            return Result<ShaderBinaryInfo>::err(rc.error());
+
+        return Result<ShaderBinaryInfo>::ok(std::move(info));
+    }
 } // namespace vshadersystem
\ No newline at end of file
@@ -0,0 +1,364 @@
+#include "vshadersystem/binding_table.hpp"
+
+#include <spirv_cross/spirv.hpp>
+
+#include <cctype>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <set>
+#include <sstream>
+#include <unordered_map>
+#include <utility>
+
+namespace vshadersystem
+{
+    // ------------------------------------------------------------
+    // Parsing
+    // ------------------------------------------------------------
+    static bool parse_frequency(std::string_view s, KeywordScope& out)
+    {
+        if (s == "global")
+        {
+            out = KeywordScope::eGlobal;
+            return true;
+        }
+        if (s == "pass")
+        {
+            out = KeywordScope::ePass;
+            return true;
+        }
+        if (s == "material")
+        {
+            out = KeywordScope::eMaterial;
+            return true;
+        }
+        if (s == "local" || s == "shader" || s == "shaderlocal")
+        {
+            out = KeywordScope::eShaderLocal;
+            return true;
+        }
+        return false;
+    }
+
+    static uint32_t default_set_for(KeywordScope f)
+    {
+        switch (f)
+        {
+            case KeywordScope::eGlobal:
+                return 0;
+            case KeywordScope::ePass:
+                return 1;
+            case KeywordScope::eMaterial:
+                return 2;
+            case KeywordScope::eShaderLocal:
+                return 3;
+        }
+        return 3;
+    }
+
+    static bool parse_u32(std::string_view s, uint32_t& out)
+    {
+        if (s.empty())
+            return false;
+        uint32_t v = 0;
+        for (char c : s)
+        {
+            if (c < '0' || c > '9')
+                return false;
+            v = v * 10u + static_cast<uint32_t>(c - '0');
+        }
+        out = v;
+        return true;
+    }
+
+    const BindingTableEntry* BindingTable::find(std::string_view name) const
+    {
+        for (const auto& e : entries)
+        {
+            if (e.name == name)
+                return &e;
+        }
+        return nullptr;
+    }
+
+    Result<BindingTable> parse_binding_table(std::string_view text)
+    {
+        struct Pending
+        {
+            BindingTableEntry entry;
+            bool              hasBinding = false;
+            size_t            lineNo     = 0;
+        };
+
+        std::vector<Pending> pending;
+
+        std::istringstream iss((std::string(text)));
+        std::string        line;
+        size_t             lineNo = 0;
+
+        while (std::getline(iss, line))
+        {
+            ++lineNo;
+
+            // tokenize by whitespace
+            std::vector<std::string_view> toks;
+            {
+                std::string_view s(line);
+                size_t           k = 0;
+                while (k < s.size())
+                {
+                    while (k < s.size() && std::isspace(static_cast<unsigned char>(s[k])))
+                        ++k;
+                    if (k >= s.size())
+                        break;
+                    size_t k2 = k;
+                    while (k2 < s.size() && !std::isspace(static_cast<unsigned char>(s[k2])))
+                        ++k2;
+                    toks.push_back(s.substr(k, k2 - k));
+                    k = k2;
+                }
+            }
+            if (toks.empty() || toks[0].front() == '#')
+                continue;
+
+            const std::string where = "vbt line " + std::to_string(lineNo) + ": ";
+
+            if (toks[0] != "resource")
+                return Result<BindingTable>::err(
+                    {ErrorCode::eParseError, where + "unknown directive: " + std::string(toks[0])});
+
+            if (toks.size() < 3)
+                return Result<BindingTable>::err(
+                    {ErrorCode::eParseError, where + "resource requires <frequency> <NAME>."});
+
+            Pending p;
+            p.lineNo = lineNo;
+
+            if (!parse_frequency(toks[1], p.entry.frequency))
+                return Result<BindingTable>::err(
+                    {ErrorCode::eParseError, where + "unknown frequency: " + std::string(toks[1])});
+
+            p.entry.name = std::string(toks[2]);
+            p.entry.set  = default_set_for(p.entry.frequency);
+
+            for (size_t i = 3; i < toks.size(); ++i)
+            {
+                const auto eq = toks[i].find('=');
+                const auto k  = toks[i].substr(0, eq);
+                const auto v  = eq == std::string_view::npos ? std::string_view {} : toks[i].substr(eq + 1);
+
+                if (k == "set" && parse_u32(v, p.entry.set))
+                    continue;
+                if (k == "binding" && parse_u32(v, p.entry.binding))
+                {
+                    p.hasBinding = true;
+                    continue;
+                }
+
+                return Result<BindingTable>::err(
+                    {ErrorCode::eParseError, where + "invalid attribute: " + std::string(toks[i])});
+            }
+
+            for (const auto& q : pending)
+            {
+                if (q.entry.name == p.entry.name)
+                    return Result<BindingTable>::err(
+                        {ErrorCode::eParseError, where + "duplicate resource: " + p.entry.name});
+            }
+
+            pending.push_back(std::move(p));
+        }
+
+        // Explicit bindings first, then fill the remaining ones in file order.
+        std::set<std::pair<uint32_t, uint32_t>> taken;
+        for (const auto& p : pending)
+        {
+            if (!p.hasBinding)
+                continue;
+            if (!taken.insert({p.entry.set, p.entry.binding}).second)
+                return Result<BindingTable>::err({ErrorCode::eParseError,
+                                                  "vbt line " + std::to_string(p.lineNo) + ": set " +
+                                                      std::to_string(p.entry.set) + " binding " +
+                                                      std::to_string(p.entry.binding) + " is already assigned"});
+        }
+
+        std::map<uint32_t, uint32_t> nextBinding;
+
+        BindingTable out;
+        out.entries.reserve(pending.size());
+        for (auto& p : pending)
+        {
+            if (!p.hasBinding)
+            {
+                uint32_t& next = nextBinding[p.entry.set];
+                while (taken.count({p.entry.set, next}))
+                    ++next;
+                p.entry.binding = next;
+                taken.insert({p.entry.set, next});
+            }
+            out.entries.push_back(std::move(p.entry));
+        }
+
+        return Result<BindingTable>::ok(std::move(out));
+    }
+
+    Result<BindingTable> load_binding_table(const std::string& filePath)
+    {
+        std::ifstream f(filePath, std::ios::binary);
+        if (!f)
+            return Result<BindingTable>::err({ErrorCode::eIO, "Failed to open binding table: " + filePath});
+
+        f.seekg(0, std::ios::end);
+        const auto size = static_cast<size_t>(f.tellg());
+        f.seekg(0, std::ios::beg);
+
+        std::string text;
+        text.resize(size);
+        f.read(text.data(), static_cast<std::streamsize>(size));
+        if (!f)
+            return Result<BindingTable>::err({ErrorCode::eIO, "Failed to read binding table: " + filePath});
+
+        return parse_binding_table(text);
+    }
+
+    // ------------------------------------------------------------
+    // SPIR-V patching
+    // ------------------------------------------------------------
+    static std::string read_literal_string(const uint32_t* words, size_t count)
+    {
+        std::string s;
+        for (size_t w = 0; w < count; ++w)
+        {
+            for (int b = 0; b < 4; ++b)
+            {
+                const char c = static_cast<char>((words[w] >> (8 * b)) & 0xFFu);
+                if (c == '\0')
+                    return s;
+                s.push_back(c);
+            }
+        }
+        return s;
+    }
+
+    Result<uint32_t> apply_binding_table(std::vector<uint32_t>& spirv, const BindingTable& table)
+    {
+        constexpr size_t kHeaderWords = 5;
+
+        if (spirv.size() < kHeaderWords || spirv[0] != spv::MagicNumber)
+            return Result<uint32_t>::err({ErrorCode::eInvalidArgument, "Invalid SPIR-V module header."});
+
+        struct Resource
+        {
+            size_t   setWord     = 0; // index of the DescriptorSet literal, 0 = none
+            size_t   bindingWord = 0; // index of the Binding literal, 0 = none
+            uint32_t typeId      = 0; // pointer type of the variable
+        };
+
+        std::unordered_map<uint32_t, std::string> names;
+        std::unordered_map<uint32_t, Resource>    resources;
+        std::unordered_map<uint32_t, uint32_t>    pointee; // pointer/array type -> element type
+
+        // Pass 1: collect names, decorations, type chains and variables.
+        for (size_t i = kHeaderWords; i < spirv.size();)
+        {
+            const uint32_t wordCount = spirv[i] >> 16;
+            const uint32_t op        = spirv[i] & 0xFFFFu;
+            if (wordCount == 0 || i + wordCount > spirv.size())
+                return Result<uint32_t>::err({ErrorCode::eInvalidArgument, "Malformed SPIR-V instruction stream."});
+
+            if (op == spv::OpName && wordCount >= 3)
+            {
+                names[spirv[i + 1]] = read_literal_string(&spirv[i + 2], wordCount - 2);
+            }
+            else if (op == spv::OpDecorate && wordCount >= 4)
+            {
+                if (spirv[i + 2] == spv::DecorationDescriptorSet)
+                    resources[spirv[i + 1]].setWord = i + 3;
+                else if (spirv[i + 2] == spv::DecorationBinding)
+                    resources[spirv[i + 1]].bindingWord = i + 3;
+            }
+            else if (op == spv::OpTypePointer && wordCount >= 4)
+            {
+                pointee[spirv[i + 1]] = spirv[i + 3];
+            }
+            else if ((op == spv::OpTypeArray || op == spv::OpTypeRuntimeArray) && wordCount >= 3)
+            {
+                pointee[spirv[i + 1]] = spirv[i + 2];
+            }
+            else if (op == spv::OpVariable && wordCount >= 4)
+            {
+                auto it = resources.find(spirv[i + 2]);
+                if (it != resources.end())
+                    it->second.typeId = spirv[i + 1];
+            }
+            else if (op == spv::OpFunction)
+            {
+                break; // annotations, types and globals all precede function bodies
+            }
+
+            i += wordCount;
+        }
+
+        auto name_of = [&](uint32_t id) -> const std::string* {
+            auto it = names.find(id);
+            return (it != names.end() && !it->second.empty()) ? &it->second : nullptr;
+        };
+
+        // Pass 2: look up each decorated variable by its block/type name, then its instance name.
+        struct Slot
+        {
+            uint32_t id     = 0;
+            bool     mapped = false;
+        };
+
+        uint32_t                                      remapped = 0;
+        std::map<std::pair<uint32_t, uint32_t>, Slot> slots; // (set, binding) -> variable
+
+        for (auto& [id, res] : resources)
+        {
+            if (res.setWord == 0 || res.bindingWord == 0)
+                continue;
+
+            const BindingTableEntry* entry = nullptr;
+
+            // Walk pointer -> (array ->) element type, trying each name on the way.
+            for (uint32_t t = res.typeId; t != 0 && !entry;)
+            {
+                if (const auto* n = name_of(t))
+                    entry = table.find(*n);
+                auto pt = pointee.find(t);
+                t       = (pt != pointee.end()) ? pt->second : 0;
+            }
+            if (!entry)
+            {
+                if (const auto* n = name_of(id))
+                    entry = table.find(*n);
+            }
+
+            if (entry)
+            {
+                if (spirv[res.setWord] != entry->set || spirv[res.bindingWord] != entry->binding)
+                    ++remapped;
+                spirv[res.setWord]     = entry->set;
+                spirv[res.bindingWord] = entry->binding;
+            }
+
+            // Aliasing that already existed in the source is left alone; only report clashes we introduced.
+            const auto slot     = std::make_pair(spirv[res.setWord], spirv[res.bindingWord]);
+            auto [it, inserted] = slots.emplace(slot, Slot {id, entry != nullptr});
+            if (!inserted && (entry || it->second.mapped))
+            {
+                const auto* a = name_of(it->second.id);
+                const auto* b = name_of(id);
+                return Result<uint32_t>::err(
+                    {ErrorCode::eInvalidArgument,
+                     "Binding table maps '" + (a ? *a : std::to_string(it->second.id)) + "' and '" +
+                         (b ? *b : std::to_string(id)) + "' to set " + std::to_string(slot.first) + " binding " +
+                         std::to_string(slot.second) + "."});
+            }
+        }
+
+        return Result<uint32_t>::ok(remapped);
+    }
+} // namespace vshadersystem
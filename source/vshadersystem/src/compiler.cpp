@@ -1,4 +1,5 @@
 #include "vshadersystem/compiler.hpp"
+#include "vshadersystem/hash.hpp"
 #include "vshadersystem/result.hpp"
 
 #include <glslang/Include/ResourceLimits.h>
@@ -6,12 +7,15 @@
 #include <glslang/SPIRV/GlslangToSpv.h>
 
 #include <cassert>
+#include <cctype>
 #include <cstdint>
 #include <cstring>
 #include <filesystem>
 #include <fstream>
 #include <mutex>
 #include <string>
+#include <string_view>
+#include <unordered_map>
 #include <unordered_set>
 #include <utility>
 #include <vector>
@@ -64,35 +68,6 @@ namespace vshadersystem
         }
     }
 
-    static const char* stage_name(ShaderStage s)
-    {
-        switch (s)
-        {
-            case ShaderStage::eVert:
-                return "vert";
-            case ShaderStage::eFrag:
-                return "frag";
-            case ShaderStage::eComp:
-                return "comp";
-            case ShaderStage::eTask:
-                return "task";
-            case ShaderStage::eMesh:
-                return "mesh";
-            case ShaderStage::eRgen:
-                return "rgen";
-            case ShaderStage::eRmiss:
-                return "rmiss";
-            case ShaderStage::eRchit:
-                return "rchit";
-            case ShaderStage::eRahit:
-                return "rahit";
-            case ShaderStage::eRint:
-                return "rint";
-            default:
-                return "unknown";
-        }
-    }
-
     // ------------------------------------------------------------
     // Default resources (portable across glslang packaging)
     //
@@ -252,6 +227,155 @@ namespace vshadersystem
             return canon;
         }
 
+        // ------------------------------------------------------------
+        // Include guard detection (multiple-include optimization)
+        // ------------------------------------------------------------
+        std::string strip_comments(std::string_view text)
+        {
+            // Comments become spaces; newlines are kept so directives stay on their own lines.
+            std::string out;
+            out.reserve(text.size());
+
+            for (size_t i = 0; i < text.size(); ++i)
+            {
+                const char c    = text[i];
+                const char next = i + 1 < text.size() ? text[i + 1] : '\0';
+                if (c == '/' && next == '/')
+                {
+                    while (i < text.size() && text[i] != '\n')
+                        ++i;
+                    out.push_back('\n');
+                }
+                else if (c == '/' && next == '*')
+                {
+                    i += 2;
+                    while (i < text.size() && !(text[i] == '*' && i + 1 < text.size() && text[i + 1] == '/'))
+                    {
+                        if (text[i] == '\n')
+                            out.push_back('\n');
+                        ++i;
+                    }
+                    ++i;
+                    out.push_back(' ');
+                }
+                else
+                {
+                    out.push_back(c);
+                }
+            }
+            return out;
+        }
+
+        std::string_view trim_view(std::string_view s)
+        {
+            while (!s.empty() && std::isspace(static_cast<unsigned char>(s.front())))
+                s.remove_prefix(1);
+            while (!s.empty() && std::isspace(static_cast<unsigned char>(s.back())))
+                s.remove_suffix(1);
+            return s;
+        }
+
+        // Splits "#  name  rest" into name and rest; false for lines that are not directives.
+        bool split_directive(std::string_view line, std::string_view& name, std::string_view& rest)
+        {
+            if (line.empty() || line.front() != '#')
+                return false;
+
+            line        = trim_view(line.substr(1));
+            size_t nEnd = 0;
+            while (nEnd < line.size() && (std::isalnum(static_cast<unsigned char>(line[nEnd])) || line[nEnd] == '_'))
+                ++nEnd;
+
+            name = line.substr(0, nEnd);
+            rest = trim_view(line.substr(nEnd));
+            return true;
+        }
+
+        std::string_view first_identifier(std::string_view s)
+        {
+            size_t n = 0;
+            while (n < s.size() && (std::isalnum(static_cast<unsigned char>(s[n])) || s[n] == '_'))
+                ++n;
+            return s.substr(0, n);
+        }
+
+        void detect_include_guard(std::string_view text, IncludeCache::File& file)
+        {
+            file.guardMacro.clear();
+            file.pragmaOnce = false;
+            file.undefs.clear();
+
+            const std::string code = strip_comments(text);
+
+            // Classic guard state: 0 = expect #ifndef, 1 = expect #define, 2 = inside, 3 = closed, -1 = none.
+            // depth is the #if nesting before the current line, tracked in every state, so a #pragma once
+            // under a conditional is not taken for an unconditional one.
+            int              state = 0;
+            int              depth = 0;
+            std::string_view macro;
+
+            size_t i = 0;
+            while (i < code.size())
+            {
+                size_t j = code.find('\n', i);
+                if (j == std::string::npos)
+                    j = code.size();
+                const std::string_view line = trim_view(std::string_view(code).substr(i, j - i));
+                i                           = j + 1;
+
+                if (line.empty())
+                    continue;
+
+                std::string_view name;
+                std::string_view rest;
+                const bool       isDirective = split_directive(line, name, rest);
+                const bool       opensIf     = isDirective && (name == "if" || name == "ifdef" || name == "ifndef");
+                const bool       closesIf    = isDirective && name == "endif";
+
+                if (isDirective && name == "undef")
+                    file.undefs.emplace_back(first_identifier(rest));
+                if (isDirective && name == "pragma" && rest == "once" && depth == 0)
+                    file.pragmaOnce = true;
+
+                switch (state)
+                {
+                    case 0:
+                        if (isDirective && name == "ifndef" && !first_identifier(rest).empty())
+                        {
+                            macro = first_identifier(rest);
+                            state = 1;
+                        }
+                        else
+                        {
+                            state = -1;
+                        }
+                        break;
+                    case 1:
+                        state = (isDirective && name == "define" && first_identifier(rest) == macro) ? 2 : -1;
+                        break;
+                    case 2:
+                        if (closesIf && depth == 1)
+                            state = 3;
+                        else if (depth == 1 && isDirective && (name == "else" || name == "elif"))
+                            state = -1;
+                        break;
+                    case 3:
+                        state = -1; // something follows the closing #endif
+                        break;
+                    default:
+                        break;
+                }
+
+                if (opensIf)
+                    ++depth;
+                else if (closesIf && depth > 0)
+                    --depth;
+            }
+
+            if (state == 3)
+                file.guardMacro = std::string(macro);
+        }
+
         // We build a preamble that:
         // - Enables include directives for glslang (#include "file")
         // - Enables cpp-style line directives for better error reporting
@@ -286,16 +410,24 @@ namespace vshadersystem
         // Resolution strategy:
         // 1) If headerName is absolute and exists -> use it.
         // 2) If includerName looks like a file path -> try includer directory first (relative include behavior).
-        // 3) Try rootDir (virtual file's parent) + opt.includeDirs in order.
+        // 3) Try rootDir (virtual file's parent) + opt.includeDirList() in order.
         //
         // Dependencies are stored as canonical-ish absolute paths where possible.
         // ------------------------------------------------------------
         class RecordingIncluder final : public glslang::TShader::Includer
         {
         public:
-            RecordingIncluder(std::filesystem::path rootFilePath, std::vector<std::string> extraIncludeDirs) :
-                m_RootFilePath(std::move(rootFilePath))
+            RecordingIncluder(std::filesystem::path    rootFilePath,
+                              std::string_view         rootSource,
+                              std::vector<std::string> extraIncludeDirs,
+                              IncludeCache*            cache) :
+                m_RootFilePath(std::move(rootFilePath)), m_Cache(cache)
             {
+                // A guard is only trusted while nothing #undefs it; the root source counts too.
+                IncludeCache::File root;
+                detect_include_guard(rootSource, root);
+                m_Undefs.insert(root.undefs.begin(), root.undefs.end());
+
                 // Root file directory (highest priority)
                 if (!m_RootFilePath.empty())
                 {
@@ -313,6 +445,7 @@ namespace vshadersystem
             }
 
             const std::vector<std::string>& dependencies() const { return m_Dependencies; }
+            const std::vector<uint64_t>&    dependencyHashes() const { return m_DependencyHashes; }
 
             IncludeResult*
             includeSystem(const char* headerName, const char* includerName, size_t /*inclusionDepth*/) override
@@ -330,7 +463,7 @@ namespace vshadersystem
             {
                 if (!result)
                     return;
-                delete[] static_cast<char*>(result->userData);
+                delete static_cast<std::shared_ptr<const std::string>*>(result->userData);
                 delete result;
             }
 
@@ -344,25 +477,48 @@ namespace vshadersystem
                 if (!resolve(headerName, includerName, resolved))
                     return nullptr;
 
-                std::string content;
-                if (!read_text_file(resolved, content))
-                    return nullptr;
+                const auto norm = normalize_dep_path(resolved).string();
+
+                // Already included and guarded: glslang would lex the whole file only to skip it.
+                auto guarded = m_Guards.find(norm);
+                if (guarded != m_Guards.end() && (guarded->second.empty() || !m_Undefs.contains(guarded->second)))
+                    return new IncludeResult(resolved.string(), "", 0, nullptr);
+
+                IncludeCache::File file;
+                if (m_Cache)
+                {
+                    if (!m_Cache->load(resolved, file))
+                        return nullptr;
+                }
+                else
+                {
+                    auto content = std::make_shared<std::string>();
+                    if (!read_text_file(resolved, *content))
+                        return nullptr;
+                    file.hash = xxhash64(*content);
+                    detect_include_guard(*content, file);
+                    file.text = std::move(content);
+                }
 
                 // Record dependency
+                if (m_DepSet.insert(norm).second)
                 {
-                    const auto norm = normalize_dep_path(resolved).string();
-                    if (m_DepSet.insert(norm).second)
-                        m_Dependencies.push_back(norm);
+                    m_Dependencies.push_back(norm);
+                    m_DependencyHashes.push_back(file.hash);
                 }
 
-                // Keep file content alive until releaseInclude()
-                const size_t n    = content.size();
-                char*        data = new char[n + 1];
-                std::memcpy(data, content.data(), n);
-                data[n] = '\0';
+                // Empty key = #pragma once, which no #undef can reopen.
+                m_Undefs.insert(file.undefs.begin(), file.undefs.end());
+                if (file.pragmaOnce)
+                    m_Guards[norm].clear();
+                else if (!file.guardMacro.empty())
+                    m_Guards.emplace(norm, file.guardMacro);
+
+                // Keep file content alive until releaseInclude(); cached text is shared, not copied.
+                auto* holder = new std::shared_ptr<const std::string>(std::move(file.text));
 
                 // Store resolved path as "headerName" for better diagnostics
-                return new IncludeResult(resolved.string(), data, n, data);
+                return new IncludeResult(resolved.string(), (*holder)->data(), (*holder)->size(), holder);
             }
 
             bool resolve(const char* headerName, const char* includerName, std::filesystem::path& out)
@@ -414,12 +570,59 @@ namespace vshadersystem
         private:
             std::filesystem::path              m_RootFilePath;
             std::vector<std::filesystem::path> m_SearchDirs;
+            IncludeCache*                      m_Cache = nullptr;
 
             std::vector<std::string>        m_Dependencies;
+            std::vector<uint64_t>           m_DependencyHashes;
             std::unordered_set<std::string> m_DepSet;
+
+            std::unordered_map<std::string, std::string> m_Guards; // dependency path -> guard macro ("" = once)
+            std::unordered_set<std::string>              m_Undefs;
         };
     } // namespace
 
+    // ------------------------------------------------------------
+    // IncludeCache
+    // ------------------------------------------------------------
+    bool IncludeCache::load(const std::filesystem::path& path, File& outFile)
+    {
+        std::error_code ec;
+        const auto      mtime = std::filesystem::last_write_time(path, ec);
+        if (ec)
+            return false;
+        const auto size = std::filesystem::file_size(path, ec);
+        if (ec)
+            return false;
+
+        const std::string key = path.generic_string();
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            auto                        it = m_Entries.find(key);
+            if (it != m_Entries.end() && it->second.mtime == mtime && it->second.size == size)
+            {
+                outFile = it->second.file;
+                return true;
+            }
+        }
+
+        auto text = std::make_shared<std::string>();
+        if (!read_text_file(path, *text))
+            return false;
+
+        File file;
+        file.hash = xxhash64(*text);
+        detect_include_guard(*text, file);
+        file.text = std::move(text);
+
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_Entries[key] = {mtime, size, file};
+        }
+
+        outFile = std::move(file);
+        return true;
+    }
+
     // ------------------------------------------------------------
     // Public API
     // ------------------------------------------------------------
@@ -437,8 +640,8 @@ namespace vshadersystem
         glslang::TShader shader(stage);
 
         // Give glslang a stable "file name" for diagnostics and includerName.
-        const char* strings[] = {input.sourceText.c_str()};
-        const int   lengths[] = {static_cast<int>(input.sourceText.size())};
+        const char* strings[] = {input.text().c_str()};
+        const int   lengths[] = {static_cast<int>(input.text().size())};
         const char* names[]   = {input.virtualPath.c_str()};
         shader.setStringsWithLengthsAndNames(strings, lengths, names, 1);
 
@@ -453,12 +656,17 @@ namespace vshadersystem
         shader.setEnvClient(glslang::EShClientVulkan, glslang::EShTargetVulkan_1_2);
         shader.setEnvTarget(glslang::EShTargetSpv, glslang::EShTargetSpv_1_5);
 
+        // Linkable module: defined functions are exported, bodiless prototypes imported.
+        if (opt.compileOnly)
+            shader.setCompileOnly();
+
         // Preamble: include directives + defines.
         const std::string preamble = build_preamble(opt);
         shader.setPreamble(preamble.empty() ? nullptr : preamble.c_str());
 
         // Include + dependency recording.
-        RecordingIncluder includer(std::filesystem::path(input.virtualPath), opt.includeDirs);
+        RecordingIncluder includer(
+            std::filesystem::path(input.virtualPath), input.text(), opt.includeDirList(), opt.includeCache);
 
         // Messages: keep Vulkan/SPIR-V rules. Cascading errors improves logs.
         constexpr auto kMessages =
@@ -476,7 +684,7 @@ namespace vshadersystem
         {
             std::string log;
             log += "glslang parse failed for stage ";
-            log += stage_name(opt.stage);
+            log += shader_stage_name(opt.stage);
             log += ":\n";
             log += shader.getInfoLog();
             log += shader.getInfoDebugLog();
@@ -492,7 +700,7 @@ namespace vshadersystem
         {
             std::string log;
             log += "glslang link failed for stage ";
-            log += stage_name(opt.stage);
+            log += shader_stage_name(opt.stage);
             log += ":\n";
             log += program.getInfoLog();
             log += program.getInfoDebugLog();
@@ -518,10 +726,68 @@ namespace vshadersystem
         glslang::GlslangToSpv(*intermediate, spirv, &logger, &spvOptions);
 
         CompileOutput out;
-        out.spirv        = std::move(spirv);
-        out.infoLog      = logger.getAllMessages();
-        out.dependencies = includer.dependencies();
+        out.spirv            = std::move(spirv);
+        out.infoLog          = logger.getAllMessages();
+        out.dependencies     = includer.dependencies();
+        out.dependencyHashes = includer.dependencyHashes();
 
         return Result<CompileOutput>::ok(std::move(out));
     }
+
+    Result<std::vector<std::string>> scan_dependencies(const SourceInput& input, const CompileOptions& opt)
+    {
+        ensure_glslang_initialized();
+
+        if (input.virtualPath.empty())
+        {
+            return Result<std::vector<std::string>>::err(
+                {ErrorCode::eInvalidArgument, "virtualPath must not be empty."});
+        }
+
+        const EShLanguage stage = to_esh_language(opt.stage);
+
+        glslang::TShader shader(stage);
+
+        const char* strings[] = {input.text().c_str()};
+        const int   lengths[] = {static_cast<int>(input.text().size())};
+        const char* names[]   = {input.virtualPath.c_str()};
+        shader.setStringsWithLengthsAndNames(strings, lengths, names, 1);
+
+        shader.setEntryPoint("main");
+        shader.setSourceEntryPoint("main");
+        shader.setOverrideVersion(460);
+
+        shader.setEnvInput(glslang::EShSourceGlsl, stage, glslang::EShClientVulkan, 100);
+        shader.setEnvClient(glslang::EShClientVulkan, glslang::EShTargetVulkan_1_2);
+        shader.setEnvTarget(glslang::EShTargetSpv, glslang::EShTargetSpv_1_5);
+
+        const std::string preamble = build_preamble(opt);
+        shader.setPreamble(preamble.empty() ? nullptr : preamble.c_str());
+
+        RecordingIncluder includer(
+            std::filesystem::path(input.virtualPath), input.text(), opt.includeDirList(), opt.includeCache);
+
+        // Preprocess only: resolves #include under the same defines as a real compile, without codegen.
+        std::string preprocessed;
+        if (!shader.preprocess(&kDefaultResources,
+                               110,
+                               ENoProfile,
+                               false,
+                               false,
+                               EShMessages {EShMsgDefault | EShMsgSpvRules | EShMsgVulkanRules},
+                               &preprocessed,
+                               includer))
+        {
+            std::string log;
+            log += "glslang preprocess failed for stage ";
+            log += shader_stage_name(opt.stage);
+            log += ":\n";
+            log += shader.getInfoLog();
+            log += shader.getInfoDebugLog();
+
+            return Result<std::vector<std::string>>::err({ErrorCode::eCompileError, std::move(log)});
+        }
+
+        return Result<std::vector<std::string>>::ok(includer.dependencies());
+    }
 } // namespace vshadersystem
\ No newline at end of file
@@ -0,0 +1,263 @@
+#include "vshadersystem/deps.hpp"
+#include "vshadersystem/hash.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <string_view>
+
+namespace vshadersystem
+{
+    static constexpr uint32_t kGraphVersion = 3;
+
+    std::filesystem::path resolve_project_root(const std::string& projectRoot)
+    {
+        std::error_code ec;
+        auto            root =
+            projectRoot.empty() ? std::filesystem::current_path(ec) : std::filesystem::path(projectRoot);
+        if (ec)
+            return {};
+
+        auto canon = std::filesystem::weakly_canonical(root, ec);
+        return ec ? root : canon;
+    }
+
+    std::string make_portable_path(const std::string& path, const std::filesystem::path& root)
+    {
+        std::filesystem::path p(path);
+        if (!p.is_absolute() || root.empty())
+            return p.generic_string();
+
+        std::error_code ec;
+        auto            canon = std::filesystem::weakly_canonical(p, ec);
+        if (ec)
+            canon = p.lexically_normal();
+
+        auto rel = canon.lexically_relative(root);
+        if (rel.empty() || *rel.begin() == "..")
+            return canon.generic_string();
+        return rel.generic_string();
+    }
+
+    // ------------------------------------------------------------
+    // FileHashCache
+    // ------------------------------------------------------------
+    bool FileHashCache::hash(const std::filesystem::path& path, uint64_t& outHash)
+    {
+        std::error_code ec;
+        const auto      mtime = std::filesystem::last_write_time(path, ec);
+        if (ec)
+            return false;
+        const auto size = std::filesystem::file_size(path, ec);
+        if (ec)
+            return false;
+
+        const std::string key = path.generic_string();
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            auto                        it = m_Entries.find(key);
+            if (it != m_Entries.end() && it->second.mtime == mtime && it->second.size == size)
+            {
+                outHash = it->second.hash;
+                return true;
+            }
+        }
+
+        std::ifstream f(path, std::ios::binary);
+        if (!f)
+            return false;
+
+        std::string text;
+        text.resize(static_cast<size_t>(size));
+        f.read(text.data(), static_cast<std::streamsize>(size));
+        if (!f)
+            return false;
+
+        outHash = xxhash64(text);
+
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Entries[key] = Entry {mtime, size, outHash};
+        return true;
+    }
+
+    // ------------------------------------------------------------
+    // DependencyGraph
+    // ------------------------------------------------------------
+    static bool node_before(const DependencyGraphNode& n, const std::string& virtualPath)
+    {
+        return n.virtualPath < virtualPath;
+    }
+
+    void DependencyGraph::setShader(DependencyGraphNode node)
+    {
+        std::sort(node.includes.begin(), node.includes.end());
+        node.includes.erase(std::unique(node.includes.begin(), node.includes.end()), node.includes.end());
+
+        auto it = std::lower_bound(m_Shaders.begin(), m_Shaders.end(), node.virtualPath, node_before);
+
+        if (it != m_Shaders.end() && it->virtualPath == node.virtualPath)
+            *it = std::move(node);
+        else
+            m_Shaders.insert(it, std::move(node));
+    }
+
+    const DependencyGraphNode* DependencyGraph::findShader(const std::string& virtualPath) const
+    {
+        auto it = std::lower_bound(m_Shaders.begin(), m_Shaders.end(), virtualPath, node_before);
+        if (it == m_Shaders.end() || it->virtualPath != virtualPath)
+            return nullptr;
+        return &*it;
+    }
+
+    std::vector<std::string> DependencyGraph::includeFiles() const
+    {
+        std::vector<std::string> out;
+        for (const auto& n : m_Shaders)
+            out.insert(out.end(), n.includes.begin(), n.includes.end());
+
+        std::sort(out.begin(), out.end());
+        out.erase(std::unique(out.begin(), out.end()), out.end());
+        return out;
+    }
+
+    DependencyImpact DependencyGraph::impactOf(const std::string& path) const
+    {
+        DependencyImpact out;
+
+        for (const auto& n : m_Shaders)
+        {
+            const bool hit =
+                (n.path == path) || std::binary_search(n.includes.begin(), n.includes.end(), path);
+            if (!hit)
+                continue;
+
+            out.shaders.push_back(&n);
+            out.variants += n.variantCount;
+
+            if (n.avgCompileMs > 0.0)
+                out.estimatedMs += n.avgCompileMs * static_cast<double>(n.variantCount);
+            else
+                out.untimedVariants += n.variantCount;
+        }
+
+        return out;
+    }
+
+    Result<void> DependencyGraph::save(const std::string& filePath) const
+    {
+        std::ofstream f(filePath, std::ios::binary | std::ios::trunc);
+        if (!f)
+            return Result<void>::err({ErrorCode::eIO, "Failed to open dependency graph for write: " + filePath});
+
+        f << "vshdeps\t" << kGraphVersion << "\n";
+        if (!m_ProjectRoot.empty())
+            f << "R\t" << m_ProjectRoot << "\n";
+        for (const auto& n : m_Shaders)
+        {
+            f << "S\t" << n.virtualPath << "\t" << n.path << "\t" << n.variantCount << "\t" << n.avgCompileMs << "\t"
+              << n.inputsHash << "\n";
+            for (const auto& inc : n.includes)
+                f << "I\t" << inc << "\n";
+        }
+
+        if (!f)
+            return Result<void>::err({ErrorCode::eIO, "Failed to write dependency graph: " + filePath});
+
+        return Result<void>::ok();
+    }
+
+    static void split_tabs(std::string_view line, std::vector<std::string_view>& out)
+    {
+        out.clear();
+        size_t i = 0;
+        while (true)
+        {
+            size_t j = line.find('\t', i);
+            if (j == std::string_view::npos)
+            {
+                out.push_back(line.substr(i));
+                return;
+            }
+            out.push_back(line.substr(i, j - i));
+            i = j + 1;
+        }
+    }
+
+    Result<DependencyGraph> DependencyGraph::load(const std::string& filePath)
+    {
+        std::ifstream f(filePath, std::ios::binary);
+        if (!f)
+            return Result<DependencyGraph>::err({ErrorCode::eIO, "Failed to open dependency graph: " + filePath});
+
+        DependencyGraph               g;
+        DependencyGraphNode           cur;
+        bool                          hasCur = false;
+        std::string                   line;
+        std::vector<std::string_view> cols;
+
+        if (!std::getline(f, line))
+            return Result<DependencyGraph>::err({ErrorCode::eParseError, "Empty dependency graph: " + filePath});
+
+        // Header and body lines are read the same way, so a CRLF checkout of the file still loads.
+        if (!line.empty() && line.back() == '\r')
+            line.pop_back();
+        split_tabs(line, cols);
+
+        const std::string versionText = cols.size() == 2 ? std::string(cols[1]) : std::string();
+        char*             versionEnd  = nullptr;
+        const uint32_t    version     = static_cast<uint32_t>(std::strtoul(versionText.c_str(), &versionEnd, 10));
+        if (cols[0] != "vshdeps" || versionText.empty() || *versionEnd != '\0' || version == 0 ||
+            version > kGraphVersion)
+            return Result<DependencyGraph>::err(
+                {ErrorCode::eParseError, "Unsupported dependency graph version: " + filePath});
+        const size_t shaderColumns = version >= 2 ? 6 : 5;
+
+        while (std::getline(f, line))
+        {
+            if (!line.empty() && line.back() == '\r')
+                line.pop_back();
+            if (line.empty())
+                continue;
+
+            split_tabs(line, cols);
+
+            if (cols[0] == "R" && cols.size() == 2)
+            {
+                g.m_ProjectRoot = std::string(cols[1]);
+            }
+            else if (cols[0] == "S" && cols.size() == shaderColumns)
+            {
+                if (hasCur)
+                    g.setShader(std::move(cur));
+
+                cur              = {};
+                cur.virtualPath  = std::string(cols[1]);
+                cur.path         = std::string(cols[2]);
+                cur.variantCount = static_cast<uint32_t>(std::strtoul(std::string(cols[3]).c_str(), nullptr, 10));
+                cur.avgCompileMs = std::strtod(std::string(cols[4]).c_str(), nullptr);
+                if (shaderColumns > 5)
+                    cur.inputsHash = std::strtoull(std::string(cols[5]).c_str(), nullptr, 10);
+                hasCur = true;
+            }
+            else if (cols[0] == "I" && cols.size() == 2 && hasCur)
+            {
+                cur.includes.emplace_back(cols[1]);
+            }
+            else
+            {
+                return Result<DependencyGraph>::err(
+                    {ErrorCode::eParseError, "Malformed dependency graph line: " + line});
+            }
+        }
+
+        if (hasCur)
+            g.setShader(std::move(cur));
+
+        return Result<DependencyGraph>::ok(std::move(g));
+    }
+
+    std::string dependency_graph_path(const std::string& cacheDir)
+    {
+        return (std::filesystem::path(cacheDir) / "deps.graph").string();
+    }
+} // namespace vshadersystem
@@ -0,0 +1,31 @@
+#include "vshadersystem/executor.hpp"
+
+#include <utility>
+
+namespace vshadersystem
+{
+    void TaskGroup::run(std::function<void()> task)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            ++m_Pending;
+        }
+
+        m_Executor.submit(
+            [this, task = std::move(task)]() {
+                task();
+
+                // Notify under the lock: once m_Pending reaches 0 the waiter may destroy the group.
+                std::lock_guard<std::mutex> lock(m_Mutex);
+                if (--m_Pending == 0)
+                    m_Done.notify_all();
+            },
+            m_Priority);
+    }
+
+    void TaskGroup::wait()
+    {
+        std::unique_lock<std::mutex> lock(m_Mutex);
+        m_Done.wait(lock, [this]() { return m_Pending == 0; });
+    }
+} // namespace vshadersystem
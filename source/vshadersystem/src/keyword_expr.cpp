@@ -106,14 +106,11 @@ namespace vshadersystem
 
         struct Parser
         {
-            Lexer                      lex;
-            Token                      cur;
-            const KeywordValueContext& ctx;
+            Lexer        lex;
+            Token        cur;
+            KeywordExpr& out;
 
-            explicit Parser(std::string_view text, const KeywordValueContext& c) : lex {Lexer {text, 0}}, ctx(c)
-            {
-                cur = lex.next();
-            }
+            explicit Parser(std::string_view text, KeywordExpr& o) : lex {Lexer {text, 0}}, out(o) { cur = lex.next(); }
 
             void consume(Token::Kind k)
             {
@@ -121,127 +118,200 @@ namespace vshadersystem
                 cur = lex.next();
             }
 
-            Result<uint32_t> resolveIdent(const std::string& name)
+            uint32_t add(KeywordExprNode n)
             {
-                // true/false
-                if (name == "true" || name == "TRUE" || name == "True")
-                    return Result<uint32_t>::ok(1);
-                if (name == "false" || name == "FALSE" || name == "False")
-                    return Result<uint32_t>::ok(0);
-
-                // keyword value
-                auto it = ctx.values.find(name);
-                if (it != ctx.values.end())
-                    return Result<uint32_t>::ok(it->second);
-
-                // enumerant lookup: try against all enum keyword decls (small set)
-                // This supports constraints like SURFACE==CUTOUT.
-                for (const auto& [kname, decl] : ctx.decls)
-                {
-                    if (!decl)
-                        continue;
-                    if (decl->kind != KeywordValueKind::eEnum)
-                        continue;
-                    for (uint32_t i = 0; i < static_cast<uint32_t>(decl->enumValues.size()); ++i)
-                    {
-                        if (decl->enumValues[i] == name)
-                            return Result<uint32_t>::ok(i);
-                    }
-                }
+                out.nodes.push_back(std::move(n));
+                return static_cast<uint32_t>(out.nodes.size() - 1);
+            }
 
-                return Result<uint32_t>::err({ErrorCode::eParseError, "Unknown identifier in only_if: " + name});
+            uint32_t addBinary(KeywordExprNode::Op op, uint32_t lhs, uint32_t rhs)
+            {
+                KeywordExprNode n;
+                n.op  = op;
+                n.lhs = lhs;
+                n.rhs = rhs;
+                return add(std::move(n));
             }
 
-            Result<uint32_t> parsePrimaryValue()
+            Result<uint32_t> parsePrimary()
             {
                 if (cur.kind == Token::eIdent)
                 {
-                    auto name = cur.text;
+                    KeywordExprNode n;
+                    n.op   = KeywordExprNode::Op::eIdent;
+                    n.text = cur.text;
                     consume(Token::eIdent);
-                    return resolveIdent(name);
+                    return Result<uint32_t>::ok(add(std::move(n)));
                 }
 
                 if (cur.kind == Token::eNumber)
                 {
-                    uint32_t v = 0;
+                    KeywordExprNode n;
+                    n.op = KeywordExprNode::Op::eNumber;
                     for (char c : cur.text)
-                        v = v * 10u + static_cast<uint32_t>(c - '0');
+                        n.number = n.number * 10u + static_cast<uint32_t>(c - '0');
                     consume(Token::eNumber);
-                    return Result<uint32_t>::ok(v);
+                    return Result<uint32_t>::ok(add(std::move(n)));
                 }
 
                 if (cur.kind == Token::eLParen)
                 {
                     consume(Token::eLParen);
-                    auto r = parseExprBool();
+                    auto r = parseOr();
                     if (!r.isOk())
-                        return Result<uint32_t>::err(r.error());
+                        return r;
                     if (cur.kind != Token::eRParen)
                         return Result<uint32_t>::err({ErrorCode::eParseError, "Expected ')' in only_if"});
                     consume(Token::eRParen);
-                    return Result<uint32_t>::ok(r.value() ? 1u : 0u);
+
+                    KeywordExprNode n;
+                    n.op  = KeywordExprNode::Op::eBool;
+                    n.lhs = r.value();
+                    return Result<uint32_t>::ok(add(std::move(n)));
                 }
 
                 return Result<uint32_t>::err({ErrorCode::eParseError, "Expected primary in only_if"});
             }
 
-            Result<bool> parseCmp()
+            Result<uint32_t> parseCmp()
             {
                 // cmp := primary ( ('==' | '!=') primary )?
-                auto lhs = parsePrimaryValue();
+                auto lhs = parsePrimary();
                 if (!lhs.isOk())
-                    return Result<bool>::err(lhs.error());
+                    return lhs;
 
                 if (cur.kind == Token::eEqEq || cur.kind == Token::eNotEq)
                 {
-                    const bool isEq = (cur.kind == Token::eEqEq);
+                    const auto op = (cur.kind == Token::eEqEq) ? KeywordExprNode::Op::eEq : KeywordExprNode::Op::eNotEq;
                     consume(cur.kind);
-                    auto rhs = parsePrimaryValue();
+                    auto rhs = parsePrimary();
                     if (!rhs.isOk())
-                        return Result<bool>::err(rhs.error());
-                    const bool res = isEq ? (lhs.value() == rhs.value()) : (lhs.value() != rhs.value());
-                    return Result<bool>::ok(res);
+                        return rhs;
+                    return Result<uint32_t>::ok(addBinary(op, lhs.value(), rhs.value()));
                 }
 
-                // no comparator: treat value as boolean
-                return Result<bool>::ok(lhs.value() != 0);
+                // no comparator: the value is used as boolean by the consumer
+                return lhs;
             }
 
-            Result<bool> parseAnd()
+            Result<uint32_t> parseAnd()
             {
                 auto r = parseCmp();
                 if (!r.isOk())
                     return r;
-                bool v = r.value();
+                uint32_t v = r.value();
                 while (cur.kind == Token::eAndAnd)
                 {
                     consume(Token::eAndAnd);
                     auto rhs = parseCmp();
                     if (!rhs.isOk())
                         return rhs;
-                    v = v && rhs.value();
+                    v = addBinary(KeywordExprNode::Op::eAnd, v, rhs.value());
                 }
-                return Result<bool>::ok(v);
+                return Result<uint32_t>::ok(v);
             }
 
-            Result<bool> parseOr()
+            Result<uint32_t> parseOr()
             {
                 auto r = parseAnd();
                 if (!r.isOk())
                     return r;
-                bool v = r.value();
+                uint32_t v = r.value();
                 while (cur.kind == Token::eOrOr)
                 {
                     consume(Token::eOrOr);
                     auto rhs = parseAnd();
                     if (!rhs.isOk())
                         return rhs;
-                    v = v || rhs.value();
+                    v = addBinary(KeywordExprNode::Op::eOr, v, rhs.value());
+                }
+                return Result<uint32_t>::ok(v);
+            }
+        };
+
+        struct Evaluator
+        {
+            const KeywordExpr&         expr;
+            const KeywordValueContext& ctx;
+
+            Result<uint32_t> resolveIdent(const std::string& name) const
+            {
+                // true/false
+                if (name == "true" || name == "TRUE" || name == "True")
+                    return Result<uint32_t>::ok(1);
+                if (name == "false" || name == "FALSE" || name == "False")
+                    return Result<uint32_t>::ok(0);
+
+                // keyword value
+                auto it = ctx.values.find(name);
+                if (it != ctx.values.end())
+                    return Result<uint32_t>::ok(it->second);
+
+                // enumerant lookup: try against all enum keyword decls (small set)
+                // This supports constraints like SURFACE==CUTOUT.
+                for (const auto& [kname, decl] : ctx.decls)
+                {
+                    if (!decl)
+                        continue;
+                    if (decl->kind != KeywordValueKind::eEnum)
+                        continue;
+                    for (uint32_t i = 0; i < static_cast<uint32_t>(decl->enumValues.size()); ++i)
+                    {
+                        if (decl->enumValues[i] == name)
+                            return Result<uint32_t>::ok(i);
+                    }
                 }
-                return Result<bool>::ok(v);
+
+                return Result<uint32_t>::err({ErrorCode::eParseError, "Unknown identifier in only_if: " + name});
             }
 
-            Result<bool> parseExprBool() { return parseOr(); }
+            // Both operands are always evaluated so unknown identifiers are reported regardless of short-circuiting.
+            Result<uint32_t> value(uint32_t index) const
+            {
+                const auto& n = expr.nodes[index];
+                switch (n.op)
+                {
+                    case KeywordExprNode::Op::eIdent:
+                        return resolveIdent(n.text);
+                    case KeywordExprNode::Op::eNumber:
+                        return Result<uint32_t>::ok(n.number);
+                    case KeywordExprNode::Op::eBool: {
+                        auto v = value(n.lhs);
+                        if (!v.isOk())
+                            return v;
+                        return Result<uint32_t>::ok(v.value() != 0 ? 1u : 0u);
+                    }
+                    default:
+                        break;
+                }
+
+                auto lhs = value(n.lhs);
+                if (!lhs.isOk())
+                    return lhs;
+                auto rhs = value(n.rhs);
+                if (!rhs.isOk())
+                    return rhs;
+
+                bool res = false;
+                switch (n.op)
+                {
+                    case KeywordExprNode::Op::eEq:
+                        res = lhs.value() == rhs.value();
+                        break;
+                    case KeywordExprNode::Op::eNotEq:
+                        res = lhs.value() != rhs.value();
+                        break;
+                    case KeywordExprNode::Op::eAnd:
+                        res = lhs.value() != 0 && rhs.value() != 0;
+                        break;
+                    case KeywordExprNode::Op::eOr:
+                        res = lhs.value() != 0 || rhs.value() != 0;
+                        break;
+                    default:
+                        break;
+                }
+                return Result<uint32_t>::ok(res ? 1u : 0u);
+            }
         };
 
         inline std::string_view stripOnlyIf(std::string_view s)
@@ -270,21 +340,42 @@ namespace vshadersystem
         }
     } // namespace
 
-    Result<bool> eval_only_if(std::string_view constraint, const KeywordValueContext& ctx)
+    Result<KeywordExpr> parse_keyword_expr(std::string_view constraint)
     {
+        KeywordExpr out;
+
         auto expr = stripOnlyIf(constraint);
         if (expr.empty())
-            return Result<bool>::ok(true);
+            return Result<KeywordExpr>::ok(std::move(out));
 
-        Parser p(expr, ctx);
-        auto   r = p.parseExprBool();
+        Parser p(expr, out);
+        auto   r = p.parseOr();
         if (!r.isOk())
-            return r;
+            return Result<KeywordExpr>::err(r.error());
 
         // Ensure full consumption
         if (p.cur.kind != Token::eEnd)
-            return Result<bool>::err({ErrorCode::eParseError, "Trailing tokens in only_if expression"});
+            return Result<KeywordExpr>::err({ErrorCode::eParseError, "Trailing tokens in only_if expression"});
+
+        out.root  = r.value();
+        out.empty = false;
+        return Result<KeywordExpr>::ok(std::move(out));
+    }
+
+    Result<bool> eval_only_if(std::string_view constraint, const KeywordValueContext& ctx)
+    {
+        auto pr = parse_keyword_expr(constraint);
+        if (!pr.isOk())
+            return Result<bool>::err(pr.error());
+
+        const auto& expr = pr.value();
+        if (expr.empty)
+            return Result<bool>::ok(true);
+
+        auto r = Evaluator {expr, ctx}.value(expr.root);
+        if (!r.isOk())
+            return Result<bool>::err(r.error());
 
-        return r;
+        return Result<bool>::ok(r.value() != 0);
     }
 } // namespace vshadersystem
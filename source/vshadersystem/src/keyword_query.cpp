@@ -0,0 +1,388 @@
+#include "vshadersystem/keyword_query.hpp"
+#include "vshadersystem/keyword_expr.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <string>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define VSS_KEYWORD_QUERY_SSE2 1
+#else
+#define VSS_KEYWORD_QUERY_SSE2 0
+#endif
+
+namespace vshadersystem
+{
+    namespace
+    {
+        using Program = std::vector<KeywordQueryOp>;
+
+        // Keywords wider than this cannot appear on both sides of a comparison
+        // or as a bare boolean, since those expand to one test per value.
+        constexpr uint8_t kMaxExpandBits = 8;
+
+        // One possible value of an operand and the entries for which it holds (empty cond = all entries).
+        struct Case
+        {
+            uint32_t value = 0;
+            Program  cond;
+        };
+
+        KeywordQueryOp make_op(KeywordQueryOp::Kind kind)
+        {
+            KeywordQueryOp op;
+            op.kind = kind;
+            return op;
+        }
+
+        KeywordQueryOp make_match(const KeywordBitField& f, uint32_t value)
+        {
+            const uint32_t bits = 1u + f.width;
+            const uint32_t low  = bits >= 32 ? ~0u : ((1u << bits) - 1u);
+
+            KeywordQueryOp op;
+            op.kind   = KeywordQueryOp::Kind::eMatch;
+            op.word   = f.word;
+            op.mask   = low << f.shift;
+            op.expect = (1u | (value << 1)) << f.shift;
+            return op;
+        }
+
+        void append(Program& dst, const Program& src) { dst.insert(dst.end(), src.begin(), src.end()); }
+
+        struct Compiler
+        {
+            const KeywordExpr&    expr;
+            const KeywordBitsets& bitsets;
+
+            const KeywordBitField* field_of(uint32_t node) const
+            {
+                const auto& n = expr.nodes[node];
+                return n.op == KeywordExprNode::Op::eIdent ? bitsets.find(n.text) : nullptr;
+            }
+
+            Result<uint32_t> resolve_constant(const std::string& name, const KeywordBitField* peer) const
+            {
+                if (name == "true" || name == "TRUE" || name == "True")
+                    return Result<uint32_t>::ok(1);
+                if (name == "false" || name == "FALSE" || name == "False")
+                    return Result<uint32_t>::ok(0);
+
+                // Prefer enumerants of the keyword on the other side, then any enum keyword.
+                auto find_in = [&](const KeywordBitField& f, uint32_t& out) {
+                    for (uint32_t i = 0; i < static_cast<uint32_t>(f.enumValues.size()); ++i)
+                    {
+                        if (f.enumValues[i] == name)
+                        {
+                            out = i;
+                            return true;
+                        }
+                    }
+                    return false;
+                };
+
+                uint32_t v = 0;
+                if (peer && find_in(*peer, v))
+                    return Result<uint32_t>::ok(v);
+                for (const auto& f : bitsets.fields)
+                {
+                    if (f.kind == KeywordValueKind::eEnum && find_in(f, v))
+                        return Result<uint32_t>::ok(v);
+                }
+
+                return Result<uint32_t>::err({ErrorCode::eParseError, "Unknown identifier in query: " + name});
+            }
+
+            Result<std::vector<Case>> cases(uint32_t node, const KeywordBitField* peer)
+            {
+                const auto&       n = expr.nodes[node];
+                std::vector<Case> out;
+
+                if (n.op == KeywordExprNode::Op::eNumber)
+                {
+                    out.push_back(Case {n.number, {}});
+                    return Result<std::vector<Case>>::ok(std::move(out));
+                }
+
+                if (n.op == KeywordExprNode::Op::eIdent)
+                {
+                    if (const auto* f = bitsets.find(n.text))
+                    {
+                        if (f->width > kMaxExpandBits)
+                            return Result<std::vector<Case>>::err(
+                                {ErrorCode::eInvalidArgument,
+                                 "Keyword '" + f->name + "' is too wide to compare against another keyword."});
+
+                        for (uint32_t v = 0; v < (1u << f->width); ++v)
+                            out.push_back(Case {v, {make_match(*f, v)}});
+                        return Result<std::vector<Case>>::ok(std::move(out));
+                    }
+
+                    auto c = resolve_constant(n.text, peer);
+                    if (!c.isOk())
+                        return Result<std::vector<Case>>::err(c.error());
+                    out.push_back(Case {c.value(), {}});
+                    return Result<std::vector<Case>>::ok(std::move(out));
+                }
+
+                // Boolean sub-expression: 1 where it holds, 0 elsewhere.
+                auto b = boolean(node);
+                if (!b.isOk())
+                    return Result<std::vector<Case>>::err(b.error());
+
+                Program negated = b.value();
+                negated.push_back(make_op(KeywordQueryOp::Kind::eNot));
+                out.push_back(Case {1, std::move(b.value())});
+                out.push_back(Case {0, std::move(negated)});
+                return Result<std::vector<Case>>::ok(std::move(out));
+            }
+
+            // OR over the pairs of operand cases whose values satisfy the comparison.
+            // Keyword vs constant leaves a single column test.
+            Result<Program> compare(uint32_t lhs, uint32_t rhs, bool wantEqual)
+            {
+                const auto* lf = field_of(lhs);
+                const auto* rf = field_of(rhs);
+
+                auto lc = cases(lhs, rf);
+                if (!lc.isOk())
+                    return Result<Program>::err(lc.error());
+                auto rc = cases(rhs, lf);
+                if (!rc.isOk())
+                    return Result<Program>::err(rc.error());
+
+                Program out;
+                bool    any = false;
+                for (const auto& l : lc.value())
+                {
+                    for (const auto& r : rc.value())
+                    {
+                        if ((l.value == r.value) != wantEqual)
+                            continue;
+
+                        Program term = l.cond;
+                        append(term, r.cond);
+                        if (!l.cond.empty() && !r.cond.empty())
+                            term.push_back(make_op(KeywordQueryOp::Kind::eAnd));
+                        if (term.empty())
+                            term.push_back(make_op(KeywordQueryOp::Kind::eTrue));
+
+                        append(out, term);
+                        if (any)
+                            out.push_back(make_op(KeywordQueryOp::Kind::eOr));
+                        any = true;
+                    }
+                }
+
+                if (!any)
+                    out.push_back(make_op(KeywordQueryOp::Kind::eFalse));
+                return Result<Program>::ok(std::move(out));
+            }
+
+            Result<Program> boolean(uint32_t node)
+            {
+                const auto& n = expr.nodes[node];
+                switch (n.op)
+                {
+                    case KeywordExprNode::Op::eAnd:
+                    case KeywordExprNode::Op::eOr: {
+                        auto l = boolean(n.lhs);
+                        if (!l.isOk())
+                            return l;
+                        auto r = boolean(n.rhs);
+                        if (!r.isOk())
+                            return r;
+
+                        Program out = std::move(l.value());
+                        append(out, r.value());
+                        out.push_back(make_op(n.op == KeywordExprNode::Op::eAnd ? KeywordQueryOp::Kind::eAnd :
+                                                                                  KeywordQueryOp::Kind::eOr));
+                        return Result<Program>::ok(std::move(out));
+                    }
+                    case KeywordExprNode::Op::eEq:
+                        return compare(n.lhs, n.rhs, true);
+                    case KeywordExprNode::Op::eNotEq:
+                        return compare(n.lhs, n.rhs, false);
+                    case KeywordExprNode::Op::eBool:
+                        return boolean(n.lhs);
+                    default:
+                        break;
+                }
+
+                // Bare value: true where it is non-zero.
+                auto vc = cases(node, nullptr);
+                if (!vc.isOk())
+                    return Result<Program>::err(vc.error());
+
+                Program out;
+                bool    any = false;
+                for (const auto& c : vc.value())
+                {
+                    if (c.value == 0)
+                        continue;
+                    if (c.cond.empty())
+                        out.push_back(make_op(KeywordQueryOp::Kind::eTrue));
+                    else
+                        append(out, c.cond);
+                    if (any)
+                        out.push_back(make_op(KeywordQueryOp::Kind::eOr));
+                    any = true;
+                }
+
+                if (!any)
+                    out.push_back(make_op(KeywordQueryOp::Kind::eFalse));
+                return Result<Program>::ok(std::move(out));
+            }
+        };
+
+        // out[w] bit b = entry (w * 64 + b) matches. Bits past entryCount are unspecified.
+        void eval_match(const uint32_t* column, uint32_t entryCount, uint32_t mask, uint32_t expect, uint64_t* out)
+        {
+            uint32_t i = 0;
+
+#if VSS_KEYWORD_QUERY_SSE2
+            const __m128i m = _mm_set1_epi32(static_cast<int>(mask));
+            const __m128i x = _mm_set1_epi32(static_cast<int>(expect));
+            for (; i + 64 <= entryCount; i += 64)
+            {
+                uint64_t bits = 0;
+                for (uint32_t k = 0; k < 64; k += 4)
+                {
+                    const __m128i v  = _mm_loadu_si128(reinterpret_cast<const __m128i*>(column + i + k));
+                    const __m128i eq = _mm_cmpeq_epi32(_mm_and_si128(v, m), x);
+                    bits |= static_cast<uint64_t>(static_cast<uint32_t>(_mm_movemask_ps(_mm_castsi128_ps(eq)))) << k;
+                }
+                out[i / 64] = bits;
+            }
+#endif
+
+            for (; i < entryCount; i += 64)
+            {
+                const uint32_t n    = std::min<uint32_t>(64, entryCount - i);
+                uint64_t       bits = 0;
+                for (uint32_t k = 0; k < n; ++k)
+                {
+                    if ((column[i + k] & mask) == expect)
+                        bits |= uint64_t(1) << k;
+                }
+                out[i / 64] = bits;
+            }
+        }
+    } // namespace
+
+    Result<KeywordQuery> compile_keyword_query(std::string_view predicate, const KeywordBitsets& bitsets)
+    {
+        auto pr = parse_keyword_expr(predicate);
+        if (!pr.isOk())
+            return Result<KeywordQuery>::err(pr.error());
+
+        KeywordQuery q;
+        const auto&  expr = pr.value();
+        if (expr.empty)
+        {
+            q.ops.push_back(make_op(KeywordQueryOp::Kind::eTrue));
+            return Result<KeywordQuery>::ok(std::move(q));
+        }
+
+        auto r = Compiler {expr, bitsets}.boolean(expr.root);
+        if (!r.isOk())
+            return Result<KeywordQuery>::err(r.error());
+
+        q.ops = std::move(r.value());
+        return Result<KeywordQuery>::ok(std::move(q));
+    }
+
+    std::vector<uint32_t>
+    run_keyword_query(const ShaderLibrary& lib, const KeywordQuery& query, const KeywordQueryFilter& filter)
+    {
+        const auto&    kb         = lib.keywordBitsets;
+        const uint32_t entryCount = static_cast<uint32_t>(lib.entries.size());
+        const bool     hasBits    = kb.entryCount == entryCount;
+        const size_t   wordCount  = (static_cast<size_t>(entryCount) + 63) / 64;
+
+        std::vector<std::vector<uint64_t>> stack;
+        stack.reserve(8);
+
+        for (const auto& op : query.ops)
+        {
+            switch (op.kind)
+            {
+                case KeywordQueryOp::Kind::eMatch: {
+                    std::vector<uint64_t> bits(wordCount, 0);
+                    if (hasBits && op.word < kb.wordCount)
+                        eval_match(kb.words.data() + static_cast<size_t>(op.word) * entryCount,
+                                   entryCount,
+                                   op.mask,
+                                   op.expect,
+                                   bits.data());
+                    stack.push_back(std::move(bits));
+                    break;
+                }
+                case KeywordQueryOp::Kind::eTrue:
+                    stack.emplace_back(wordCount, ~uint64_t(0));
+                    break;
+                case KeywordQueryOp::Kind::eFalse:
+                    stack.emplace_back(wordCount, 0);
+                    break;
+                case KeywordQueryOp::Kind::eNot:
+                    if (stack.empty())
+                        return {};
+                    for (auto& w : stack.back())
+                        w = ~w;
+                    break;
+                case KeywordQueryOp::Kind::eAnd:
+                case KeywordQueryOp::Kind::eOr: {
+                    if (stack.size() < 2)
+                        return {};
+                    auto b = std::move(stack.back());
+                    stack.pop_back();
+                    auto& a = stack.back();
+                    if (op.kind == KeywordQueryOp::Kind::eAnd)
+                    {
+                        for (size_t w = 0; w < wordCount; ++w)
+                            a[w] &= b[w];
+                    }
+                    else
+                    {
+                        for (size_t w = 0; w < wordCount; ++w)
+                            a[w] |= b[w];
+                    }
+                    break;
+                }
+            }
+        }
+
+        std::vector<uint32_t> out;
+        if (stack.size() != 1)
+            return out;
+
+        const auto& result = stack.back();
+        for (size_t w = 0; w < wordCount; ++w)
+        {
+            for (uint64_t bits = result[w]; bits != 0; bits &= bits - 1)
+            {
+                const uint32_t i = static_cast<uint32_t>(w * 64 + static_cast<size_t>(std::countr_zero(bits)));
+                if (i >= entryCount)
+                    break;
+                if (filter.stage != ShaderStage::eUnknown && lib.entries[i].stage != filter.stage)
+                    continue;
+                if (filter.shaderIdHash != 0 && (!hasBits || kb.shaderIdHashes[i] != filter.shaderIdHash))
+                    continue;
+                out.push_back(i);
+            }
+        }
+
+        return out;
+    }
+
+    Result<std::vector<uint32_t>>
+    query_vshlib(const ShaderLibrary& lib, std::string_view predicate, const KeywordQueryFilter& filter)
+    {
+        auto q = compile_keyword_query(predicate, lib.keywordBitsets);
+        if (!q.isOk())
+            return Result<std::vector<uint32_t>>::err(q.error());
+
+        return Result<std::vector<uint32_t>>::ok(run_keyword_query(lib, q.value(), filter));
+    }
+} // namespace vshadersystem
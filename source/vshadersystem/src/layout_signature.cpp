@@ -0,0 +1,90 @@
+#include "vshadersystem/layout_signature.hpp"
+#include "vshadersystem/hash.hpp"
+
+#include <algorithm>
+#include <utility>
+
+namespace vshadersystem
+{
+    static constexpr uint64_t kSetSeed      = 0x5653534c41594f55ull; // "VSSLAYOU"
+    static constexpr uint64_t kPipelineSeed = 0x5653535049504c4eull; // "VSSPIPLN"
+
+    uint64_t descriptor_set_signature(const ShaderReflection& refl, uint32_t set)
+    {
+        std::vector<const DescriptorBinding*> bindings;
+        for (const auto& d : refl.descriptors)
+        {
+            if (d.set == set)
+                bindings.push_back(&d);
+        }
+
+        if (bindings.empty())
+            return 0;
+
+        std::sort(bindings.begin(), bindings.end(), [](const DescriptorBinding* a, const DescriptorBinding* b) {
+            if (a->binding != b->binding)
+                return a->binding < b->binding;
+            return static_cast<uint8_t>(a->kind) < static_cast<uint8_t>(b->kind);
+        });
+
+        std::vector<uint32_t> words;
+        words.reserve(bindings.size() * 5);
+        for (const auto* d : bindings)
+        {
+            words.push_back(d->binding);
+            words.push_back(static_cast<uint32_t>(d->kind));
+            words.push_back(d->count);
+            words.push_back(d->runtimeSized ? 1u : 0u);
+            words.push_back(d->stageFlags);
+        }
+
+        return xxhash64_words(words, kSetSeed);
+    }
+
+    std::vector<uint64_t> descriptor_set_signatures(const ShaderReflection& refl)
+    {
+        std::vector<uint64_t> out;
+        if (refl.descriptors.empty())
+            return out;
+
+        uint32_t maxSet = 0;
+        for (const auto& d : refl.descriptors)
+            maxSet = std::max(maxSet, d.set);
+
+        out.resize(static_cast<size_t>(maxSet) + 1);
+        for (uint32_t s = 0; s <= maxSet; ++s)
+            out[s] = descriptor_set_signature(refl, s);
+
+        return out;
+    }
+
+    uint64_t pipeline_layout_signature(const ShaderReflection& refl)
+    {
+        std::vector<uint32_t> words;
+
+        for (uint64_t sig : descriptor_set_signatures(refl))
+        {
+            words.push_back(static_cast<uint32_t>(sig));
+            words.push_back(static_cast<uint32_t>(sig >> 32));
+        }
+
+        // Separator so that "no sets + push constants" cannot collide with a set signature.
+        words.push_back(0xFFFFFFFFu);
+
+        std::vector<std::pair<uint32_t, uint32_t>> ranges;
+        for (const auto& b : refl.blocks)
+        {
+            if (b.isPushConstant)
+                ranges.emplace_back(b.size, b.stageFlags);
+        }
+        std::sort(ranges.begin(), ranges.end());
+
+        for (const auto& [size, stages] : ranges)
+        {
+            words.push_back(size);
+            words.push_back(stages);
+        }
+
+        return xxhash64_words(words, kPipelineSeed);
+    }
+} // namespace vshadersystem
@@ -1,16 +1,23 @@
 #include "vshadersystem/library.hpp"
+#include "vshadersystem/binary.hpp"
+#include "vshadersystem/layout_signature.hpp"
 
 #include <algorithm>
 #include <cstdint>
 #include <cstring>
 #include <fstream>
+#include <functional>
+#include <unordered_map>
+#include <utility>
 
 namespace vshadersystem
 {
     static constexpr uint8_t  kMagic[8] = {'V', 'S', 'H', 'L', 'I', 'B', 0, 0};
-    static constexpr uint32_t kVersion  = 2;
+    static constexpr uint32_t kVersion  = 3;
     static constexpr uint32_t kFlags    = 0;
 
+    static constexpr size_t kHeaderSizeV2 = 56;
+
 #pragma pack(push, 1)
     struct FileHeader
     {
@@ -23,18 +30,527 @@ namespace vshadersystem
         uint64_t tocSize;
         uint64_t keywordsOffset;
         uint64_t keywordsSize;
+        uint64_t extOffset; // v3+
+        uint64_t extSize;   // v3+
     };
 
     struct FileEntry
     {
         uint64_t keyHash;
         uint8_t  stage;
-        uint8_t  reserved[7];
+        uint8_t  reserved[3];
+        uint32_t layoutClass; // v3+, zero in v2
         uint64_t offset;
         uint64_t size;
     };
 #pragma pack(pop)
 
+    static_assert(sizeof(FileHeader) == 72, "VSHLIB header must be 72 bytes.");
+    static_assert(sizeof(FileEntry) == 32, "VSHLIB TOC entry must be 32 bytes.");
+
+    static uint32_t tag_u32(const char tag[4])
+    {
+        return static_cast<uint32_t>(static_cast<uint8_t>(tag[0])) |
+               (static_cast<uint32_t>(static_cast<uint8_t>(tag[1])) << 8) |
+               (static_cast<uint32_t>(static_cast<uint8_t>(tag[2])) << 16) |
+               (static_cast<uint32_t>(static_cast<uint8_t>(tag[3])) << 24);
+    }
+
+    static void put_u32(std::vector<uint8_t>& out, uint32_t v)
+    {
+        uint8_t b[4];
+        std::memcpy(b, &v, 4);
+        out.insert(out.end(), b, b + 4);
+    }
+
+    static void put_u64(std::vector<uint8_t>& out, uint64_t v)
+    {
+        uint8_t b[8];
+        std::memcpy(b, &v, 8);
+        out.insert(out.end(), b, b + 8);
+    }
+
+    static bool get_u32(const uint8_t*& p, const uint8_t* e, uint32_t& v)
+    {
+        if (p + 4 > e)
+            return false;
+        std::memcpy(&v, p, 4);
+        p += 4;
+        return true;
+    }
+
+    static bool get_u64(const uint8_t*& p, const uint8_t* e, uint64_t& v)
+    {
+        if (p + 8 > e)
+            return false;
+        std::memcpy(&v, p, 8);
+        p += 8;
+        return true;
+    }
+
+    static void put_string(std::vector<uint8_t>& out, const std::string& v)
+    {
+        put_u32(out, static_cast<uint32_t>(v.size()));
+        out.insert(out.end(), v.begin(), v.end());
+    }
+
+    static bool get_string(const uint8_t*& p, const uint8_t* e, std::string& v)
+    {
+        uint32_t n = 0;
+        if (!get_u32(p, e, n) || n > static_cast<size_t>(e - p))
+            return false;
+        v.assign(reinterpret_cast<const char*>(p), n);
+        p += n;
+        return true;
+    }
+
+    static void put_chunk(std::vector<uint8_t>& out, const char tag[4], const std::vector<uint8_t>& payload)
+    {
+        put_u32(out, tag_u32(tag));
+        put_u32(out, static_cast<uint32_t>(payload.size()));
+        out.insert(out.end(), payload.begin(), payload.end());
+    }
+
+    // ------------------------------------------------------------
+    // Layout compatibility classes
+    // ------------------------------------------------------------
+    struct LayoutClassBuilder
+    {
+        std::vector<uint64_t>                  setSignatures;
+        std::unordered_map<uint64_t, uint32_t> setIds;
+
+        std::vector<ShaderLibraryLayoutClass>  classes;
+        std::unordered_map<uint64_t, uint32_t> classIds;
+
+        // Returns the 1-based layout class of an entry, given pipeline_layout_signature() and
+        // descriptor_set_signatures() of its reflection.
+        uint32_t classify(uint64_t sig, const std::vector<uint64_t>& setSigs)
+        {
+            auto it = classIds.find(sig);
+            if (it != classIds.end())
+                return it->second;
+
+            ShaderLibraryLayoutClass lc;
+            lc.signature = sig;
+            for (uint64_t setSig : setSigs)
+                lc.setLayouts.push_back(setSig == 0 ? 0u : intern_set(setSig));
+
+            classes.push_back(std::move(lc));
+            const auto id = static_cast<uint32_t>(classes.size());
+            classIds.emplace(sig, id);
+            return id;
+        }
+
+        uint32_t intern_set(uint64_t sig)
+        {
+            auto [it, inserted] = setIds.emplace(sig, static_cast<uint32_t>(setSignatures.size() + 1));
+            if (inserted)
+                setSignatures.push_back(sig);
+            return it->second;
+        }
+
+        std::vector<uint8_t> serialize() const
+        {
+            std::vector<uint8_t> out;
+            put_u32(out, static_cast<uint32_t>(setSignatures.size()));
+            for (uint64_t sig : setSignatures)
+                put_u64(out, sig);
+
+            put_u32(out, static_cast<uint32_t>(classes.size()));
+            for (const auto& lc : classes)
+            {
+                put_u64(out, lc.signature);
+                put_u32(out, static_cast<uint32_t>(lc.setLayouts.size()));
+                for (uint32_t id : lc.setLayouts)
+                    put_u32(out, id);
+            }
+            return out;
+        }
+    };
+
+    static bool deserialize_layout_classes(const uint8_t* p, const uint8_t* e, ShaderLibrary& lib)
+    {
+        uint32_t setCount = 0;
+        if (!get_u32(p, e, setCount) || setCount > static_cast<size_t>(e - p) / 8)
+            return false;
+
+        lib.setLayoutSignatures.resize(setCount);
+        for (auto& sig : lib.setLayoutSignatures)
+        {
+            if (!get_u64(p, e, sig))
+                return false;
+        }
+
+        uint32_t classCount = 0;
+        if (!get_u32(p, e, classCount) || classCount > static_cast<size_t>(e - p) / 12)
+            return false;
+
+        lib.layoutClasses.resize(classCount);
+        for (auto& lc : lib.layoutClasses)
+        {
+            uint32_t n = 0;
+            if (!get_u64(p, e, lc.signature) || !get_u32(p, e, n) || n > static_cast<size_t>(e - p) / 4)
+                return false;
+
+            lc.setLayouts.resize(n);
+            for (auto& id : lc.setLayouts)
+            {
+                if (!get_u32(p, e, id) || id > setCount)
+                    return false;
+            }
+        }
+
+        return true;
+    }
+
+    // ------------------------------------------------------------
+    // Keyword bitsets
+    // ------------------------------------------------------------
+    static uint8_t bits_for(uint32_t maxValue)
+    {
+        uint8_t bits = 1;
+        while (bits < 31 && (maxValue >> bits) != 0)
+            ++bits;
+        return bits;
+    }
+
+    struct KeywordBitsetBuilder
+    {
+        struct Row
+        {
+            uint64_t                                   shaderIdHash = 0;
+            std::vector<std::pair<uint32_t, uint32_t>> values; // (field, value)
+        };
+
+        std::vector<KeywordBitField>              fields;
+        std::vector<uint32_t>                     maxValues;
+        std::unordered_map<std::string, uint32_t> fieldIds;
+        std::vector<Row>                          rows;
+
+        void add(uint64_t shaderIdHash, const std::vector<KeywordValue>& values)
+        {
+            Row row;
+            row.shaderIdHash = shaderIdHash;
+            for (const auto& kv : values)
+            {
+                const uint32_t f     = field_for(kv);
+                uint32_t       value = kv.value;
+
+                // Enum indices are per shader; re-index by enumerant name into the library-wide list.
+                auto& field = fields[f];
+                if (field.kind == KeywordValueKind::eEnum && kv.kind == KeywordValueKind::eEnum &&
+                    kv.value < kv.enumValues.size())
+                {
+                    const auto& name = kv.enumValues[kv.value];
+                    auto        it   = std::find(field.enumValues.begin(), field.enumValues.end(), name);
+                    value            = static_cast<uint32_t>(it - field.enumValues.begin());
+                    if (it == field.enumValues.end())
+                        field.enumValues.push_back(name);
+                }
+
+                maxValues[f] = std::max(maxValues[f], value);
+                row.values.emplace_back(f, value);
+            }
+            rows.push_back(std::move(row));
+        }
+
+        uint32_t field_for(const KeywordValue& kv)
+        {
+            auto it = fieldIds.find(kv.name);
+            if (it != fieldIds.end())
+                return it->second;
+
+            KeywordBitField f;
+            f.name = kv.name;
+            f.kind = kv.kind;
+            fields.push_back(std::move(f));
+            maxValues.push_back(0);
+
+            const auto id = static_cast<uint32_t>(fields.size() - 1);
+            fieldIds.emplace(kv.name, id);
+            return id;
+        }
+
+        KeywordBitsets build()
+        {
+            KeywordBitsets out;
+            out.entryCount = static_cast<uint32_t>(rows.size());
+
+            // Pack fields (presence bit + value bits) into u32 words without straddling word boundaries.
+            uint32_t word = 0;
+            uint32_t used = 0;
+            for (size_t i = 0; i < fields.size(); ++i)
+            {
+                auto&          f       = fields[i];
+                const uint32_t maxEnum = f.enumValues.empty() ? 0u : static_cast<uint32_t>(f.enumValues.size() - 1);
+                f.width                = bits_for(std::max(maxValues[i], maxEnum));
+
+                if (used + 1u + f.width > 32u)
+                {
+                    ++word;
+                    used = 0;
+                }
+                f.word  = word;
+                f.shift = static_cast<uint8_t>(used);
+                used += 1u + f.width;
+            }
+            out.wordCount = fields.empty() ? 0u : word + 1;
+
+            out.shaderIdHashes.reserve(rows.size());
+            out.words.assign(static_cast<size_t>(out.wordCount) * rows.size(), 0u);
+            for (size_t r = 0; r < rows.size(); ++r)
+            {
+                out.shaderIdHashes.push_back(rows[r].shaderIdHash);
+                for (const auto& [fi, value] : rows[r].values)
+                {
+                    const auto& f = fields[fi];
+                    out.words[static_cast<size_t>(f.word) * rows.size() + r] |= (1u | (value << 1)) << f.shift;
+                }
+            }
+
+            out.fields = std::move(fields);
+            return out;
+        }
+    };
+
+    static std::vector<uint8_t> serialize_keyword_bitsets(const KeywordBitsets& kb)
+    {
+        std::vector<uint8_t> out;
+        put_u32(out, kb.entryCount);
+        put_u32(out, kb.wordCount);
+        put_u32(out, static_cast<uint32_t>(kb.fields.size()));
+        for (const auto& f : kb.fields)
+        {
+            put_string(out, f.name);
+            out.push_back(static_cast<uint8_t>(f.kind));
+            put_u32(out, f.word);
+            out.push_back(f.shift);
+            out.push_back(f.width);
+            put_u32(out, static_cast<uint32_t>(f.enumValues.size()));
+            for (const auto& ev : f.enumValues)
+                put_string(out, ev);
+        }
+        for (uint64_t h : kb.shaderIdHashes)
+            put_u64(out, h);
+        for (uint32_t w : kb.words)
+            put_u32(out, w);
+        return out;
+    }
+
+    static bool deserialize_keyword_bitsets(const uint8_t* p, const uint8_t* e, KeywordBitsets& kb)
+    {
+        uint32_t fieldCount = 0;
+        if (!get_u32(p, e, kb.entryCount) || !get_u32(p, e, kb.wordCount) || !get_u32(p, e, fieldCount) ||
+            fieldCount > static_cast<size_t>(e - p) / 15)
+            return false;
+
+        kb.fields.resize(fieldCount);
+        for (auto& f : kb.fields)
+        {
+            uint32_t enumCount = 0;
+            if (!get_string(p, e, f.name) || p + 7 > e)
+                return false;
+            f.kind = static_cast<KeywordValueKind>(*p++);
+            if (!get_u32(p, e, f.word) || p + 2 > e)
+                return false;
+            f.shift = *p++;
+            f.width = *p++;
+            if (f.word >= kb.wordCount || f.width == 0 || f.shift + 1u + f.width > 32u)
+                return false;
+
+            if (!get_u32(p, e, enumCount) || enumCount > static_cast<size_t>(e - p) / 4)
+                return false;
+            f.enumValues.resize(enumCount);
+            for (auto& ev : f.enumValues)
+            {
+                if (!get_string(p, e, ev))
+                    return false;
+            }
+        }
+
+        const uint64_t n = kb.entryCount;
+        if (static_cast<uint64_t>(e - p) != n * 8 + n * kb.wordCount * 4)
+            return false;
+
+        kb.shaderIdHashes.resize(static_cast<size_t>(n));
+        for (auto& h : kb.shaderIdHashes)
+            get_u64(p, e, h);
+
+        kb.words.resize(static_cast<size_t>(n * kb.wordCount));
+        if (!kb.words.empty())
+            std::memcpy(kb.words.data(), p, kb.words.size() * sizeof(uint32_t));
+
+        return true;
+    }
+
+    const KeywordBitField* KeywordBitsets::find(std::string_view name) const
+    {
+        for (const auto& f : fields)
+        {
+            if (f.name == name)
+                return &f;
+        }
+        return nullptr;
+    }
+
+    bool KeywordBitsets::get(uint32_t entry, const KeywordBitField& field, uint32_t& outValue) const
+    {
+        if (entry >= entryCount)
+            return false;
+
+        const uint32_t bits = words[static_cast<size_t>(field.word) * entryCount + entry] >> field.shift;
+        if ((bits & 1u) == 0)
+            return false;
+
+        outValue = (bits >> 1) & ((1u << field.width) - 1u);
+        return true;
+    }
+
+    // ------------------------------------------------------------
+    // Hit groups
+    // ------------------------------------------------------------
+    static const BlockLayout* find_shader_record(const ShaderReflection& refl)
+    {
+        for (const auto& b : refl.blocks)
+        {
+            if (b.isShaderRecord)
+                return &b;
+        }
+        return nullptr;
+    }
+
+    static bool same_record_layout(const ShaderLibraryHitGroup& g, const BlockLayout& record)
+    {
+        if (g.recordSize != record.size || g.recordMembers.size() != record.members.size())
+            return false;
+
+        for (size_t i = 0; i < record.members.size(); ++i)
+        {
+            const auto& a = g.recordMembers[i];
+            const auto& b = record.members[i];
+            if (a.name != b.name || a.offset != b.offset || a.size != b.size || a.type != b.type)
+                return false;
+        }
+        return true;
+    }
+
+    struct HitGroupBuilder
+    {
+        std::vector<ShaderLibraryHitGroup>        groups;
+        std::unordered_map<std::string, uint32_t> groupIds;
+
+        Result<void> add(uint64_t                        shaderIdHash,
+                         ShaderStage                     stage,
+                         const std::vector<std::string>& names,
+                         const BlockLayout*              record)
+        {
+            for (const auto& name : names)
+            {
+                auto [it, inserted] = groupIds.emplace(name, static_cast<uint32_t>(groups.size()));
+                if (inserted)
+                {
+                    ShaderLibraryHitGroup g;
+                    g.name = name;
+                    groups.push_back(std::move(g));
+                }
+                auto& g = groups[it->second];
+
+                uint64_t* slot = nullptr;
+                if (stage == ShaderStage::eRchit)
+                    slot = &g.closestHit;
+                else if (stage == ShaderStage::eRahit)
+                    slot = &g.anyHit;
+                else if (stage == ShaderStage::eRint)
+                    slot = &g.intersection;
+                else
+                    return Result<void>::err(
+                        {ErrorCode::eInvalidArgument, "Hit group '" + name + "' member is not a hit shader."});
+
+                // Every variant of a member lands here; only a second shader for the same stage is a conflict.
+                if (*slot != 0 && *slot != shaderIdHash)
+                    return Result<void>::err(
+                        {ErrorCode::eInvalidArgument, "Hit group '" + name + "' has two shaders for the same stage."});
+                *slot = shaderIdHash;
+
+                if (stage == ShaderStage::eRint)
+                    g.type = HitGroupType::eProcedural;
+
+                // Members read the same SBT record, so every declaration of it must agree.
+                if (record)
+                {
+                    if (g.recordSize == 0)
+                    {
+                        g.recordSize    = record->size;
+                        g.recordMembers = record->members;
+                    }
+                    else if (!same_record_layout(g, *record))
+                    {
+                        return Result<void>::err({ErrorCode::eInvalidArgument,
+                                                  "Hit group '" + name +
+                                                      "' members declare different shaderRecordEXT layouts."});
+                    }
+                }
+            }
+            return Result<void>::ok();
+        }
+
+        std::vector<uint8_t> serialize()
+        {
+            std::sort(groups.begin(), groups.end(), [](const auto& a, const auto& b) { return a.name < b.name; });
+
+            std::vector<uint8_t> out;
+            put_u32(out, static_cast<uint32_t>(groups.size()));
+            for (const auto& g : groups)
+            {
+                put_string(out, g.name);
+                out.push_back(static_cast<uint8_t>(g.type));
+                put_u64(out, g.closestHit);
+                put_u64(out, g.anyHit);
+                put_u64(out, g.intersection);
+                put_u32(out, g.recordSize);
+                put_u32(out, static_cast<uint32_t>(g.recordMembers.size()));
+                for (const auto& m : g.recordMembers)
+                {
+                    put_string(out, m.name);
+                    put_u32(out, m.offset);
+                    put_u32(out, m.size);
+                    out.push_back(static_cast<uint8_t>(m.type));
+                }
+            }
+            return out;
+        }
+    };
+
+    static bool deserialize_hit_groups(const uint8_t* p, const uint8_t* e, std::vector<ShaderLibraryHitGroup>& groups)
+    {
+        uint32_t count = 0;
+        if (!get_u32(p, e, count) || count > static_cast<size_t>(e - p) / 37)
+            return false;
+
+        groups.resize(count);
+        for (auto& g : groups)
+        {
+            uint32_t memberCount = 0;
+            if (!get_string(p, e, g.name) || p + 1 > e)
+                return false;
+            g.type = static_cast<HitGroupType>(*p++);
+            if (!get_u64(p, e, g.closestHit) || !get_u64(p, e, g.anyHit) || !get_u64(p, e, g.intersection) ||
+                !get_u32(p, e, g.recordSize) || !get_u32(p, e, memberCount) ||
+                memberCount > static_cast<size_t>(e - p) / 13)
+                return false;
+
+            g.recordMembers.resize(memberCount);
+            for (auto& m : g.recordMembers)
+            {
+                if (!get_string(p, e, m.name) || !get_u32(p, e, m.offset) || !get_u32(p, e, m.size) || p + 1 > e)
+                    return false;
+                m.type = static_cast<ParamType>(*p++);
+            }
+        }
+
+        return p == e;
+    }
+
     static Result<void> write_all(std::ofstream& f, const void* data, size_t size)
     {
         f.write(reinterpret_cast<const char*>(data), static_cast<std::streamsize>(size));
@@ -51,13 +567,91 @@ namespace vshadersystem
         return Result<void>::ok();
     }
 
-    Result<void> write_vslib(const std::string&                     filePath,
-                             const std::vector<ShaderLibraryEntry>& inEntries,
-                             const std::vector<uint8_t>*            engineKeywordsVkw)
+    // ------------------------------------------------------------
+    // Keyword profiles
+    // ------------------------------------------------------------
+    static std::vector<uint8_t> serialize_profiles(const std::vector<ShaderLibraryProfile>& profiles,
+                                                   const std::vector<uint64_t>&             masks)
     {
+        std::vector<uint8_t> out;
+        put_u32(out, static_cast<uint32_t>(profiles.size()));
+        for (const auto& prof : profiles)
+        {
+            put_string(out, prof.name);
+            put_u32(out, static_cast<uint32_t>(prof.engineKeywordsVkw.size()));
+            out.insert(out.end(), prof.engineKeywordsVkw.begin(), prof.engineKeywordsVkw.end());
+        }
+
+        put_u32(out, static_cast<uint32_t>(masks.size()));
+        for (uint64_t mask : masks)
+            put_u64(out, mask);
+        return out;
+    }
+
+    static bool deserialize_profiles(const uint8_t* p, const uint8_t* e, ShaderLibrary& lib)
+    {
+        uint32_t count = 0;
+        if (!get_u32(p, e, count) || count > kMaxLibraryProfiles)
+            return false;
+
+        lib.profiles.resize(count);
+        for (auto& prof : lib.profiles)
+        {
+            uint32_t size = 0;
+            if (!get_string(p, e, prof.name) || !get_u32(p, e, size) || size > static_cast<size_t>(e - p))
+                return false;
+            prof.engineKeywordsVkw.assign(p, p + size);
+            p += size;
+        }
+
+        uint32_t entryCount = 0;
+        if (!get_u32(p, e, entryCount) || static_cast<uint64_t>(e - p) != uint64_t(entryCount) * 8)
+            return false;
+
+        lib.profileMasks.resize(entryCount);
+        for (auto& mask : lib.profileMasks)
+            get_u64(p, e, mask);
+        return true;
+    }
+
+    // ------------------------------------------------------------
+    // Writing
+    //
+    // Both writers reduce their entries to PlannedEntry rows, sort them, and let
+    // write_library emit header/TOC/extension chunks around a caller-provided blob pass.
+    // ------------------------------------------------------------
+    struct PlannedEntry
+    {
+        uint64_t    keyHash = 0;
+        ShaderStage stage   = ShaderStage::eUnknown;
+        uint64_t    size    = 0;
+        size_t      source  = 0; // index into the caller's entry list
+
+        // Absent for blobs that are not readable .vshbin: no layout class, no keyword values.
+        bool                             isShader        = false;
+        uint64_t                         layoutSignature = 0;
+        const std::vector<uint64_t>*     setSignatures   = nullptr;
+        uint64_t                         shaderIdHash    = 0;
+        const std::vector<KeywordValue>* keywordValues   = nullptr;
+        const std::vector<std::string>*  hitGroups       = nullptr;
+        const BlockLayout*               shaderRecord    = nullptr;
+        uint64_t                         profileMask     = 0;
+    };
+
+    using BlobWriter = std::function<Result<void>(std::ofstream&, const PlannedEntry&)>;
+
+    static Result<void> write_library(const std::string&                       filePath,
+                                      std::vector<PlannedEntry>&               entries,
+                                      const std::vector<uint8_t>*              engineKeywordsVkw,
+                                      const std::vector<ShaderLibraryProfile>* profiles,
+                                      const BlobWriter&                        writeBlob)
+    {
+        if (profiles && profiles->size() > kMaxLibraryProfiles)
+            return Result<void>::err({ErrorCode::eInvalidArgument,
+                                      "VSHLIB supports at most " + std::to_string(kMaxLibraryProfiles) + " profiles."});
+
         // Sort to make output deterministic.
-        std::vector<ShaderLibraryEntry> entries = inEntries;
-        std::sort(entries.begin(), entries.end(), [](const ShaderLibraryEntry& a, const ShaderLibraryEntry& b) {
+        std::sort(entries.begin(), entries.end(), [](const PlannedEntry& a, const PlannedEntry& b) {
             if (a.keyHash != b.keyHash)
                 return a.keyHash < b.keyHash;
             return static_cast<uint8_t>(a.stage) < static_cast<uint8_t>(b.stage);
@@ -67,9 +661,13 @@ namespace vshadersystem
         std::vector<FileEntry> toc;
         toc.reserve(entries.size());
 
-        uint64_t             blobOffset = sizeof(FileHeader); // blobs start right after header
-        std::vector<uint8_t> blobData;
-        blobData.reserve(1024);
+        uint64_t blobOffset = sizeof(FileHeader); // blobs start right after header
+
+        LayoutClassBuilder   layouts;
+        KeywordBitsetBuilder keywords;
+        HitGroupBuilder      hitGroups;
+
+        static const std::vector<KeywordValue> kNoValues;
 
         for (const auto& e : entries)
         {
@@ -79,21 +677,29 @@ namespace vshadersystem
                 return Result<void>::err(
                     {ErrorCode::eInvalidArgument, "VSHLIB entry has keyHash=0 (reserved/invalid)."});
 
+            keywords.add(e.shaderIdHash, e.keywordValues ? *e.keywordValues : kNoValues);
+
+            if (e.hitGroups && !e.hitGroups->empty())
+            {
+                auto hr = hitGroups.add(e.shaderIdHash, e.stage, *e.hitGroups, e.shaderRecord);
+                if (!hr.isOk())
+                    return hr;
+            }
+
             FileEntry fe {};
             fe.keyHash = e.keyHash;
             fe.stage   = static_cast<uint8_t>(e.stage);
             std::memset(fe.reserved, 0, sizeof(fe.reserved));
-            fe.offset = blobOffset;
-            fe.size   = static_cast<uint64_t>(e.blob.size());
+            fe.layoutClass = e.isShader ? layouts.classify(e.layoutSignature, *e.setSignatures) : 0u;
+            fe.offset      = blobOffset;
+            fe.size        = e.size;
 
-            // append blob
-            blobData.insert(blobData.end(), e.blob.begin(), e.blob.end());
             blobOffset += fe.size;
 
             toc.push_back(fe);
         }
 
-        const uint64_t tocOffset = sizeof(FileHeader) + blobData.size();
+        const uint64_t tocOffset = blobOffset;
         const uint64_t tocSize   = toc.size() * sizeof(FileEntry);
 
         const uint64_t keywordsOffset = tocOffset + tocSize;
@@ -101,6 +707,24 @@ namespace vshadersystem
                                             static_cast<uint64_t>(engineKeywordsVkw->size()) :
                                             0ull;
 
+        std::vector<uint8_t> ext;
+        if (!layouts.classes.empty())
+            put_chunk(ext, "LAYC", layouts.serialize());
+        if (!entries.empty())
+            put_chunk(ext, "KWBS", serialize_keyword_bitsets(keywords.build()));
+        if (!hitGroups.groups.empty())
+            put_chunk(ext, "HGRP", hitGroups.serialize());
+        if (profiles && !profiles->empty())
+        {
+            std::vector<uint64_t> masks;
+            masks.reserve(entries.size());
+            for (const auto& e : entries)
+                masks.push_back(e.profileMask);
+            put_chunk(ext, "PROF", serialize_profiles(*profiles, masks));
+        }
+
+        const uint64_t extOffset = keywordsOffset + keywordsSize;
+
         FileHeader hdr {};
         std::memcpy(hdr.magic, kMagic, sizeof(kMagic));
         hdr.version        = kVersion;
@@ -111,6 +735,8 @@ namespace vshadersystem
         hdr.tocSize        = tocSize;
         hdr.keywordsOffset = (keywordsSize > 0) ? keywordsOffset : 0ull;
         hdr.keywordsSize   = keywordsSize;
+        hdr.extOffset      = ext.empty() ? 0ull : extOffset;
+        hdr.extSize        = static_cast<uint64_t>(ext.size());
 
         std::ofstream f(filePath, std::ios::binary);
         if (!f)
@@ -123,10 +749,10 @@ namespace vshadersystem
                 return r;
         }
 
-        // write blobs
-        if (!blobData.empty())
+        // write blobs, in TOC order
+        for (const auto& e : entries)
         {
-            auto r = write_all(f, blobData.data(), blobData.size());
+            auto r = writeBlob(f, e);
             if (!r.isOk())
                 return r;
         }
@@ -147,9 +773,150 @@ namespace vshadersystem
                 return r;
         }
 
+        // write extension chunks
+        if (!ext.empty())
+        {
+            auto r = write_all(f, ext.data(), ext.size());
+            if (!r.isOk())
+                return r;
+        }
+
         return Result<void>::ok();
     }
 
+    Result<void> write_vslib(const std::string&                       filePath,
+                             const std::vector<ShaderLibraryEntry>&   entries,
+                             const std::vector<uint8_t>*              engineKeywordsVkw,
+                             const std::vector<ShaderLibraryProfile>* profiles)
+    {
+        std::vector<ShaderLibraryEntryView> views;
+        views.reserve(entries.size());
+        for (const auto& e : entries)
+            views.push_back({e.keyHash, e.stage, e.blob, e.profileMask});
+
+        return write_vslib(filePath, std::span<const ShaderLibraryEntryView>(views), engineKeywordsVkw, profiles);
+    }
+
+    Result<void> write_vslib(const std::string&                       filePath,
+                             std::span<const ShaderLibraryEntryView>  entries,
+                             const std::vector<uint8_t>*              engineKeywordsVkw,
+                             const std::vector<ShaderLibraryProfile>* profiles)
+    {
+        struct Summary
+        {
+            ShaderBinaryInfo      info;
+            std::vector<uint64_t> setSignatures;
+        };
+
+        std::vector<Summary>      summaries(entries.size());
+        std::vector<PlannedEntry> planned(entries.size());
+        for (size_t i = 0; i < entries.size(); ++i)
+        {
+            const auto& e  = entries[i];
+            auto&       pe = planned[i];
+            pe.keyHash     = e.keyHash;
+            pe.stage       = e.stage;
+            pe.size        = static_cast<uint64_t>(e.blob.size());
+            pe.source      = i;
+            pe.profileMask = e.profileMask;
+
+            auto pr = peek_vshbin(e.blob);
+            if (!pr.isOk())
+                continue;
+
+            auto& s            = summaries[i];
+            s.info             = std::move(pr.value());
+            s.setSignatures    = descriptor_set_signatures(s.info.reflection);
+            pe.isShader        = true;
+            pe.layoutSignature = pipeline_layout_signature(s.info.reflection);
+            pe.setSignatures   = &s.setSignatures;
+            pe.shaderIdHash    = s.info.shaderIdHash;
+            pe.keywordValues   = &s.info.keywordValues;
+            pe.hitGroups       = &s.info.hitGroups;
+            pe.shaderRecord    = find_shader_record(s.info.reflection);
+        }
+
+        auto writeBlob = [&](std::ofstream& f, const PlannedEntry& pe) {
+            const auto& blob = entries[pe.source].blob;
+            return blob.empty() ? Result<void>::ok() : write_all(f, blob.data(), blob.size());
+        };
+        return write_library(filePath, planned, engineKeywordsVkw, profiles, writeBlob);
+    }
+
+    // ------------------------------------------------------------
+    // ShaderLibraryWriter
+    // ------------------------------------------------------------
+    void ShaderLibraryWriter::add(uint64_t                keyHash,
+                                  ShaderStage             stage,
+                                  std::string             blobPath,
+                                  const ShaderBinaryInfo& info)
+    {
+        Entry e;
+        e.keyHash         = keyHash;
+        e.stage           = stage;
+        e.blobPath        = std::move(blobPath);
+        e.blobSize        = info.byteSize;
+        e.layoutSignature = pipeline_layout_signature(info.reflection);
+        e.setSignatures   = descriptor_set_signatures(info.reflection);
+        e.shaderIdHash    = info.shaderIdHash;
+        e.keywordValues   = info.keywordValues;
+        e.hitGroups       = info.hitGroups;
+        if (const auto* record = find_shader_record(info.reflection))
+            e.shaderRecord = *record;
+        m_Entries.push_back(std::move(e));
+    }
+
+    Result<void> ShaderLibraryWriter::write(const std::string&          filePath,
+                                            const std::vector<uint8_t>* engineKeywordsVkw,
+                                            size_t                      bufferSize) const
+    {
+        std::vector<PlannedEntry> planned(m_Entries.size());
+        for (size_t i = 0; i < m_Entries.size(); ++i)
+        {
+            const auto& e      = m_Entries[i];
+            auto&       pe     = planned[i];
+            pe.keyHash         = e.keyHash;
+            pe.stage           = e.stage;
+            pe.size            = e.blobSize;
+            pe.source          = i;
+            pe.isShader        = true;
+            pe.layoutSignature = e.layoutSignature;
+            pe.setSignatures   = &e.setSignatures;
+            pe.shaderIdHash    = e.shaderIdHash;
+            pe.keywordValues   = &e.keywordValues;
+            pe.hitGroups       = &e.hitGroups;
+            pe.shaderRecord    = e.shaderRecord.size > 0 ? &e.shaderRecord : nullptr;
+        }
+
+        std::vector<uint8_t> buffer(std::max<size_t>(bufferSize, 4096));
+
+        auto writeBlob = [&](std::ofstream& f, const PlannedEntry& pe) {
+            const auto&   e = m_Entries[pe.source];
+            std::ifstream in(e.blobPath, std::ios::binary);
+            if (!in)
+                return Result<void>::err({ErrorCode::eIO, "Failed to open blob: " + e.blobPath});
+
+            // Copy exactly the size recorded by add(); a file that changed in between is an error.
+            uint64_t left = e.blobSize;
+            while (left > 0)
+            {
+                const size_t n = static_cast<size_t>(std::min<uint64_t>(left, buffer.size()));
+                if (!in.read(reinterpret_cast<char*>(buffer.data()), static_cast<std::streamsize>(n)))
+                    return Result<void>::err({ErrorCode::eIO, "Blob shorter than recorded: " + e.blobPath});
+
+                auto r = write_all(f, buffer.data(), n);
+                if (!r.isOk())
+                    return r;
+                left -= n;
+            }
+            if (in.peek() != std::char_traits<char>::eof())
+                return Result<void>::err({ErrorCode::eIO, "Blob longer than recorded: " + e.blobPath});
+
+            return Result<void>::ok();
+        };
+        return write_library(filePath, planned, engineKeywordsVkw, nullptr, writeBlob);
+    }
+
     Result<ShaderLibrary> read_vshlib_file(const std::string& filePath)
     {
         std::ifstream f(filePath, std::ios::binary);
@@ -158,16 +925,25 @@ namespace vshadersystem
 
         FileHeader hdr {};
         {
-            auto r = read_all(f, &hdr, sizeof(hdr));
+            auto r = read_all(f, &hdr, kHeaderSizeV2);
             if (!r.isOk())
                 return Result<ShaderLibrary>::err(r.error());
         }
 
         if (std::memcmp(hdr.magic, kMagic, sizeof(kMagic)) != 0)
             return Result<ShaderLibrary>::err({ErrorCode::eDeserializeError, "Invalid VSHLIB magic."});
-        if (hdr.version != kVersion)
+        if (hdr.version != 2 && hdr.version != kVersion)
             return Result<ShaderLibrary>::err({ErrorCode::eDeserializeError, "Unsupported VSHLIB version."});
 
+        uint64_t headerSize = kHeaderSizeV2;
+        if (hdr.version >= 3)
+        {
+            auto r = read_all(f, reinterpret_cast<uint8_t*>(&hdr) + kHeaderSizeV2, sizeof(hdr) - kHeaderSizeV2);
+            if (!r.isOk())
+                return Result<ShaderLibrary>::err(r.error());
+            headerSize = sizeof(FileHeader);
+        }
+
         // Determine file size
         f.seekg(0, std::ios::end);
         const uint64_t fileSize = static_cast<uint64_t>(f.tellg());
@@ -186,10 +962,24 @@ namespace vshadersystem
                     {ErrorCode::eDeserializeError, "VSHLIB keywords chunk overlaps TOC."});
         }
 
-        const uint64_t blobBegin = sizeof(FileHeader);
+        if (hdr.extOffset != 0)
+        {
+            if (hdr.extOffset + hdr.extSize > fileSize)
+                return Result<ShaderLibrary>::err(
+                    {ErrorCode::eDeserializeError, "VSHLIB extension chunks out of file range."});
+            if (hdr.extOffset < hdr.tocOffset + hdr.tocSize)
+                return Result<ShaderLibrary>::err(
+                    {ErrorCode::eDeserializeError, "VSHLIB extension chunks overlap TOC."});
+        }
+
+        const uint64_t blobBegin = headerSize;
         const uint64_t blobEnd   = hdr.tocOffset;
 
+        if (blobEnd < blobBegin)
+            return Result<ShaderLibrary>::err({ErrorCode::eDeserializeError, "VSHLIB TOC overlaps header."});
+
         ShaderLibrary lib {};
+        lib.blobOffset = blobBegin;
         lib.blobData.resize(static_cast<size_t>(blobEnd - blobBegin));
 
         // Read blob region
@@ -217,10 +1007,11 @@ namespace vshadersystem
         for (const auto& fe : toc)
         {
             ShaderLibraryTOCEntry e {};
-            e.keyHash = fe.keyHash;
-            e.stage   = static_cast<ShaderStage>(fe.stage);
-            e.offset  = fe.offset;
-            e.size    = fe.size;
+            e.keyHash     = fe.keyHash;
+            e.stage       = static_cast<ShaderStage>(fe.stage);
+            e.layoutClass = hdr.version >= 3 ? fe.layoutClass : 0u;
+            e.offset      = fe.offset;
+            e.size        = fe.size;
 
             // Validate offsets relative to file
             if (e.offset < blobBegin || (e.offset + e.size) > blobEnd)
@@ -239,28 +1030,136 @@ namespace vshadersystem
                 return Result<ShaderLibrary>::err(r.error());
         }
 
+        // Read optional extension chunks
+        if (hdr.extOffset != 0 && hdr.extSize > 0)
+        {
+            std::vector<uint8_t> ext(static_cast<size_t>(hdr.extSize));
+            f.seekg(static_cast<std::streamoff>(hdr.extOffset), std::ios::beg);
+            auto r = read_all(f, ext.data(), ext.size());
+            if (!r.isOk())
+                return Result<ShaderLibrary>::err(r.error());
+
+            const uint8_t* p = ext.data();
+            const uint8_t* e = ext.data() + ext.size();
+            while (p < e)
+            {
+                uint32_t tag  = 0;
+                uint32_t size = 0;
+                if (!get_u32(p, e, tag) || !get_u32(p, e, size) || size > static_cast<size_t>(e - p))
+                    return Result<ShaderLibrary>::err(
+                        {ErrorCode::eDeserializeError, "VSHLIB extension chunk out of range."});
+
+                if (tag == tag_u32("LAYC") && !deserialize_layout_classes(p, p + size, lib))
+                    return Result<ShaderLibrary>::err({ErrorCode::eDeserializeError, "Invalid VSHLIB LAYC chunk."});
+                if (tag == tag_u32("KWBS") && !deserialize_keyword_bitsets(p, p + size, lib.keywordBitsets))
+                    return Result<ShaderLibrary>::err({ErrorCode::eDeserializeError, "Invalid VSHLIB KWBS chunk."});
+                if (tag == tag_u32("HGRP") && !deserialize_hit_groups(p, p + size, lib.hitGroups))
+                    return Result<ShaderLibrary>::err({ErrorCode::eDeserializeError, "Invalid VSHLIB HGRP chunk."});
+                if (tag == tag_u32("PROF") && !deserialize_profiles(p, p + size, lib))
+                    return Result<ShaderLibrary>::err({ErrorCode::eDeserializeError, "Invalid VSHLIB PROF chunk."});
+
+                p += size;
+            }
+        }
+
+        if (lib.keywordBitsets.entryCount != 0 && lib.keywordBitsets.entryCount != lib.entries.size())
+            return Result<ShaderLibrary>::err(
+                {ErrorCode::eDeserializeError, "VSHLIB KWBS row count does not match the TOC."});
+        if (!lib.profiles.empty() && lib.profileMasks.size() != lib.entries.size())
+            return Result<ShaderLibrary>::err(
+                {ErrorCode::eDeserializeError, "VSHLIB PROF mask count does not match the TOC."});
+
+        for (const auto& e : lib.entries)
+        {
+            if (e.layoutClass > lib.layoutClasses.size())
+                return Result<ShaderLibrary>::err(
+                    {ErrorCode::eDeserializeError, "VSHLIB entry references an unknown layout class."});
+        }
+
         return Result<ShaderLibrary>::ok(std::move(lib));
     }
 
+    const ShaderLibraryTOCEntry* find_vshlib_entry(const ShaderLibrary& lib, uint64_t keyHash, ShaderStage stage)
+    {
+        auto it = std::lower_bound(lib.entries.begin(),
+                                   lib.entries.end(),
+                                   std::pair<uint64_t, uint8_t>(keyHash, static_cast<uint8_t>(stage)),
+                                   [](const ShaderLibraryTOCEntry& e, const std::pair<uint64_t, uint8_t>& key) {
+                                       if (e.keyHash != key.first)
+                                           return e.keyHash < key.first;
+                                       return static_cast<uint8_t>(e.stage) < key.second;
+                                   });
+        return (it != lib.entries.end() && it->keyHash == keyHash && it->stage == stage) ? &*it : nullptr;
+    }
+
     Result<std::vector<uint8_t>> extract_vshlib_blob(const ShaderLibrary& lib, uint64_t keyHash, ShaderStage stage)
     {
-        for (const auto& e : lib.entries)
+        const auto* e = find_vshlib_entry(lib, keyHash, stage);
+        if (!e)
+            return Result<std::vector<uint8_t>>::err({ErrorCode::eIO, "VSHLIB entry not found."});
+
+        const uint64_t rel = e->offset - lib.blobOffset;
+        if (rel + e->size > lib.blobData.size())
+            return Result<std::vector<uint8_t>>::err({ErrorCode::eDeserializeError, "VSHLIB entry out of range."});
+
+        std::vector<uint8_t> out;
+        out.resize(static_cast<size_t>(e->size));
+        std::memcpy(out.data(), lib.blobData.data() + rel, static_cast<size_t>(e->size));
+        return Result<std::vector<uint8_t>>::ok(std::move(out));
+    }
+
+    std::span<const uint8_t> find_vshlib_blob(const ShaderLibrary& lib, uint64_t keyHash, ShaderStage stage)
+    {
+        const auto* e = find_vshlib_entry(lib, keyHash, stage);
+        if (!e)
+            return {};
+
+        const uint64_t rel = e->offset - lib.blobOffset;
+        if (e->offset < lib.blobOffset || rel + e->size > lib.blobData.size())
+            return {};
+        return std::span<const uint8_t>(lib.blobData.data() + rel, static_cast<size_t>(e->size));
+    }
+
+    uint32_t vshlib_set_layout(const ShaderLibrary& lib, uint32_t layoutClass, uint32_t set)
+    {
+        if (layoutClass == 0 || layoutClass > lib.layoutClasses.size())
+            return 0;
+
+        const auto& lc = lib.layoutClasses[layoutClass - 1];
+        return set < lc.setLayouts.size() ? lc.setLayouts[set] : 0;
+    }
+
+    int32_t find_vshlib_profile(const ShaderLibrary& lib, std::string_view name)
+    {
+        for (size_t i = 0; i < lib.profiles.size(); ++i)
         {
-            if (e.keyHash == keyHash && e.stage == stage)
-            {
-                const uint64_t blobBegin = sizeof(FileHeader);
-                const uint64_t rel       = e.offset - blobBegin;
-                if (rel + e.size > lib.blobData.size())
-                    return Result<std::vector<uint8_t>>::err(
-                        {ErrorCode::eDeserializeError, "VSHLIB entry out of range."});
-
-                std::vector<uint8_t> out;
-                out.resize(static_cast<size_t>(e.size));
-                std::memcpy(out.data(), lib.blobData.data() + rel, static_cast<size_t>(e.size));
-                return Result<std::vector<uint8_t>>::ok(std::move(out));
-            }
+            if (lib.profiles[i].name == name)
+                return static_cast<int32_t>(i);
         }
+        return -1;
+    }
+
+    bool vshlib_entry_in_profile(const ShaderLibrary& lib, size_t entry, uint32_t profile)
+    {
+        if (lib.profiles.empty())
+            return true;
+        if (entry >= lib.profileMasks.size() || profile >= lib.profiles.size())
+            return false;
+        return (lib.profileMasks[entry] >> profile) & 1u;
+    }
 
-        return Result<std::vector<uint8_t>>::err({ErrorCode::eIO, "VSHLIB entry not found."});
+    const ShaderLibraryHitGroup* find_vshlib_hit_group(const ShaderLibrary& lib, std::string_view name)
+    {
+        auto it = std::lower_bound(lib.hitGroups.begin(),
+                                   lib.hitGroups.end(),
+                                   name,
+                                   [](const ShaderLibraryHitGroup& g, std::string_view n) { return g.name < n; });
+        return (it != lib.hitGroups.end() && it->name == name) ? &*it : nullptr;
+    }
+
+    uint32_t hit_group_record_stride(const ShaderLibraryHitGroup& group, uint32_t handleSize, uint32_t handleAlignment)
+    {
+        const uint32_t a = std::max(handleAlignment, 1u);
+        return (handleSize + group.recordSize + a - 1) & ~(a - 1);
     }
 } // namespace vshadersystem
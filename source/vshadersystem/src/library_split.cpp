@@ -0,0 +1,373 @@
+#include "vshadersystem/library_split.hpp"
+#include "vshadersystem/binary.hpp"
+#include "vshadersystem/shader_id.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <string_view>
+#include <unordered_map>
+
+namespace vshadersystem
+{
+    static constexpr uint32_t kRouteVersion = 1;
+
+    // Partition names become file name parts.
+    static bool is_valid_partition_name(std::string_view name)
+    {
+        if (name.empty())
+            return false;
+
+        for (char c : name)
+        {
+            const bool ok = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_' ||
+                            c == '-' || c == '.';
+            if (!ok)
+                return false;
+        }
+        return true;
+    }
+
+    static std::string_view trim(std::string_view s)
+    {
+        while (!s.empty() && (s.front() == ' ' || s.front() == '\t'))
+            s.remove_prefix(1);
+        while (!s.empty() && (s.back() == ' ' || s.back() == '\t' || s.back() == '\r'))
+            s.remove_suffix(1);
+        return s;
+    }
+
+    Result<std::vector<ShaderGroup>> load_partition_manifest(const std::string& filePath)
+    {
+        std::ifstream f(filePath, std::ios::binary);
+        if (!f)
+            return Result<std::vector<ShaderGroup>>::err({ErrorCode::eIO, "Failed to open manifest: " + filePath});
+
+        std::vector<ShaderGroup> groups;
+        std::string              line;
+        size_t                   lineNo = 0;
+
+        while (std::getline(f, line))
+        {
+            ++lineNo;
+
+            std::string_view l = line;
+            if (const size_t hash = l.find('#'); hash != std::string_view::npos)
+                l = l.substr(0, hash);
+            l = trim(l);
+            if (l.empty())
+                continue;
+
+            const std::string where = filePath + ":" + std::to_string(lineNo);
+
+            if (l.front() == '[')
+            {
+                if (l.back() != ']' || !is_valid_partition_name(trim(l.substr(1, l.size() - 2))))
+                    return Result<std::vector<ShaderGroup>>::err(
+                        {ErrorCode::eParseError, where + ": expected [name] with letters, digits, '_', '-' or '.'"});
+
+                ShaderGroup g;
+                g.name = std::string(trim(l.substr(1, l.size() - 2)));
+                groups.push_back(std::move(g));
+                continue;
+            }
+
+            if (groups.empty())
+                return Result<std::vector<ShaderGroup>>::err(
+                    {ErrorCode::eParseError, where + ": shader id before the first [group]"});
+
+            groups.back().shaderIds.emplace_back(l);
+        }
+
+        return Result<std::vector<ShaderGroup>>::ok(std::move(groups));
+    }
+
+    Result<std::vector<LibraryPartition>> partition_library_entries(std::span<const ShaderLibraryEntryView> entries,
+                                                                    const LibraryPartitionPlan&             plan)
+    {
+        // Base partitions: groups, then default, then shared.
+        std::vector<std::string> bases;
+        for (const auto& g : plan.groups)
+            bases.push_back(g.name);
+        const size_t defaultBase = bases.size();
+        bases.push_back(plan.defaultPartition);
+        const size_t sharedBase = bases.size();
+        bases.push_back(plan.sharedPartition);
+
+        for (const auto& name : bases)
+        {
+            if (!is_valid_partition_name(name))
+                return Result<std::vector<LibraryPartition>>::err(
+                    {ErrorCode::eInvalidArgument, "Invalid partition name: '" + name + "'"});
+        }
+
+        std::unordered_map<uint64_t, size_t> baseOf;
+        for (size_t gi = 0; gi < plan.groups.size(); ++gi)
+        {
+            for (const auto& id : plan.groups[gi].shaderIds)
+            {
+                auto [it, inserted] = baseOf.emplace(shader_id_hash(id), gi);
+                if (!inserted && it->second != gi)
+                    it->second = sharedBase;
+            }
+        }
+
+        // (base, keyword value) -> partition; "" sorts first, so the unsplit partition precedes its values.
+        std::map<std::pair<size_t, std::string>, LibraryPartition> parts;
+        std::unordered_map<std::string, size_t>                    partsNamed; // name -> base, to catch collisions
+
+        for (const auto& e : entries)
+        {
+            uint64_t    shaderIdHash = 0;
+            std::string value;
+
+            // Blobs that are not .vshbin (or lack the keyword) stay in their base partition.
+            auto pr = peek_vshbin(e.blob);
+            if (pr.isOk())
+            {
+                shaderIdHash = pr.value().shaderIdHash;
+
+                if (!plan.keyword.empty())
+                {
+                    for (const auto& kv : pr.value().keywordValues)
+                    {
+                        if (kv.name != plan.keyword)
+                            continue;
+
+                        value = (kv.kind == KeywordValueKind::eEnum && kv.value < kv.enumValues.size()) ?
+                                    kv.enumValues[kv.value] :
+                                    std::to_string(kv.value);
+                        break;
+                    }
+                }
+            }
+
+            auto         bit  = baseOf.find(shaderIdHash);
+            const size_t base = (shaderIdHash != 0 && bit != baseOf.end()) ? bit->second : defaultBase;
+
+            auto& p = parts[{base, value}];
+            if (p.name.empty())
+            {
+                p.name = value.empty() ? bases[base] : bases[base] + "." + value;
+                if (!is_valid_partition_name(p.name))
+                    return Result<std::vector<LibraryPartition>>::err(
+                        {ErrorCode::eInvalidArgument, "Invalid partition name: '" + p.name + "'"});
+
+                // Group names may contain '.', so "a.x" can also be group "a" split by keyword value "x".
+                if (auto [it, inserted] = partsNamed.emplace(p.name, base); !inserted)
+                    return Result<std::vector<LibraryPartition>>::err(
+                        {ErrorCode::eInvalidArgument,
+                         "Partition name '" + p.name + "' is produced by both '" + bases[it->second] + "' and '" +
+                             bases[base] + "'; rename one of the groups"});
+            }
+
+            p.entries.push_back(e);
+            if (shaderIdHash != 0)
+                p.shaderIdHashes.push_back(shaderIdHash);
+        }
+
+        std::vector<LibraryPartition> out;
+        out.reserve(parts.size());
+        for (auto& [key, p] : parts)
+        {
+            std::sort(p.shaderIdHashes.begin(), p.shaderIdHashes.end());
+            p.shaderIdHashes.erase(std::unique(p.shaderIdHashes.begin(), p.shaderIdHashes.end()),
+                                   p.shaderIdHashes.end());
+            out.push_back(std::move(p));
+        }
+
+        return Result<std::vector<LibraryPartition>>::ok(std::move(out));
+    }
+
+    // ------------------------------------------------------------
+    // LibraryRoutingIndex
+    // ------------------------------------------------------------
+    static bool route_less(const LibraryRoute& r, uint64_t shaderIdHash) { return r.shaderIdHash < shaderIdHash; }
+
+    uint32_t LibraryRoutingIndex::addPartition(std::string name, std::string file)
+    {
+        m_Partitions.push_back({std::move(name), std::move(file)});
+        return static_cast<uint32_t>(m_Partitions.size() - 1);
+    }
+
+    void LibraryRoutingIndex::addRoute(uint64_t shaderIdHash, uint32_t partition)
+    {
+        auto it = std::lower_bound(m_Routes.begin(), m_Routes.end(), shaderIdHash, route_less);
+        if (it == m_Routes.end() || it->shaderIdHash != shaderIdHash)
+            it = m_Routes.insert(it, LibraryRoute {shaderIdHash, {}});
+
+        auto pit = std::lower_bound(it->partitions.begin(), it->partitions.end(), partition);
+        if (pit == it->partitions.end() || *pit != partition)
+            it->partitions.insert(pit, partition);
+    }
+
+    const LibraryRoute* LibraryRoutingIndex::find(uint64_t shaderIdHash) const
+    {
+        auto it = std::lower_bound(m_Routes.begin(), m_Routes.end(), shaderIdHash, route_less);
+        return (it != m_Routes.end() && it->shaderIdHash == shaderIdHash) ? &*it : nullptr;
+    }
+
+    std::vector<uint32_t> LibraryRoutingIndex::partitionsFor(std::span<const uint64_t> shaderIdHashes) const
+    {
+        std::vector<uint32_t> out;
+        for (uint64_t h : shaderIdHashes)
+        {
+            if (const auto* r = find(h))
+                out.insert(out.end(), r->partitions.begin(), r->partitions.end());
+        }
+
+        std::sort(out.begin(), out.end());
+        out.erase(std::unique(out.begin(), out.end()), out.end());
+        return out;
+    }
+
+    Result<void> LibraryRoutingIndex::save(const std::string& filePath) const
+    {
+        std::ofstream f(filePath, std::ios::binary | std::ios::trunc);
+        if (!f)
+            return Result<void>::err({ErrorCode::eIO, "Failed to open routing index for write: " + filePath});
+
+        f << "vshroute\t" << kRouteVersion << "\n";
+        for (const auto& p : m_Partitions)
+            f << "P\t" << p.name << "\t" << p.file << "\n";
+
+        for (const auto& r : m_Routes)
+        {
+            char buf[32];
+            std::snprintf(buf, sizeof(buf), "%016llx", static_cast<unsigned long long>(r.shaderIdHash));
+            f << "R\t" << buf;
+            for (uint32_t p : r.partitions)
+                f << "\t" << p;
+            f << "\n";
+        }
+
+        if (!f)
+            return Result<void>::err({ErrorCode::eIO, "Failed to write routing index: " + filePath});
+
+        return Result<void>::ok();
+    }
+
+    static void split_tabs(std::string_view line, std::vector<std::string_view>& out)
+    {
+        out.clear();
+        size_t i = 0;
+        while (true)
+        {
+            size_t j = line.find('\t', i);
+            if (j == std::string_view::npos)
+            {
+                out.push_back(line.substr(i));
+                return;
+            }
+            out.push_back(line.substr(i, j - i));
+            i = j + 1;
+        }
+    }
+
+    static bool parse_u64(std::string_view s, int base, uint64_t& out)
+    {
+        if (s.empty())
+            return false;
+
+        const std::string str(s);
+        char*             end = nullptr;
+        out                   = std::strtoull(str.c_str(), &end, base);
+        return end == str.c_str() + str.size();
+    }
+
+    Result<LibraryRoutingIndex> LibraryRoutingIndex::load(const std::string& filePath)
+    {
+        std::ifstream f(filePath, std::ios::binary);
+        if (!f)
+            return Result<LibraryRoutingIndex>::err({ErrorCode::eIO, "Failed to open routing index: " + filePath});
+
+        LibraryRoutingIndex           index;
+        std::string                   line;
+        std::vector<std::string_view> cols;
+
+        if (!std::getline(f, line))
+            return Result<LibraryRoutingIndex>::err({ErrorCode::eParseError, "Empty routing index: " + filePath});
+
+        if (!line.empty() && line.back() == '\r')
+            line.pop_back();
+
+        split_tabs(line, cols);
+        if (cols.size() != 2 || cols[0] != "vshroute" || cols[1] != std::to_string(kRouteVersion))
+            return Result<LibraryRoutingIndex>::err(
+                {ErrorCode::eParseError, "Unsupported routing index version: " + filePath});
+
+        while (std::getline(f, line))
+        {
+            if (!line.empty() && line.back() == '\r')
+                line.pop_back();
+            if (line.empty())
+                continue;
+
+            split_tabs(line, cols);
+
+            bool ok = false;
+            if (cols[0] == "P" && cols.size() == 3)
+            {
+                index.addPartition(std::string(cols[1]), std::string(cols[2]));
+                ok = true;
+            }
+            else if (cols[0] == "R" && cols.size() >= 3)
+            {
+                uint64_t hash = 0;
+                ok            = parse_u64(cols[1], 16, hash);
+                for (size_t i = 2; ok && i < cols.size(); ++i)
+                {
+                    uint64_t p = 0;
+                    ok         = parse_u64(cols[i], 10, p) && p < index.m_Partitions.size();
+                    if (ok)
+                        index.addRoute(hash, static_cast<uint32_t>(p));
+                }
+            }
+
+            if (!ok)
+                return Result<LibraryRoutingIndex>::err(
+                    {ErrorCode::eParseError, "Malformed routing index line: " + line});
+        }
+
+        return Result<LibraryRoutingIndex>::ok(std::move(index));
+    }
+
+    Result<LibraryRoutingIndex> write_library_partitions(const std::vector<LibraryPartition>&     partitions,
+                                                         const std::string&                       outDir,
+                                                         const std::string&                       baseName,
+                                                         const std::vector<uint8_t>*              engineKeywords,
+                                                         const std::vector<ShaderLibraryProfile>* profiles)
+    {
+        std::error_code ec;
+        std::filesystem::create_directories(outDir, ec);
+        if (ec)
+            return Result<LibraryRoutingIndex>::err(
+                {ErrorCode::eIO, "Failed to create output directory: " + outDir + ": " + ec.message()});
+
+        const std::filesystem::path dir(outDir);
+
+        LibraryRoutingIndex index;
+        for (const auto& p : partitions)
+        {
+            const std::string file = baseName + "." + p.name + ".vshlib";
+
+            auto w = write_vslib(
+                (dir / file).string(), std::span<const ShaderLibraryEntryView>(p.entries), engineKeywords, profiles);
+            if (!w.isOk())
+                return Result<LibraryRoutingIndex>::err(w.error());
+
+            const uint32_t pi = index.addPartition(p.name, file);
+            for (uint64_t h : p.shaderIdHashes)
+                index.addRoute(h, pi);
+        }
+
+        auto s = index.save((dir / (baseName + ".vshroute")).string());
+        if (!s.isOk())
+            return Result<LibraryRoutingIndex>::err(s.error());
+
+        return Result<LibraryRoutingIndex>::ok(std::move(index));
+    }
+} // namespace vshadersystem
@@ -0,0 +1,163 @@
+#include "vshadersystem/link_modules.hpp"
+#include "vshadersystem/compiler.hpp"
+#include "vshadersystem/hash.hpp"
+
+#include <chrono>
+
+#ifdef VSHADERSYSTEM_HAS_SPIRV_TOOLS
+#include <spirv-tools/linker.hpp>
+#endif
+
+namespace vshadersystem
+{
+    bool spirv_linking_available()
+    {
+#ifdef VSHADERSYSTEM_HAS_SPIRV_TOOLS
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    LinkModuleCache::ModuleResult
+    LinkModuleCache::get(const std::string& path, ShaderStage stage, const std::vector<std::string>& includeDirs)
+    {
+        IncludeCache::File file;
+        if (!m_Files.load(path, file))
+            return ModuleResult::err({ErrorCode::eIO, "Failed to open link module: " + path});
+
+        uint64_t key = file.hash;
+        key          = xxhash64(&stage, sizeof(stage), key);
+        for (const auto& dir : includeDirs)
+            key = xxhash64(dir, key);
+
+        // The first request for a key compiles it; later requests for the same key wait on its future.
+        std::promise<ModuleResult>       promise;
+        std::shared_future<ModuleResult> pending;
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+
+            auto [it, inserted] = m_Modules.try_emplace(key);
+            if (!inserted)
+                pending = it->second;
+            else
+                it->second = promise.get_future().share();
+        }
+        if (pending.valid())
+            return pending.get();
+
+        SourceInput src;
+        src.virtualPath      = path;
+        src.sharedSourceText = file.text;
+
+        CompileOptions opt;
+        opt.stage        = stage;
+        opt.includeDirs  = includeDirs;
+        opt.includeCache = &m_Files;
+        opt.compileOnly  = true;
+
+        const auto start = std::chrono::steady_clock::now();
+
+        auto c = compile_glsl_to_spirv(src, opt);
+        if (!c.isOk())
+        {
+            auto r = ModuleResult::err({c.error().code, "Link module " + path + ": " + c.error().message});
+            promise.set_value(r);
+            return r;
+        }
+
+        auto m       = std::make_shared<LinkModule>();
+        m->path      = path;
+        m->spirv     = std::move(c.value().spirv);
+        m->compileMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        m->hash = file.hash;
+        for (uint64_t h : c.value().dependencyHashes)
+            m->hash = xxhash64(&h, sizeof(h), m->hash);
+
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            ++m_Compiled;
+            m_TotalCompileMs += m->compileMs;
+        }
+
+        auto r = ModuleResult::ok(std::move(m));
+        promise.set_value(r);
+        return r;
+    }
+
+    size_t LinkModuleCache::compiledCount() const
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        return m_Compiled;
+    }
+
+    double LinkModuleCache::totalCompileMs() const
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        return m_TotalCompileMs;
+    }
+
+#ifdef VSHADERSYSTEM_HAS_SPIRV_TOOLS
+    // Oldest Vulkan environment accepting the requested SPIR-V version. 0 is the compiler's default
+    // target (Vulkan 1.2, SPIR-V 1.5), which validation also checks against.
+    static spv_target_env link_target_env(int spirvVersion)
+    {
+        if (spirvVersion == 0)
+            return SPV_ENV_VULKAN_1_2;
+        if (spirvVersion <= 0x10000)
+            return SPV_ENV_VULKAN_1_0;
+        if (spirvVersion <= 0x10300)
+            return SPV_ENV_VULKAN_1_1;
+        if (spirvVersion <= 0x10400)
+            return SPV_ENV_VULKAN_1_1_SPIRV_1_4;
+        if (spirvVersion <= 0x10500)
+            return SPV_ENV_VULKAN_1_2;
+        return SPV_ENV_VULKAN_1_3;
+    }
+#endif
+
+    Result<std::vector<uint32_t>> link_spirv_modules(const std::vector<uint32_t>&                          shader,
+                                                     const std::vector<std::shared_ptr<const LinkModule>>& modules,
+                                                     int                                                   spirvVersion)
+    {
+#ifdef VSHADERSYSTEM_HAS_SPIRV_TOOLS
+        std::vector<const uint32_t*> binaries;
+        std::vector<size_t>          sizes;
+        binaries.reserve(modules.size() + 1);
+        sizes.reserve(modules.size() + 1);
+
+        binaries.push_back(shader.data());
+        sizes.push_back(shader.size());
+        for (const auto& m : modules)
+        {
+            binaries.push_back(m->spirv.data());
+            sizes.push_back(m->spirv.size());
+        }
+
+        std::string             diagnostics;
+        spvtools::Context       context(link_target_env(spirvVersion));
+        spvtools::LinkerOptions options;
+        options.SetCreateLibrary(false); // drop Linkage, fail on unresolved imports
+
+        context.SetMessageConsumer([&](spv_message_level_t, const char*, const spv_position_t&, const char* message) {
+            diagnostics += message;
+            diagnostics += "\n";
+        });
+
+        std::vector<uint32_t> linked;
+        if (spvtools::Link(context, binaries.data(), sizes.data(), binaries.size(), &linked, options) != SPV_SUCCESS)
+            return Result<std::vector<uint32_t>>::err(
+                {ErrorCode::eCompileError, "SPIR-V link failed:\n" + diagnostics});
+
+        return Result<std::vector<uint32_t>>::ok(std::move(linked));
+#else
+        (void)shader;
+        (void)modules;
+        (void)spirvVersion;
+        return Result<std::vector<uint32_t>>::err(
+            {ErrorCode::eInvalidArgument,
+             "SPIR-V linking is unavailable: vshadersystem was built without the vshadersystem_spirv_tools option."});
+#endif
+    }
+} // namespace vshadersystem
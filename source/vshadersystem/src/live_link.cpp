@@ -0,0 +1,472 @@
+#include "vshadersystem/live_link.hpp"
+#include "vshadersystem/binary.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <utility>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <winsock2.h>
+#include <afunix.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+namespace vshadersystem
+{
+    // ------------------------------------------------------------
+    // Platform layer: Unix domain sockets (AF_UNIX is available on Windows 10 1803 and later)
+    // ------------------------------------------------------------
+    namespace
+    {
+        constexpr char     kHelloMagic[4] = {'V', 'S', 'L', 'L'};
+        constexpr uint32_t kHeaderSize    = 20; // kind, stage, reserved, keyHash, shaderIdHash
+        constexpr uint32_t kMaxFrameSize  = 256u * 1024u * 1024u;
+        constexpr int      kSendTimeoutMs = 3000;
+
+#if defined(_WIN32)
+        using SocketHandle = SOCKET;
+
+        SocketHandle to_socket(intptr_t s) { return static_cast<SOCKET>(s); }
+
+        bool init_sockets()
+        {
+            static const bool ok = [] {
+                WSADATA data {};
+                return WSAStartup(MAKEWORD(2, 2), &data) == 0;
+            }();
+            return ok;
+        }
+
+        void close_socket(intptr_t s) { closesocket(to_socket(s)); }
+
+        bool set_non_blocking(intptr_t s, bool enable)
+        {
+            u_long mode = enable ? 1 : 0;
+            return ioctlsocket(to_socket(s), FIONBIO, &mode) == 0;
+        }
+
+        void set_send_timeout(intptr_t s, int ms)
+        {
+            const DWORD timeout = static_cast<DWORD>(ms);
+            setsockopt(
+                to_socket(s), SOL_SOCKET, SO_SNDTIMEO, reinterpret_cast<const char*>(&timeout), sizeof(timeout));
+        }
+
+        int send_some(intptr_t s, const uint8_t* data, size_t size)
+        {
+            const int chunk = static_cast<int>(std::min<size_t>(size, 1u << 30));
+            return send(to_socket(s), reinterpret_cast<const char*>(data), chunk, 0);
+        }
+
+        int recv_some(intptr_t s, uint8_t* data, size_t size)
+        {
+            const int chunk = static_cast<int>(std::min<size_t>(size, 1u << 30));
+            return recv(to_socket(s), reinterpret_cast<char*>(data), chunk, 0);
+        }
+
+        void shutdown_socket(intptr_t s) { shutdown(to_socket(s), SD_BOTH); }
+#else
+        using SocketHandle = int;
+
+        SocketHandle to_socket(intptr_t s) { return static_cast<int>(s); }
+
+        bool init_sockets() { return true; }
+
+        void close_socket(intptr_t s) { ::close(to_socket(s)); }
+
+        bool set_non_blocking(intptr_t s, bool enable)
+        {
+            const int fd    = to_socket(s);
+            const int flags = fcntl(fd, F_GETFL, 0);
+            if (flags < 0)
+                return false;
+            return fcntl(fd, F_SETFL, enable ? (flags | O_NONBLOCK) : (flags & ~O_NONBLOCK)) == 0;
+        }
+
+        void set_send_timeout(intptr_t s, int ms)
+        {
+            timeval timeout {};
+            timeout.tv_sec  = ms / 1000;
+            timeout.tv_usec = (ms % 1000) * 1000;
+            setsockopt(to_socket(s), SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+
+#if defined(__APPLE__)
+            // No MSG_NOSIGNAL on Apple platforms; a closed peer must not raise SIGPIPE.
+            int on = 1;
+            setsockopt(to_socket(s), SOL_SOCKET, SO_NOSIGPIPE, &on, sizeof(on));
+#endif
+        }
+
+        ssize_t send_some(intptr_t s, const uint8_t* data, size_t size)
+        {
+#if defined(MSG_NOSIGNAL)
+            constexpr int flags = MSG_NOSIGNAL;
+#else
+            constexpr int flags = 0;
+#endif
+            ssize_t n;
+            while ((n = send(to_socket(s), data, size, flags)) < 0 && errno == EINTR)
+            {
+            }
+            return n;
+        }
+
+        ssize_t recv_some(intptr_t s, uint8_t* data, size_t size)
+        {
+            ssize_t n;
+            while ((n = recv(to_socket(s), data, size, 0)) < 0 && errno == EINTR)
+            {
+            }
+            return n;
+        }
+
+        void shutdown_socket(intptr_t s) { shutdown(to_socket(s), SHUT_RDWR); }
+#endif
+
+        bool send_exact(intptr_t s, const uint8_t* data, size_t size)
+        {
+            while (size > 0)
+            {
+                const auto n = send_some(s, data, size);
+                if (n <= 0)
+                    return false;
+                data += n;
+                size -= static_cast<size_t>(n);
+            }
+            return true;
+        }
+
+        bool recv_exact(intptr_t s, uint8_t* data, size_t size)
+        {
+            while (size > 0)
+            {
+                const auto n = recv_some(s, data, size);
+                if (n <= 0)
+                    return false;
+                data += n;
+                size -= static_cast<size_t>(n);
+            }
+            return true;
+        }
+
+        Result<sockaddr_un> make_address(const std::string& socketPath)
+        {
+            sockaddr_un addr {};
+            addr.sun_family = AF_UNIX;
+            if (socketPath.empty() || socketPath.size() >= sizeof(addr.sun_path))
+                return Result<sockaddr_un>::err(
+                    {ErrorCode::eInvalidArgument, "Live link socket path is empty or too long: " + socketPath});
+
+            std::memcpy(addr.sun_path, socketPath.data(), socketPath.size());
+            return Result<sockaddr_un>::ok(addr);
+        }
+
+        intptr_t open_socket()
+        {
+            if (!init_sockets())
+                return -1;
+#if defined(_WIN32)
+            const SOCKET s = socket(AF_UNIX, SOCK_STREAM, 0);
+            return s == INVALID_SOCKET ? -1 : static_cast<intptr_t>(s);
+#else
+            const int s = socket(AF_UNIX, SOCK_STREAM, 0);
+            if (s >= 0)
+                fcntl(s, F_SETFD, FD_CLOEXEC);
+            return s;
+#endif
+        }
+
+        std::vector<uint8_t> encode_frame(const LiveLinkMessage& message)
+        {
+            const uint32_t size = kHeaderSize + static_cast<uint32_t>(message.payload.size());
+
+            std::vector<uint8_t> frame(sizeof(size) + size);
+            uint8_t*             p = frame.data();
+
+            std::memcpy(p, &size, sizeof(size));
+            p[4] = static_cast<uint8_t>(message.kind);
+            p[5] = static_cast<uint8_t>(message.stage);
+            p[6] = 0;
+            p[7] = 0;
+            std::memcpy(p + 8, &message.keyHash, sizeof(message.keyHash));
+            std::memcpy(p + 16, &message.shaderIdHash, sizeof(message.shaderIdHash));
+            if (!message.payload.empty())
+                std::memcpy(p + 24, message.payload.data(), message.payload.size());
+            return frame;
+        }
+    } // namespace
+
+    // ------------------------------------------------------------
+    // LiveLinkServer
+    // ------------------------------------------------------------
+    LiveLinkServer::~LiveLinkServer() { close(); }
+
+    Result<void> LiveLinkServer::open(const std::string& socketPath)
+    {
+        close();
+
+        auto ar = make_address(socketPath);
+        if (!ar.isOk())
+            return Result<void>::err(ar.error());
+
+        // A socket file left behind by a killed watcher would make bind() fail.
+        std::error_code ec;
+        std::filesystem::remove(socketPath, ec);
+
+        const intptr_t s = open_socket();
+        if (s < 0)
+            return Result<void>::err({ErrorCode::eIO, "Failed to create live link socket."});
+
+        const sockaddr_un& addr = ar.value();
+        if (bind(to_socket(s), reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) != 0 ||
+            listen(to_socket(s), 8) != 0 || !set_non_blocking(s, true))
+        {
+            close_socket(s);
+            return Result<void>::err({ErrorCode::eIO, "Failed to listen on live link socket: " + socketPath});
+        }
+
+        m_Listener = s;
+        m_Path     = socketPath;
+        return Result<void>::ok();
+    }
+
+    void LiveLinkServer::close()
+    {
+        for (intptr_t c : m_Clients)
+            close_socket(c);
+        m_Clients.clear();
+        m_Replay.clear();
+
+        if (m_Listener >= 0)
+        {
+            close_socket(m_Listener);
+            m_Listener = -1;
+
+            std::error_code ec;
+            std::filesystem::remove(m_Path, ec);
+        }
+        m_Path.clear();
+    }
+
+    bool LiveLinkServer::sendTo(intptr_t client, const std::vector<uint8_t>& frame)
+    {
+        return send_exact(client, frame.data(), frame.size());
+    }
+
+    size_t LiveLinkServer::accept()
+    {
+        if (m_Listener < 0)
+            return 0;
+
+        std::vector<uint8_t> hello(sizeof(kHelloMagic) + sizeof(kLiveLinkVersion));
+        std::memcpy(hello.data(), kHelloMagic, sizeof(kHelloMagic));
+        std::memcpy(hello.data() + sizeof(kHelloMagic), &kLiveLinkVersion, sizeof(kLiveLinkVersion));
+
+        const std::vector<uint8_t> commitFrame =
+            encode_frame({LiveLinkMessageKind::eCommit, ShaderStage::eUnknown, 0, 0, {}});
+
+        size_t accepted = 0;
+        for (;;)
+        {
+#if defined(_WIN32)
+            const SOCKET   cs = ::accept(to_socket(m_Listener), nullptr, nullptr);
+            const intptr_t c  = cs == INVALID_SOCKET ? -1 : static_cast<intptr_t>(cs);
+#else
+            const intptr_t c = ::accept(to_socket(m_Listener), nullptr, nullptr);
+            if (c >= 0)
+                fcntl(to_socket(c), F_SETFD, FD_CLOEXEC);
+#endif
+            if (c < 0)
+                break;
+
+            // Accepted sockets may inherit the listener's non-blocking mode; sends block with a timeout instead.
+            set_non_blocking(c, false);
+            set_send_timeout(c, kSendTimeoutMs);
+
+            bool ok = sendTo(c, hello);
+            for (auto it = m_Replay.begin(); ok && it != m_Replay.end(); ++it)
+                ok = sendTo(c, it->second);
+            if (ok && !m_Replay.empty())
+                ok = sendTo(c, commitFrame);
+
+            if (!ok)
+            {
+                close_socket(c);
+                continue;
+            }
+
+            m_Clients.push_back(c);
+            ++accepted;
+        }
+        return accepted;
+    }
+
+    void LiveLinkServer::publish(const LiveLinkMessage& message)
+    {
+        std::vector<uint8_t> frame = encode_frame(message);
+
+        auto failed = std::remove_if(m_Clients.begin(), m_Clients.end(), [&](intptr_t c) {
+            if (sendTo(c, frame))
+                return false;
+            close_socket(c);
+            return true;
+        });
+        m_Clients.erase(failed, m_Clients.end());
+
+        if (message.kind == LiveLinkMessageKind::eBinary)
+            m_Replay[{message.keyHash, message.stage}] = std::move(frame);
+    }
+
+    void LiveLinkServer::commit() { publish({LiveLinkMessageKind::eCommit, ShaderStage::eUnknown, 0, 0, {}}); }
+
+    // ------------------------------------------------------------
+    // LiveLinkReceiver
+    // ------------------------------------------------------------
+    LiveLinkReceiver::~LiveLinkReceiver() { disconnect(); }
+
+    Result<void> LiveLinkReceiver::connect(const std::string& socketPath)
+    {
+        disconnect();
+
+        auto ar = make_address(socketPath);
+        if (!ar.isOk())
+            return Result<void>::err(ar.error());
+
+        const intptr_t s = open_socket();
+        if (s < 0)
+            return Result<void>::err({ErrorCode::eIO, "Failed to create live link socket."});
+
+        const sockaddr_un& addr = ar.value();
+        if (::connect(to_socket(s), reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) != 0)
+        {
+            close_socket(s);
+            return Result<void>::err({ErrorCode::eIO, "No live link listening on: " + socketPath});
+        }
+
+        m_Socket = s;
+        m_Connected.store(true);
+        m_Thread = std::thread([this]() { readLoop(); });
+        return Result<void>::ok();
+    }
+
+    void LiveLinkReceiver::disconnect()
+    {
+        if (m_Socket < 0)
+            return;
+
+        shutdown_socket(m_Socket); // wakes the reader
+        if (m_Thread.joinable())
+            m_Thread.join();
+
+        close_socket(m_Socket);
+        m_Socket = -1;
+        m_Connected.store(false);
+        m_Pending.clear();
+    }
+
+    void LiveLinkReceiver::readLoop()
+    {
+        uint8_t    magic[sizeof(kHelloMagic)] {};
+        uint32_t   version = 0;
+        const bool hello   = recv_exact(m_Socket, magic, sizeof(magic)) &&
+                           recv_exact(m_Socket, reinterpret_cast<uint8_t*>(&version), sizeof(version)) &&
+                           std::memcmp(magic, kHelloMagic, sizeof(magic)) == 0 && version == kLiveLinkVersion;
+
+        while (hello)
+        {
+            uint32_t size = 0;
+            uint8_t  header[kHeaderSize];
+            if (!recv_exact(m_Socket, reinterpret_cast<uint8_t*>(&size), sizeof(size)) || size < kHeaderSize ||
+                size > kMaxFrameSize || !recv_exact(m_Socket, header, sizeof(header)))
+                break;
+
+            LiveLinkMessage message;
+            message.kind  = static_cast<LiveLinkMessageKind>(header[0]);
+            message.stage = static_cast<ShaderStage>(header[1]);
+            std::memcpy(&message.keyHash, header + 4, sizeof(message.keyHash));
+            std::memcpy(&message.shaderIdHash, header + 12, sizeof(message.shaderIdHash));
+
+            message.payload.resize(size - kHeaderSize);
+            if (!recv_exact(m_Socket, message.payload.data(), message.payload.size()))
+                break;
+
+            if (message.kind != LiveLinkMessageKind::eCommit)
+            {
+                m_Pending.push_back(std::move(message));
+                continue;
+            }
+
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            for (auto& m : m_Pending)
+                m_Committed.push_back(std::move(m));
+            m_Pending.clear();
+        }
+
+        // A batch cut off by the server going away is dropped.
+        m_Pending.clear();
+        m_Connected.store(false);
+    }
+
+    std::vector<LiveLinkMessage> LiveLinkReceiver::poll()
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+
+        std::vector<LiveLinkMessage> out(std::make_move_iterator(m_Committed.begin()),
+                                         std::make_move_iterator(m_Committed.end()));
+        m_Committed.clear();
+        return out;
+    }
+
+    // ------------------------------------------------------------
+    // ShaderLibraryOverlay
+    // ------------------------------------------------------------
+    void ShaderLibraryOverlay::insert(uint64_t keyHash, ShaderStage stage, std::vector<uint8_t> blob)
+    {
+        m_Entries[{keyHash, stage}] = std::move(blob);
+    }
+
+    size_t ShaderLibraryOverlay::apply(std::span<const LiveLinkMessage> messages)
+    {
+        size_t inserted = 0;
+        for (const auto& m : messages)
+        {
+            if (m.kind != LiveLinkMessageKind::eBinary)
+                continue;
+            insert(m.keyHash, m.stage, m.payload);
+            ++inserted;
+        }
+        return inserted;
+    }
+
+    std::span<const uint8_t> ShaderLibraryOverlay::findBlob(uint64_t keyHash, ShaderStage stage) const
+    {
+        if (auto it = m_Entries.find({keyHash, stage}); it != m_Entries.end())
+            return it->second;
+        if (m_Base)
+            return find_vshlib_blob(*m_Base, keyHash, stage);
+        return {};
+    }
+
+    Result<ShaderBinary> ShaderLibraryOverlay::read(uint64_t keyHash, ShaderStage stage) const
+    {
+        const auto blob = findBlob(keyHash, stage);
+        if (blob.empty())
+            return Result<ShaderBinary>::err({ErrorCode::eIO, "Shader entry not found in overlay or library."});
+        return read_vshbin(blob);
+    }
+
+    bool ShaderLibraryOverlay::overrides(uint64_t keyHash, ShaderStage stage) const
+    {
+        return m_Entries.find({keyHash, stage}) != m_Entries.end();
+    }
+} // namespace vshadersystem
@@ -0,0 +1,130 @@
+#include "vshadersystem/material_layout.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+namespace vshadersystem
+{
+    namespace
+    {
+        struct LayoutItem
+        {
+            const MaterialParamDesc* param      = nullptr;
+            uint32_t                 size       = 0; // std140
+            uint32_t                 align      = 4; // std140
+            uint32_t                 scalarSize = 0; // scalar block layout
+        };
+
+        uint32_t align_up(uint32_t v, uint32_t a) { return (v + a - 1) / a * a; }
+
+        LayoutItem make_item(const MaterialParamDesc& p)
+        {
+            LayoutItem it;
+            it.param      = &p;
+            it.size       = p.size;
+            it.scalarSize = p.size;
+
+            if (p.type == ParamType::eMat3 || p.type == ParamType::eMat4)
+            {
+                // std140 pads matrix columns to vec4; scalar layout packs them.
+                it.align = 16;
+                if (p.type == ParamType::eMat3 && p.size == 48)
+                    it.scalarSize = 36;
+                return it;
+            }
+
+            if (p.size <= 4)
+                it.align = 4;
+            else if (p.size <= 8)
+                it.align = 8;
+            else
+                it.align = 16;
+
+            return it;
+        }
+
+        uint32_t std140_size(const std::vector<LayoutItem>& items)
+        {
+            uint32_t offset = 0;
+            for (const auto& it : items)
+                offset = align_up(offset, it.align) + it.size;
+            return align_up(offset, 16);
+        }
+
+        // Greedy: at each step place the member that needs the least padding at the current offset,
+        // preferring larger alignment, then larger size, then declaration order (stable).
+        std::vector<LayoutItem> tighter_order(std::vector<LayoutItem> remaining)
+        {
+            std::vector<LayoutItem> out;
+            out.reserve(remaining.size());
+
+            uint32_t offset = 0;
+            while (!remaining.empty())
+            {
+                size_t   best    = 0;
+                uint32_t bestPad = UINT32_MAX;
+                for (size_t i = 0; i < remaining.size(); ++i)
+                {
+                    const auto&    it  = remaining[i];
+                    const uint32_t pad = align_up(offset, it.align) - offset;
+                    const auto&    b   = remaining[best];
+
+                    const bool better = (pad < bestPad) ||
+                                        (pad == bestPad && (it.align > b.align ||
+                                                            (it.align == b.align && it.size > b.size)));
+                    if (better)
+                    {
+                        best    = i;
+                        bestPad = pad;
+                    }
+                }
+
+                offset = align_up(offset, remaining[best].align) + remaining[best].size;
+                out.push_back(remaining[best]);
+                remaining.erase(remaining.begin() + static_cast<std::ptrdiff_t>(best));
+            }
+
+            return out;
+        }
+    } // namespace
+
+    MaterialLayoutReport analyze_material_layout(const MaterialDescription& mdesc)
+    {
+        MaterialLayoutReport r;
+        r.declaredSize = mdesc.materialParamSize;
+
+        std::vector<LayoutItem> items;
+        items.reserve(mdesc.params.size());
+        for (const auto& p : mdesc.params)
+            items.push_back(make_item(p));
+
+        std::stable_sort(items.begin(), items.end(), [](const LayoutItem& a, const LayoutItem& b) {
+            return a.param->offset < b.param->offset;
+        });
+
+        uint32_t scalarOffset = 0;
+        for (const auto& it : items)
+        {
+            r.payloadBytes += it.scalarSize;
+            scalarOffset = align_up(scalarOffset, 4) + it.scalarSize;
+        }
+        r.scalarSize   = scalarOffset;
+        r.paddingBytes = r.declaredSize > r.payloadBytes ? r.declaredSize - r.payloadBytes : 0;
+
+        const uint32_t currentSize = std::max(r.declaredSize, std140_size(items));
+        const auto     ordered     = tighter_order(items);
+        const uint32_t orderedSize = std140_size(ordered);
+
+        r.optimizedSize = currentSize;
+        if (orderedSize < currentSize)
+        {
+            r.optimizedSize = orderedSize;
+            r.suggestedOrder.reserve(ordered.size());
+            for (const auto& it : ordered)
+                r.suggestedOrder.push_back(it.param->name);
+        }
+
+        return r;
+    }
+} // namespace vshadersystem
@@ -0,0 +1,284 @@
+#include "vshadersystem/material_pool.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <sstream>
+
+namespace vshadersystem
+{
+    namespace
+    {
+        uint32_t align_up(uint32_t v, uint32_t a) { return (v + a - 1) / a * a; }
+
+        // Number of float/int components a parameter takes from the caller.
+        uint32_t component_count(ParamType t)
+        {
+            switch (t)
+            {
+                case ParamType::eVec2:
+                    return 2;
+                case ParamType::eVec3:
+                    return 3;
+                case ParamType::eVec4:
+                    return 4;
+                case ParamType::eMat3:
+                    return 9;
+                case ParamType::eMat4:
+                    return 16;
+                default:
+                    return 1;
+            }
+        }
+
+        bool is_float_type(ParamType t)
+        {
+            return t != ParamType::eInt && t != ParamType::eUInt && t != ParamType::eBool;
+        }
+
+        // std140 byte offset of component i inside the parameter (matrix columns padded to vec4).
+        uint32_t component_offset(ParamType t, uint32_t i)
+        {
+            if (t == ParamType::eMat3)
+                return (i / 3) * 16 + (i % 3) * 4;
+            return i * 4;
+        }
+
+        uint32_t block_size(const MaterialDescription& mdesc)
+        {
+            uint32_t size = mdesc.materialParamSize;
+            for (const auto& p : mdesc.params)
+                size = std::max(size, p.offset + p.size);
+            return align_up(size, 16);
+        }
+
+        const char* glsl_type_name(ParamType t)
+        {
+            switch (t)
+            {
+                case ParamType::eFloat:
+                    return "float";
+                case ParamType::eVec2:
+                    return "vec2";
+                case ParamType::eVec3:
+                    return "vec3";
+                case ParamType::eVec4:
+                    return "vec4";
+                case ParamType::eInt:
+                    return "int";
+                case ParamType::eUInt:
+                    return "uint";
+                case ParamType::eBool:
+                    return "bool";
+                case ParamType::eMat3:
+                    return "mat3";
+                case ParamType::eMat4:
+                    return "mat4";
+            }
+            return "float";
+        }
+
+        std::string float_word(const std::string& words, uint32_t word)
+        {
+            return "uintBitsToFloat(" + words + "[w + " + std::to_string(word) + "u])";
+        }
+
+        std::string vector_expr(const std::string& words, const char* type, uint32_t firstWord, uint32_t n)
+        {
+            std::string s = std::string(type) + "(";
+            for (uint32_t i = 0; i < n; ++i)
+            {
+                if (i)
+                    s += ", ";
+                s += float_word(words, firstWord + i);
+            }
+            return s + ")";
+        }
+
+        std::string decode_expr(const MaterialParamDesc& p, const std::string& words)
+        {
+            switch (p.type)
+            {
+                case ParamType::eFloat:
+                    return float_word(words, 0);
+                case ParamType::eVec2:
+                    return vector_expr(words, "vec2", 0, 2);
+                case ParamType::eVec3:
+                    return vector_expr(words, "vec3", 0, 3);
+                case ParamType::eVec4:
+                    return vector_expr(words, "vec4", 0, 4);
+                case ParamType::eInt:
+                    return "int(" + words + "[w])";
+                case ParamType::eUInt:
+                    return words + "[w]";
+                case ParamType::eBool:
+                    return words + "[w] != 0u";
+                case ParamType::eMat3:
+                    return "mat3(" + vector_expr(words, "vec3", 0, 3) + ",\n                " +
+                           vector_expr(words, "vec3", 4, 3) + ",\n                " +
+                           vector_expr(words, "vec3", 8, 3) + ")";
+                case ParamType::eMat4:
+                    return "mat4(" + vector_expr(words, "vec4", 0, 4) + ",\n                " +
+                           vector_expr(words, "vec4", 4, 4) + ",\n                " +
+                           vector_expr(words, "vec4", 8, 4) + ",\n                " +
+                           vector_expr(words, "vec4", 12, 4) + ")";
+            }
+            return float_word(words, 0);
+        }
+    } // namespace
+
+    std::string material_pool_prefix(std::string_view shaderId)
+    {
+        std::string out;
+        out.reserve(shaderId.size());
+        for (char c : shaderId)
+            out.push_back(std::isalnum(static_cast<unsigned char>(c)) ? c : '_');
+
+        if (out.empty() || std::isdigit(static_cast<unsigned char>(out.front())))
+            out.insert(out.begin(), '_');
+        return out;
+    }
+
+    std::string generate_material_pool_glsl(const MaterialDescription& mdesc, const MaterialPoolGlslOptions& opt)
+    {
+        std::string guard = "VSS_MATERIAL_POOL_";
+        for (char c : opt.prefix)
+            guard.push_back(static_cast<char>(std::toupper(static_cast<unsigned char>(c))));
+        guard += "_GLSL";
+
+        const std::string baseFn = opt.prefix + "_material_base";
+
+        std::ostringstream o;
+        o << "// Generated by vshaderc";
+        if (!opt.sourceName.empty())
+            o << " from " << opt.sourceName;
+        o << ". Do not edit.\n";
+        o << "//\n";
+        o << "// Decodes the " << mdesc.materialBlockName << " parameters of material <materialIndex> from the\n";
+        o << "// parameter pool. Block size: " << block_size(mdesc) << " bytes (std140).\n";
+        o << "#ifndef " << guard << "\n";
+        o << "#define " << guard << "\n\n";
+
+        o << "uint " << baseFn << "(uint materialIndex)\n";
+        o << "{\n";
+        o << "    return " << opt.tableExpr << "[materialIndex]." << opt.blockOffsetExpr << " >> 2u;\n";
+        o << "}\n";
+
+        for (const auto& p : mdesc.params)
+        {
+            o << "\n";
+            o << glsl_type_name(p.type) << " " << opt.prefix << "_" << p.name << "(uint materialIndex)\n";
+            o << "{\n";
+            o << "    uint w = " << baseFn << "(materialIndex) + " << (p.offset / 4) << "u;\n";
+            o << "    return " << decode_expr(p, opt.poolWordsExpr) << ";\n";
+            o << "}\n";
+        }
+
+        o << "\n#endif // " << guard << "\n";
+        return o.str();
+    }
+
+    MaterialInstance::MaterialInstance(const MaterialDescription& mdesc) :
+        m_Desc(&mdesc), m_Data(block_size(mdesc), 0)
+    {
+        for (const auto& p : mdesc.params)
+        {
+            if (!p.hasDefault)
+                continue;
+
+            // Defaults are stored as packed floats regardless of the parameter type.
+            float values[16] = {};
+            std::memcpy(values, p.defaultValue.valueBuffer, sizeof(values));
+
+            if (is_float_type(p.type))
+                setFloats(p.name, values, component_count(p.type));
+            else if (p.type == ParamType::eInt)
+                setInt(p.name, static_cast<int32_t>(values[0]));
+            else if (p.type == ParamType::eUInt)
+                setUInt(p.name, static_cast<uint32_t>(std::max(values[0], 0.0f)));
+            else
+                setBool(p.name, values[0] != 0.0f);
+        }
+    }
+
+    const MaterialParamDesc* MaterialInstance::find(std::string_view name) const
+    {
+        for (const auto& p : m_Desc->params)
+        {
+            if (p.name == name)
+                return &p;
+        }
+        return nullptr;
+    }
+
+    bool MaterialInstance::setFloats(std::string_view name, const float* values, uint32_t count)
+    {
+        const MaterialParamDesc* p = find(name);
+        if (!p || !is_float_type(p->type) || count != component_count(p->type))
+            return false;
+
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            const uint32_t off = p->offset + component_offset(p->type, i);
+            if (off + sizeof(float) > m_Data.size())
+                return false;
+            std::memcpy(m_Data.data() + off, &values[i], sizeof(float));
+        }
+        return true;
+    }
+
+    bool MaterialInstance::setInt(std::string_view name, int32_t value)
+    {
+        const MaterialParamDesc* p = find(name);
+        if (!p || p->type != ParamType::eInt || p->offset + sizeof(value) > m_Data.size())
+            return false;
+
+        std::memcpy(m_Data.data() + p->offset, &value, sizeof(value));
+        return true;
+    }
+
+    bool MaterialInstance::setUInt(std::string_view name, uint32_t value)
+    {
+        const MaterialParamDesc* p = find(name);
+        if (!p || p->type != ParamType::eUInt || p->offset + sizeof(value) > m_Data.size())
+            return false;
+
+        std::memcpy(m_Data.data() + p->offset, &value, sizeof(value));
+        return true;
+    }
+
+    bool MaterialInstance::setBool(std::string_view name, bool value)
+    {
+        const MaterialParamDesc* p = find(name);
+        if (!p || p->type != ParamType::eBool || p->offset + sizeof(uint32_t) > m_Data.size())
+            return false;
+
+        // GLSL bools occupy a full 32-bit word.
+        const uint32_t word = value ? 1u : 0u;
+        std::memcpy(m_Data.data() + p->offset, &word, sizeof(word));
+        return true;
+    }
+
+    uint32_t MaterialParameterPool::add(const MaterialInstance& instance)
+    {
+        const auto& data = instance.data();
+
+        // Blocks start on 16 bytes so vec4 and matrix columns keep their std140 alignment.
+        m_Words.resize(align_up(static_cast<uint32_t>(m_Words.size()), 4));
+        const uint32_t offsetBytes = static_cast<uint32_t>(m_Words.size() * sizeof(uint32_t));
+
+        m_Words.resize(m_Words.size() + (data.size() + 3) / 4, 0u);
+        std::memcpy(m_Words.data() + offsetBytes / 4, data.data(), data.size());
+        return offsetBytes;
+    }
+
+    bool MaterialParameterPool::update(uint32_t blockOffsetBytes, const MaterialInstance& instance)
+    {
+        const auto& data = instance.data();
+        if ((blockOffsetBytes % 16) != 0 || blockOffsetBytes + data.size() > byteSize())
+            return false;
+
+        std::memcpy(m_Words.data() + blockOffsetBytes / 4, data.data(), data.size());
+        return true;
+    }
+} // namespace vshadersystem
@@ -23,6 +23,13 @@ namespace vshadersystem
         return s.size() >= p.size() && s.substr(0, p.size()) == p;
     }
 
+    // Directive followed by whitespace or the end of the line ("#pragma keyword" but not "#pragma keywords").
+    static inline bool starts_with_directive(std::string_view s, std::string_view directive)
+    {
+        return starts_with(s, directive) &&
+               (s.size() == directive.size() || std::isspace(static_cast<unsigned char>(s[directive.size()])));
+    }
+
     static inline bool parse_bool_token(std::string_view tok, bool& out)
     {
         if (tok == "On")
@@ -342,8 +349,8 @@ namespace vshadersystem
             while (!s.empty() && std::isspace(static_cast<unsigned char>(s.front())))
                 s.remove_prefix(1);
 
-            const bool isVultra  = starts_with(s, "#pragma vultra");
-            const bool isKeyword = starts_with(s, "#pragma keyword");
+            const bool isVultra  = starts_with_directive(s, "#pragma vultra");
+            const bool isKeyword = starts_with_directive(s, "#pragma keyword");
             if (!isVultra && !isKeyword)
                 continue;
 
@@ -629,6 +636,17 @@ namespace vshadersystem
                         {ErrorCode::eParseError, "Unknown texture attribute token: " + std::string(toks[t])});
                 }
             }
+            else if (keyword == "hit_group")
+            {
+                if (toks.size() != 4)
+                    return Result<ParsedMetadata>::err(
+                        {ErrorCode::eParseError, "hit_group pragma requires exactly one group name."});
+
+                std::string name(toks[3]);
+                if (std::find(out.hitGroups.begin(), out.hitGroups.end(), name) == out.hitGroups.end())
+                    out.hitGroups.push_back(std::move(name));
+                continue;
+            }
             else if (keyword == "render")
             {
                 // v1: opaque/transparent only; renderer maps it to queues
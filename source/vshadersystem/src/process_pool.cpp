@@ -0,0 +1,547 @@
+#include "vshadersystem/process_pool.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <utility>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <fcntl.h>
+#include <io.h>
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <cerrno>
+#include <csignal>
+#include <fcntl.h>
+#include <spawn.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+extern char** environ;
+#endif
+
+namespace vshadersystem
+{
+    // ------------------------------------------------------------
+    // Platform layer: spawn, pipe I/O, exit status
+    // ------------------------------------------------------------
+    namespace
+    {
+        struct WorkerProcess
+        {
+#if defined(_WIN32)
+            HANDLE process = nullptr;
+            HANDLE input   = nullptr; // write end of the worker's stdin
+            HANDLE output  = nullptr; // read end of the worker's stdout
+#else
+            pid_t pid    = -1;
+            int   input  = -1;
+            int   output = -1;
+#endif
+            uint32_t jobs = 0;
+
+#if defined(_WIN32)
+            bool running() const { return process != nullptr; }
+#else
+            bool running() const { return pid > 0; }
+#endif
+        };
+
+        // Serializes pipe creation and spawning: a worker started concurrently must not inherit
+        // another worker's pipe ends, or that worker would never see EOF on its stdin.
+        std::mutex g_SpawnMutex;
+
+#if defined(_WIN32)
+        // Quoting per CommandLineToArgvW rules.
+        std::string quote_argument(const std::string& arg)
+        {
+            if (!arg.empty() && arg.find_first_of(" \t\n\v\"") == std::string::npos)
+                return arg;
+
+            std::string out = "\"";
+            size_t      backslashes = 0;
+            for (char c : arg)
+            {
+                if (c == '\\')
+                {
+                    ++backslashes;
+                    continue;
+                }
+                out.append(c == '"' ? backslashes * 2 + 1 : backslashes, '\\');
+                out.push_back(c);
+                backslashes = 0;
+            }
+            out.append(backslashes * 2, '\\');
+            out.push_back('"');
+            return out;
+        }
+
+        bool spawn_worker(const std::vector<std::string>& command, WorkerProcess& w, std::string& error)
+        {
+            std::string cmdLine;
+            for (const auto& arg : command)
+            {
+                if (!cmdLine.empty())
+                    cmdLine.push_back(' ');
+                cmdLine += quote_argument(arg);
+            }
+
+            std::lock_guard<std::mutex> lock(g_SpawnMutex);
+
+            SECURITY_ATTRIBUTES sa {sizeof(SECURITY_ATTRIBUTES), nullptr, TRUE};
+            HANDLE              inRead = nullptr, inWrite = nullptr, outRead = nullptr, outWrite = nullptr;
+            if (!CreatePipe(&inRead, &inWrite, &sa, 0))
+            {
+                error = "CreatePipe failed";
+                return false;
+            }
+            if (!CreatePipe(&outRead, &outWrite, &sa, 0))
+            {
+                CloseHandle(inRead);
+                CloseHandle(inWrite);
+                error = "CreatePipe failed";
+                return false;
+            }
+            SetHandleInformation(inWrite, HANDLE_FLAG_INHERIT, 0);
+            SetHandleInformation(outRead, HANDLE_FLAG_INHERIT, 0);
+
+            STARTUPINFOA si {};
+            si.cb         = sizeof(si);
+            si.dwFlags    = STARTF_USESTDHANDLES;
+            si.hStdInput  = inRead;
+            si.hStdOutput = outWrite;
+            si.hStdError  = GetStdHandle(STD_ERROR_HANDLE);
+
+            PROCESS_INFORMATION pi {};
+            const BOOL          ok =
+                CreateProcessA(nullptr, cmdLine.data(), nullptr, nullptr, TRUE, 0, nullptr, nullptr, &si, &pi);
+
+            CloseHandle(inRead);
+            CloseHandle(outWrite);
+            if (!ok)
+            {
+                CloseHandle(inWrite);
+                CloseHandle(outRead);
+                error = "CreateProcess failed (error " + std::to_string(GetLastError()) + ")";
+                return false;
+            }
+
+            CloseHandle(pi.hThread);
+            w.process = pi.hProcess;
+            w.input   = inWrite;
+            w.output  = outRead;
+            w.jobs    = 0;
+            return true;
+        }
+
+        bool write_exact(WorkerProcess& w, const void* data, size_t size)
+        {
+            const auto* p = static_cast<const uint8_t*>(data);
+            while (size > 0)
+            {
+                DWORD n = 0;
+                if (!WriteFile(w.input, p, static_cast<DWORD>(std::min<size_t>(size, 1u << 30)), &n, nullptr))
+                    return false;
+                p += n;
+                size -= n;
+            }
+            return true;
+        }
+
+        bool read_exact(WorkerProcess& w, void* data, size_t size)
+        {
+            auto* p = static_cast<uint8_t*>(data);
+            while (size > 0)
+            {
+                DWORD n = 0;
+                if (!ReadFile(w.output, p, static_cast<DWORD>(std::min<size_t>(size, 1u << 30)), &n, nullptr) ||
+                    n == 0)
+                    return false;
+                p += n;
+                size -= n;
+            }
+            return true;
+        }
+
+        // Closes the worker's stdin (a healthy worker exits on EOF) and reaps it.
+        std::string stop_worker(WorkerProcess& w)
+        {
+            CloseHandle(w.input);
+            CloseHandle(w.output);
+            WaitForSingleObject(w.process, INFINITE);
+
+            DWORD code = 0;
+            GetExitCodeProcess(w.process, &code);
+            CloseHandle(w.process);
+            w = {};
+
+            char buf[64];
+            std::snprintf(buf, sizeof(buf), "exit code 0x%08lX", static_cast<unsigned long>(code));
+            return buf;
+        }
+#else
+        bool make_pipe(int fds[2])
+        {
+            if (pipe(fds) != 0)
+                return false;
+            fcntl(fds[0], F_SETFD, FD_CLOEXEC);
+            fcntl(fds[1], F_SETFD, FD_CLOEXEC);
+            return true;
+        }
+
+        bool spawn_worker(const std::vector<std::string>& command, WorkerProcess& w, std::string& error)
+        {
+            std::vector<char*> argv;
+            argv.reserve(command.size() + 1);
+            for (const auto& arg : command)
+                argv.push_back(const_cast<char*>(arg.c_str()));
+            argv.push_back(nullptr);
+
+            std::lock_guard<std::mutex> lock(g_SpawnMutex);
+
+            int in[2];
+            int out[2];
+            if (!make_pipe(in))
+            {
+                error = std::strerror(errno);
+                return false;
+            }
+            if (!make_pipe(out))
+            {
+                error = std::strerror(errno);
+                close(in[0]);
+                close(in[1]);
+                return false;
+            }
+
+            // dup2 clears FD_CLOEXEC on the child's stdin/stdout; every other pipe end closes on exec.
+            posix_spawn_file_actions_t actions;
+            posix_spawn_file_actions_init(&actions);
+            posix_spawn_file_actions_adddup2(&actions, in[0], STDIN_FILENO);
+            posix_spawn_file_actions_adddup2(&actions, out[1], STDOUT_FILENO);
+
+            pid_t     pid = -1;
+            const int rc  = posix_spawnp(&pid, argv[0], &actions, nullptr, argv.data(), environ);
+            posix_spawn_file_actions_destroy(&actions);
+
+            close(in[0]);
+            close(out[1]);
+            if (rc != 0)
+            {
+                close(in[1]);
+                close(out[0]);
+                error = std::strerror(rc);
+                return false;
+            }
+
+            w.pid    = pid;
+            w.input  = in[1];
+            w.output = out[0];
+            w.jobs   = 0;
+            return true;
+        }
+
+        bool write_exact(WorkerProcess& w, const void* data, size_t size)
+        {
+            const auto* p = static_cast<const uint8_t*>(data);
+            while (size > 0)
+            {
+                const ssize_t n = write(w.input, p, size);
+                if (n < 0 && errno == EINTR)
+                    continue;
+                if (n <= 0)
+                    return false;
+                p += n;
+                size -= static_cast<size_t>(n);
+            }
+            return true;
+        }
+
+        bool read_exact(WorkerProcess& w, void* data, size_t size)
+        {
+            auto* p = static_cast<uint8_t*>(data);
+            while (size > 0)
+            {
+                const ssize_t n = read(w.output, p, size);
+                if (n < 0 && errno == EINTR)
+                    continue;
+                if (n <= 0)
+                    return false;
+                p += n;
+                size -= static_cast<size_t>(n);
+            }
+            return true;
+        }
+
+        // Closes the worker's stdin (a healthy worker exits on EOF) and reaps it.
+        std::string stop_worker(WorkerProcess& w)
+        {
+            close(w.input);
+            close(w.output);
+
+            int status = 0;
+            while (waitpid(w.pid, &status, 0) < 0 && errno == EINTR)
+            {
+            }
+            w = {};
+
+            if (WIFSIGNALED(status))
+                return "killed by signal " + std::to_string(WTERMSIG(status));
+            return "exit code " + std::to_string(WIFEXITED(status) ? WEXITSTATUS(status) : -1);
+        }
+#endif
+    } // namespace
+
+    // ------------------------------------------------------------
+    // ProcessPool
+    // ------------------------------------------------------------
+    ProcessPool::ProcessPool(ProcessPoolOptions options) : m_Options(std::move(options))
+    {
+#if !defined(_WIN32)
+        std::signal(SIGPIPE, SIG_IGN);
+#endif
+
+        uint32_t count = m_Options.processCount;
+        if (count == 0)
+            count = std::max(1u, std::thread::hardware_concurrency());
+
+        m_Threads.reserve(count);
+        for (uint32_t i = 0; i < count; ++i)
+            m_Threads.emplace_back([this]() { workerLoop(); });
+    }
+
+    ProcessPool::~ProcessPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_Stopping = true;
+        }
+        m_TaskReady.notify_all();
+
+        for (auto& t : m_Threads)
+            t.join();
+    }
+
+    void ProcessPool::submit(std::vector<uint8_t> request, ReplyHandler onReply)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_Tasks.push_back({std::move(request), std::move(onReply)});
+        }
+        m_TaskReady.notify_one();
+    }
+
+    void ProcessPool::wait()
+    {
+        std::unique_lock<std::mutex> lock(m_Mutex);
+        m_Idle.wait(lock, [this]() { return m_Tasks.empty() && m_Running == 0; });
+    }
+
+    void ProcessPool::workerLoop()
+    {
+        WorkerProcess worker;
+
+        auto exchange = [&](const std::vector<uint8_t>& request) -> Result<std::vector<uint8_t>> {
+            if (!worker.running())
+            {
+                std::string error;
+                if (!spawn_worker(m_Options.command, worker, error))
+                    return Result<std::vector<uint8_t>>::err(
+                        {ErrorCode::eIO, "Failed to start worker process: " + error});
+            }
+
+            const uint32_t       size          = static_cast<uint32_t>(request.size());
+            uint32_t             replySize     = 0;
+            uint64_t             residentBytes = 0;
+            std::vector<uint8_t> reply;
+
+            bool ok = write_exact(worker, &size, sizeof(size)) &&
+                      write_exact(worker, request.data(), request.size()) &&
+                      read_exact(worker, &replySize, sizeof(replySize)) &&
+                      read_exact(worker, &residentBytes, sizeof(residentBytes));
+            if (ok)
+            {
+                reply.resize(replySize);
+                ok = read_exact(worker, reply.data(), reply.size());
+            }
+
+            if (!ok)
+            {
+                ++m_Crashed;
+                return Result<std::vector<uint8_t>>::err(
+                    {ErrorCode::eIO, "Worker process died (" + stop_worker(worker) + ")."});
+            }
+
+            ++worker.jobs;
+            if ((m_Options.maxJobsPerProcess != 0 && worker.jobs >= m_Options.maxJobsPerProcess) ||
+                (m_Options.maxResidentBytes != 0 && residentBytes > m_Options.maxResidentBytes))
+            {
+                stop_worker(worker);
+                ++m_Recycled;
+            }
+
+            return Result<std::vector<uint8_t>>::ok(std::move(reply));
+        };
+
+        for (;;)
+        {
+            Task task;
+            {
+                std::unique_lock<std::mutex> lock(m_Mutex);
+                m_TaskReady.wait(lock, [this]() { return m_Stopping || !m_Tasks.empty(); });
+                if (m_Tasks.empty())
+                    break; // stopping and drained
+
+                task = std::move(m_Tasks.front());
+                m_Tasks.pop_front();
+                ++m_Running;
+            }
+
+            task.onReply(exchange(task.request));
+
+            {
+                std::lock_guard<std::mutex> lock(m_Mutex);
+                --m_Running;
+                if (m_Tasks.empty() && m_Running == 0)
+                    m_Idle.notify_all();
+            }
+        }
+
+        if (worker.running())
+            stop_worker(worker);
+    }
+
+    // ------------------------------------------------------------
+    // Worker side
+    // ------------------------------------------------------------
+    static uint64_t resident_bytes()
+    {
+#if defined(_WIN32)
+        PROCESS_MEMORY_COUNTERS pmc {};
+        if (GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc)))
+            return static_cast<uint64_t>(pmc.WorkingSetSize);
+        return 0;
+#elif defined(__linux__)
+        unsigned long long pages = 0;
+        unsigned long long rss   = 0;
+        if (FILE* f = std::fopen("/proc/self/statm", "r"))
+        {
+            if (std::fscanf(f, "%llu %llu", &pages, &rss) != 2)
+                rss = 0;
+            std::fclose(f);
+        }
+        return static_cast<uint64_t>(rss) * static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+#else
+        // Peak rather than current; ru_maxrss is in bytes on Apple platforms, kilobytes elsewhere.
+        rusage usage {};
+        if (getrusage(RUSAGE_SELF, &usage) != 0)
+            return 0;
+#if defined(__APPLE__)
+        return static_cast<uint64_t>(usage.ru_maxrss);
+#else
+        return static_cast<uint64_t>(usage.ru_maxrss) * 1024;
+#endif
+#endif
+    }
+
+#if defined(_WIN32)
+    static int fd_read(int fd, void* data, size_t size)
+    {
+        return _read(fd, data, static_cast<unsigned>(std::min<size_t>(size, 1u << 30)));
+    }
+    static int fd_write(int fd, const void* data, size_t size)
+    {
+        return _write(fd, data, static_cast<unsigned>(std::min<size_t>(size, 1u << 30)));
+    }
+#else
+    static ssize_t fd_read(int fd, void* data, size_t size)
+    {
+        ssize_t n;
+        while ((n = read(fd, data, size)) < 0 && errno == EINTR)
+        {
+        }
+        return n;
+    }
+    static ssize_t fd_write(int fd, const void* data, size_t size)
+    {
+        ssize_t n;
+        while ((n = write(fd, data, size)) < 0 && errno == EINTR)
+        {
+        }
+        return n;
+    }
+#endif
+
+    static bool fd_read_exact(int fd, void* data, size_t size)
+    {
+        auto* p = static_cast<uint8_t*>(data);
+        while (size > 0)
+        {
+            const auto n = fd_read(fd, p, size);
+            if (n <= 0)
+                return false;
+            p += n;
+            size -= static_cast<size_t>(n);
+        }
+        return true;
+    }
+
+    static bool fd_write_exact(int fd, const void* data, size_t size)
+    {
+        const auto* p = static_cast<const uint8_t*>(data);
+        while (size > 0)
+        {
+            const auto n = fd_write(fd, p, size);
+            if (n <= 0)
+                return false;
+            p += n;
+            size -= static_cast<size_t>(n);
+        }
+        return true;
+    }
+
+    int run_process_pool_worker(const ProcessPoolHandler& handler)
+    {
+        std::fflush(stdout);
+
+#if defined(_WIN32)
+        _setmode(0, _O_BINARY);
+        const int channel = _dup(1);
+        if (channel < 0)
+            return 1;
+        _setmode(channel, _O_BINARY);
+        _dup2(2, 1);
+#else
+        const int channel = dup(1);
+        if (channel < 0)
+            return 1;
+        dup2(2, 1);
+#endif
+
+        std::vector<uint8_t> request;
+        for (;;)
+        {
+            uint32_t size = 0;
+            if (!fd_read_exact(0, &size, sizeof(size)))
+                return 0; // parent closed stdin
+
+            request.resize(size);
+            if (!fd_read_exact(0, request.data(), request.size()))
+                return 1;
+
+            const std::vector<uint8_t> reply         = handler(request);
+            const uint32_t             replySize     = static_cast<uint32_t>(reply.size());
+            const uint64_t             residentBytes = resident_bytes();
+
+            if (!fd_write_exact(channel, &replySize, sizeof(replySize)) ||
+                !fd_write_exact(channel, &residentBytes, sizeof(residentBytes)) ||
+                !fd_write_exact(channel, reply.data(), reply.size()))
+                return 1;
+        }
+    }
+} // namespace vshadersystem
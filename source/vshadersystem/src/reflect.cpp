@@ -109,6 +109,15 @@ namespace vshadersystem
                 out.localSizeX   = comp.get_execution_mode_argument(spv::ExecutionModeLocalSize, 0);
                 out.localSizeY   = comp.get_execution_mode_argument(spv::ExecutionModeLocalSize, 1);
                 out.localSizeZ   = comp.get_execution_mode_argument(spv::ExecutionModeLocalSize, 2);
+
+                spirv_cross::SpecializationConstant sx {}, sy {}, sz {};
+                comp.get_work_group_size_specialization_constants(sx, sy, sz);
+                if (sx.id != 0)
+                    out.localSizeSpecIdX = sx.constant_id;
+                if (sy.id != 0)
+                    out.localSizeSpecIdY = sy.constant_id;
+                if (sz.id != 0)
+                    out.localSizeSpecIdZ = sz.constant_id;
             }
 
             auto resources = comp.get_shader_resources();
@@ -165,13 +174,14 @@ namespace vshadersystem
             // ----------------------------------------------------
             // blocks
             // ----------------------------------------------------
-            auto add_block = [&](const spirv_cross::Resource& r, bool isPush) {
+            auto add_block = [&](const spirv_cross::Resource& r, bool isPush, bool isRecord = false) {
                 BlockLayout blk;
                 blk.name           = r.name.empty() ? comp.get_name(r.id) : r.name;
                 blk.isPushConstant = isPush;
+                blk.isShaderRecord = isRecord;
                 blk.stageFlags |= stageBit;
 
-                if (!isPush)
+                if (!isPush && !isRecord)
                 {
                     blk.set     = comp.get_decoration(r.id, spv::DecorationDescriptorSet);
                     blk.binding = comp.get_decoration(r.id, spv::DecorationBinding);
@@ -208,6 +218,10 @@ namespace vshadersystem
                     add_block(r, true);
             }
 
+            // Shader record data lives in the shader binding table, right after the group handle.
+            for (auto& r : resources.shader_record_buffers)
+                add_block(r, false, true);
+
             return Result<ShaderReflection>::ok(out);
         }
         catch (std::exception& e)
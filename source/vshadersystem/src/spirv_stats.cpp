@@ -0,0 +1,103 @@
+#include "vshadersystem/spirv_stats.hpp"
+
+#include <spirv_cross/spirv.hpp>
+
+namespace vshadersystem
+{
+    static constexpr size_t kHeaderWords = 5;
+
+    static bool is_image_op(uint32_t op) { return op >= spv::OpImageSampleImplicitLod && op <= spv::OpImageWrite; }
+
+    static bool is_arithmetic_op(uint32_t op) { return op >= spv::OpSNegate && op <= spv::OpDot; }
+
+    Result<SpirvStats> analyze_spirv(const std::vector<uint32_t>& spirv)
+    {
+        if (spirv.size() < kHeaderWords || spirv[0] != spv::MagicNumber)
+            return Result<SpirvStats>::err({ErrorCode::eInvalidArgument, "Invalid SPIR-V module header."});
+
+        SpirvStats s;
+        s.wordCount = static_cast<uint32_t>(spirv.size());
+
+        bool   inFunction = false;
+        size_t i          = kHeaderWords;
+        while (i < spirv.size())
+        {
+            const uint32_t wordCount = spirv[i] >> 16;
+            const uint32_t op        = spirv[i] & 0xFFFFu;
+
+            if (wordCount == 0 || i + wordCount > spirv.size())
+                return Result<SpirvStats>::err({ErrorCode::eInvalidArgument, "Malformed SPIR-V instruction stream."});
+
+            ++s.instructionCount;
+
+            switch (op)
+            {
+                case spv::OpFunction:
+                    inFunction = true;
+                    ++s.functionCount;
+                    break;
+                case spv::OpFunctionEnd:
+                    inFunction = false;
+                    break;
+                case spv::OpSpecConstantTrue:
+                case spv::OpSpecConstantFalse:
+                case spv::OpSpecConstant:
+                case spv::OpSpecConstantComposite:
+                case spv::OpSpecConstantOp:
+                    ++s.specConstantCount;
+                    break;
+                case spv::OpVariable:
+                    // OpVariable <resultType> <resultId> <storageClass> [initializer]
+                    if (!inFunction && wordCount >= 4)
+                    {
+                        if (spirv[i + 3] == spv::StorageClassInput)
+                            ++s.inputVariableCount;
+                        else if (spirv[i + 3] == spv::StorageClassOutput)
+                            ++s.outputVariableCount;
+                    }
+                    break;
+                default:
+                    break;
+            }
+
+            if (inFunction)
+            {
+                ++s.functionInstructionCount;
+
+                if (is_arithmetic_op(op))
+                {
+                    ++s.arithmeticCount;
+                    s.staticCost += 1;
+                }
+                else if (is_image_op(op))
+                {
+                    ++s.imageCount;
+                    s.staticCost += 8;
+                }
+                else if (op == spv::OpLoad || op == spv::OpStore || op == spv::OpAccessChain)
+                {
+                    ++s.memoryCount;
+                    s.staticCost += 1;
+                }
+                else if (op == spv::OpExtInst)
+                {
+                    ++s.extInstCount;
+                    s.staticCost += 4;
+                }
+                else if (op == spv::OpBranchConditional || op == spv::OpSwitch)
+                {
+                    ++s.branchCount;
+                    s.staticCost += 2;
+                }
+                else if (op == spv::OpFunctionCall)
+                {
+                    s.staticCost += 2;
+                }
+            }
+
+            i += wordCount;
+        }
+
+        return Result<SpirvStats>::ok(s);
+    }
+} // namespace vshadersystem
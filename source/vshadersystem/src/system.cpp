@@ -1,21 +1,75 @@
 #include "vshadersystem/system.hpp"
 #include "vshadersystem/binary.hpp"
+#include "vshadersystem/binding_table.hpp"
 #include "vshadersystem/compiler.hpp"
+#include "vshadersystem/deps.hpp"
 #include "vshadersystem/hash.hpp"
+#include "vshadersystem/link_modules.hpp"
 #include "vshadersystem/metadata.hpp"
 #include "vshadersystem/parser_utils.hpp"
 #include "vshadersystem/reflect.hpp"
 #include "vshadersystem/shader_id.hpp"
 #include "vshadersystem/variant_key.hpp"
+#include "vshadersystem/workgroup.hpp"
 
 #include <algorithm>
+#include <cctype>
+#include <chrono>
 #include <cstring>
 #include <filesystem>
-#include <iostream>
+#include <fstream>
+#include <optional>
 #include <unordered_map>
 
 namespace vshadersystem
 {
+    static inline bool read_file_text(const std::filesystem::path& path, std::string& out)
+    {
+        std::ifstream f(path, std::ios::binary);
+        if (!f)
+            return false;
+
+        f.seekg(0, std::ios::end);
+        const std::streamoff size = f.tellg();
+        if (size < 0)
+            return false;
+        f.seekg(0, std::ios::beg);
+
+        out.resize(static_cast<size_t>(size));
+        f.read(out.data(), size);
+        return static_cast<bool>(f);
+    }
+
+    static inline bool dependencies_up_to_date(const std::vector<ShaderDependency>& deps,
+                                               const std::filesystem::path&         root,
+                                               FileHashCache*                       hashCache)
+    {
+        std::string text;
+        for (const auto& d : deps)
+        {
+            std::filesystem::path p(d.path);
+            if (p.is_relative())
+                p = root / p;
+
+            uint64_t h = 0;
+            if (hashCache)
+            {
+                if (!hashCache->hash(p, h))
+                    return false;
+            }
+            else
+            {
+                if (!read_file_text(p, text))
+                    return false;
+                h = xxhash64(text);
+            }
+
+            if (h != d.contentHash)
+                return false;
+        }
+        return true;
+    }
+
     static inline std::string normalize_define_list(const std::vector<Define>& defs)
     {
         // Deterministic ordering for stable cache keys.
@@ -38,86 +92,66 @@ namespace vshadersystem
         return out;
     }
 
+    // True if s starts with the directive followed by whitespace or the end of the line, so
+    // "#pragma keyword" does not match "#pragma keywords".
+    static bool starts_with_directive(std::string_view s, std::string_view directive)
+    {
+        return s.starts_with(directive) &&
+               (s.size() == directive.size() || std::isspace(static_cast<unsigned char>(s[directive.size()])));
+    }
+
+    static std::string strip_metadata_pragmas(const std::string& sourceText)
+    {
+        // Blank out #pragma vultra / #pragma keyword lines (newlines are kept so line numbers stay stable).
+        // glslang ignores these pragmas, so they never reach the SPIR-V unless the source is embedded as debug info.
+        std::string out;
+        out.reserve(sourceText.size());
+
+        size_t i = 0;
+        while (i < sourceText.size())
+        {
+            size_t j = sourceText.find('\n', i);
+            if (j == std::string::npos)
+                j = sourceText.size();
+
+            std::string_view line(sourceText.data() + i, j - i);
+            std::string_view s = line;
+            while (!s.empty() && std::isspace(static_cast<unsigned char>(s.front())))
+                s.remove_prefix(1);
+
+            if (!starts_with_directive(s, "#pragma vultra") && !starts_with_directive(s, "#pragma keyword"))
+                out.append(line);
+            if (j < sourceText.size())
+                out.push_back('\n');
+
+            i = j + 1;
+        }
+        return out;
+    }
+
     static inline uint64_t
-    compute_build_hash(const SourceInput& src, const CompileOptions& opt, const ParsedMetadata& meta)
+    compute_build_hash(const SourceInput& src, const CompileOptions& opt, const std::filesystem::path& root)
     {
-        // v1: hash (source text + stage + include dirs + defines + normalized metadata tokens).
-        // We can extend this with expanded include contents once a custom includer records dependencies.
-        uint64_t h = 0;
-        h          = xxhash64(src.sourceText, h);
-        h          = xxhash64(src.virtualPath, h);
+        // v3: hash only what affects codegen (SPIR-V + reflection).
+        // Metadata pragmas are stripped from the source and the MaterialDescription is rebuilt from cached
+        // reflection on every lookup, so pragma-only edits never recompile.
+        // Include contents are not part of the key: cache entries carry a DEPS list that is
+        // validated against the current files on lookup.
+        uint64_t h = xxhash64("vshadersystem-cache-v5");
+        h          = xxhash64(opt.debugInfo ? src.text() : strip_metadata_pragmas(src.text()), h);
+        h          = xxhash64(make_portable_path(src.virtualPath, root), h);
 
         h = xxhash64(&opt.stage, sizeof(opt.stage), h);
 
+        const uint32_t flags = (opt.optimize ? 1u : 0u) | (opt.debugInfo ? 2u : 0u) | (opt.stripDebugInfo ? 4u : 0u);
+        h                    = xxhash64(&flags, sizeof(flags), h);
+        h                    = xxhash64(&opt.spirvVersion, sizeof(opt.spirvVersion), h);
+
         auto defs = normalize_define_list(opt.defines);
         h         = xxhash64(defs, h);
 
-        for (const auto& dir : opt.includeDirs)
-            h = xxhash64(dir, h);
-
-        // Metadata normalization: we only hash what affects the binary artifact.
-        // Semantics/default/range/state are embedded in .vshbin, so they must be part of cache key.
-        {
-            std::string m;
-            m.reserve(256);
-            m += meta.hasMaterialDecl ? "material=1\n" : "material=0\n";
-            m += "depthTest=" + std::to_string(meta.renderState.depthTest) + "\n";
-            m += "depthWrite=" + std::to_string(meta.renderState.depthWrite) + "\n";
-            m += "depthFunc=" + std::to_string(static_cast<int>(meta.renderState.depthFunc)) + "\n";
-            m += "cull=" + std::to_string(static_cast<int>(meta.renderState.cull)) + "\n";
-            m += "blendEnable=" + std::to_string(meta.renderState.blendEnable) + "\n";
-            m += "srcColor=" + std::to_string(static_cast<int>(meta.renderState.srcColor)) + "\n";
-            m += "dstColor=" + std::to_string(static_cast<int>(meta.renderState.dstColor)) + "\n";
-            m += "colorOp=" + std::to_string(static_cast<int>(meta.renderState.colorOp)) + "\n";
-            m += "srcAlpha=" + std::to_string(static_cast<int>(meta.renderState.srcAlpha)) + "\n";
-            m += "dstAlpha=" + std::to_string(static_cast<int>(meta.renderState.dstAlpha)) + "\n";
-            m += "alphaOp=" + std::to_string(static_cast<int>(meta.renderState.alphaOp)) + "\n";
-            m += "colorMask=" + std::to_string(static_cast<int>(meta.renderState.colorMask)) + "\n";
-            m += "alphaToCoverage=" + std::to_string(meta.renderState.alphaToCoverage) + "\n";
-            m += "depthBiasFactor=" + std::to_string(meta.renderState.depthBiasFactor) + "\n";
-            m += "depthBiasUnits=" + std::to_string(meta.renderState.depthBiasUnits) + "\n";
-
-            // params
-            std::vector<std::string> keys;
-            keys.reserve(meta.params.size());
-            for (const auto& [k, _] : meta.params)
-                keys.push_back(k);
-            std::sort(keys.begin(), keys.end());
-            for (auto& k : keys)
-            {
-                const auto& pm = meta.params.at(k);
-                m += "p:" + k + ":sem=" + std::to_string(static_cast<uint32_t>(pm.semantic)) + "\n";
-                if (pm.hasDefault)
-                {
-                    m += "p:" + k + ":def=";
-                    for (uint8_t i : pm.defaultValue.valueBuffer)
-                    {
-                        m += std::to_string(i);
-                        m.push_back(',');
-                    }
-                    m.push_back('\n');
-                }
-                if (pm.hasRange)
-                {
-                    m +=
-                        "p:" + k + ":range=" + std::to_string(pm.range.min) + "," + std::to_string(pm.range.max) + "\n";
-                }
-            }
-
-            // textures
-            keys.clear();
-            keys.reserve(meta.textures.size());
-            for (const auto& [k, _] : meta.textures)
-                keys.push_back(k);
-            std::sort(keys.begin(), keys.end());
-            for (auto& k : keys)
-            {
-                const auto& tm = meta.textures.at(k);
-                m += "t:" + k + ":sem=" + std::to_string(static_cast<uint32_t>(tm.semantic)) + "\n";
-            }
-
-            h = xxhash64(m, h);
-        }
+        for (const auto& dir : opt.includeDirList())
+            h = xxhash64(make_portable_path(dir, root), h);
 
         return h;
     }
@@ -143,7 +177,7 @@ namespace vshadersystem
         const BlockLayout* matBlock = nullptr;
         for (const auto& b : refl.blocks)
         {
-            if (!b.isPushConstant && b.name == blockName)
+            if (!b.isPushConstant && !b.isShaderRecord && b.name == blockName)
             {
                 matBlock = &b;
                 break;
@@ -269,122 +303,287 @@ namespace vshadersystem
         return Result<void>::ok();
     }
 
-    Result<BuildResult> build_shader(const BuildRequest& req)
+    // Resolved permutation keyword values, in declaration order. These are the inputs of variantHash.
+    static Result<std::vector<KeywordValue>> resolve_permutation_keywords(const BuildRequest&   req,
+                                                                          const ParsedMetadata& meta)
     {
-        // Parse metadata first, so it can contribute to cache key even if compilation fails later.
-        auto metaR = parse_vultra_metadata(req.source.sourceText);
-        if (!metaR.isOk())
-            return Result<BuildResult>::err(metaR.error());
-        const ParsedMetadata meta = std::move(metaR.value());
+        std::vector<KeywordValue> out;
 
-        const uint64_t buildHash    = compute_build_hash(req.source, req.options, meta);
-        const uint64_t sourceHash   = xxhash64(req.source.sourceText);
-        const uint64_t shaderIdHash = shader_id_hash_from_virtual_path(req.source.virtualPath);
-
-        BuildResult out;
-        out.fromCache = false;
+        // collect permutation keywords
+        const EngineKeywordsFile* kw = req.engineKeywordsOrNull();
 
-        if (req.enableCache)
+        for (const auto& kd : meta.keywords)
         {
-            const std::string path   = cache_path(req.cacheDir, buildHash);
-            auto              cached = read_vshbin_file(path);
-            if (cached.isOk())
-            {
-                out.binary    = std::move(cached.value());
-                out.log       = "Cache hit: " + path;
-                out.fromCache = true;
-                return Result<BuildResult>::ok(std::move(out));
-            }
-        }
+            if (kd.dispatch != KeywordDispatch::ePermutation)
+                continue;
 
-        // Compile
-        auto c = compile_glsl_to_spirv(req.source, req.options);
-        if (!c.isOk())
-            return Result<BuildResult>::err(c.error());
+            uint32_t value    = kd.defaultValue;
+            bool     fromDefs = false;
 
-        // Reflect
-        auto r = reflect_spirv(c.value().spirv);
-        if (!r.isOk())
-            return Result<BuildResult>::err(r.error());
+            // override from -D
+            for (const auto& d : req.options.defines)
+            {
+                if (d.name == kd.name)
+                {
+                    auto pv = parse_keyword_value(kd, d.value);
 
-        ShaderBinary bin;
-        bin.stage        = req.options.stage;
-        bin.spirv        = std::move(c.value().spirv);
-        bin.spirvHash    = xxhash64_words(bin.spirv);
-        bin.contentHash  = sourceHash;
-        bin.shaderIdHash = shaderIdHash;
-        bin.reflection   = std::move(r.value());
+                    if (!pv.isOk())
+                        return Result<std::vector<KeywordValue>>::err(pv.error());
 
-        // Compute variant hash (permutation keywords only)
-        {
-            VariantKey key;
+                    value    = pv.value();
+                    fromDefs = true;
+                    break;
+                }
+            }
 
-            key.setShaderIdHash(shaderIdHash);
-            key.setStage(req.options.stage);
+            // engine keywords fill global keywords the defines leave unset (matching the compile-time injection)
+            if (kw && !fromDefs && kd.scope == KeywordScope::eGlobal)
+            {
+                auto it = kw->values.find(kd.name);
 
-            // collect permutation keywords
-            const EngineKeywordsFile* kw = req.hasEngineKeywords ? &req.engineKeywords : nullptr;
+                if (it != kw->values.end())
+                {
+                    auto pv = parse_keyword_value(kd, it->second);
 
-            for (const auto& kd : meta.keywords)
-            {
-                if (kd.dispatch != KeywordDispatch::ePermutation)
-                    continue;
+                    if (!pv.isOk())
+                        return Result<std::vector<KeywordValue>>::err(pv.error());
 
-                uint32_t value = kd.defaultValue;
+                    value = pv.value();
+                }
+            }
 
-                // override from -D
-                for (const auto& d : req.options.defines)
-                {
-                    if (d.name == kd.name)
-                    {
-                        auto pv = parse_keyword_value(kd, d.value);
+            KeywordValue v;
+            v.name  = kd.name;
+            v.kind  = kd.kind;
+            v.value = value;
+            if (kd.kind == KeywordValueKind::eEnum)
+                v.enumValues = kd.enumValues;
+            out.push_back(std::move(v));
+        }
 
-                        if (!pv.isOk())
-                            return Result<BuildResult>::err(pv.error());
+        return Result<std::vector<KeywordValue>>::ok(std::move(out));
+    }
 
-                        value = pv.value();
-                        std::cout << "Override keyword '" << kd.name << "' from command line define: " << value << "\n";
+    static uint64_t compute_variant_hash(const BuildRequest&              req,
+                                         const std::vector<KeywordValue>& values,
+                                         uint64_t                         shaderIdHash)
+    {
+        // Compute variant hash (permutation keywords only)
+        VariantKey key;
 
-                        break;
-                    }
-                }
+        key.setShaderIdHash(shaderIdHash);
+        key.setStage(req.options.stage);
 
-                // override from engine keywords
-                if (kw)
-                {
-                    auto it = kw->values.find(kd.name);
+        for (const auto& v : values)
+            key.set(v.name, v.value);
 
-                    if (it != kw->values.end())
-                    {
-                        auto pv = parse_keyword_value(kd, it->second);
+        return key.build();
+    }
 
-                        if (!pv.isOk())
-                            return Result<BuildResult>::err(pv.error());
+    // Fills everything that depends on metadata or project tables rather than codegen: binding remap,
+    // content/shader/variant hashes and the MaterialDescription. Runs on both cache hits and fresh compiles,
+    // so pragma-only or binding-table edits never recompile.
+    static Result<void> finalize_binary(ShaderBinary& bin, const BuildRequest& req, const ParsedMetadata& meta)
+    {
+        if (const BindingTable* table = req.bindingTableOrNull())
+        {
+            auto ar = apply_binding_table(bin.spirv, *table);
+            if (!ar.isOk())
+                return Result<void>::err(ar.error());
 
-                        value = pv.value();
-                        std::cout << "Override keyword '" << kd.name << "' from engine keywords: " << value << "\n";
-                    }
-                }
+            if (ar.value() > 0)
+            {
+                auto r = reflect_spirv(bin.spirv);
+                if (!r.isOk())
+                    return Result<void>::err(r.error());
 
-                key.set(kd.name, value);
+                bin.reflection = std::move(r.value());
+                bin.spirvHash  = xxhash64_words(bin.spirv);
             }
-
-            bin.variantHash = key.build();
         }
 
+        bin.stage        = req.options.stage;
+        bin.contentHash  = xxhash64(req.source.text());
+        bin.shaderIdHash = shader_id_hash_from_virtual_path(req.source.virtualPath);
+
+        auto kv = resolve_permutation_keywords(req, meta);
+        if (!kv.isOk())
+            return Result<void>::err(kv.error());
+        bin.keywordValues = std::move(kv.value());
+        bin.variantHash   = compute_variant_hash(req, bin.keywordValues, bin.shaderIdHash);
+
+        if (!meta.hitGroups.empty() && req.options.stage != ShaderStage::eRchit &&
+            req.options.stage != ShaderStage::eRahit && req.options.stage != ShaderStage::eRint)
+            return Result<void>::err(
+                {ErrorCode::eParseError, "hit_group pragma is only valid in rchit, rahit and rint shaders."});
+        bin.hitGroups = meta.hitGroups;
+
         // Build MaterialDescription
         MaterialDescription mdesc;
         mdesc.materialBlockName = "Material";
 
         auto vr = validate_and_build_mdesc(mdesc, bin.reflection, meta);
         if (!vr.isOk())
-            return Result<BuildResult>::err(vr.error());
+            return vr;
 
         bin.materialDesc = std::move(mdesc);
+        return Result<void>::ok();
+    }
+
+    static Result<void> emit_workgroup_variants(BuildResult& out, const BuildRequest& req)
+    {
+        if (req.workgroupSizes.empty())
+            return Result<void>::ok();
+
+        auto& base = out.binary;
+        for (const auto& ws : req.workgroupSizes)
+        {
+            auto sr = specialize_workgroup_size(base.spirv, base.reflection, ws);
+            if (!sr.isOk())
+                return Result<void>::err(sr.error());
+
+            ShaderBinary v;
+            v.contentHash  = base.contentHash;
+            v.shaderIdHash = base.shaderIdHash;
+            v.variantHash  = workgroup_variant_hash(base.variantHash, ws);
+            v.stage        = base.stage;
+            v.reflection   = base.reflection;
+            v.materialDesc = base.materialDesc;
+            v.spirv        = std::move(sr.value());
+            v.spirvHash    = xxhash64_words(v.spirv);
+
+            v.keywordValues = base.keywordValues;
+
+            v.reflection.localSizeX = ws.x;
+            v.reflection.localSizeY = ws.y;
+            v.reflection.localSizeZ = ws.z;
+
+            out.sizeVariants.push_back(std::move(v));
+        }
+
+        base.workgroupSizes = req.workgroupSizes;
+        return Result<void>::ok();
+    }
+
+    // Compiles (or fetches) the request's link modules and switches the variant compile to a
+    // compile-only module that imports their functions.
+    static Result<void> prepare_link_modules(const BuildRequest&                             req,
+                                             LinkModuleCache&                                cache,
+                                             CompileOptions&                                 options,
+                                             std::vector<std::shared_ptr<const LinkModule>>& modules)
+    {
+        if (!spirv_linking_available())
+            return Result<void>::err({ErrorCode::eInvalidArgument,
+                                      "Link modules require vshadersystem built with vshadersystem_spirv_tools."});
+
+        modules.reserve(req.linkModules.size());
+        for (const auto& path : req.linkModules)
+        {
+            auto m = cache.get(path, req.options.stage, req.options.includeDirList());
+            if (!m.isOk())
+                return Result<void>::err(m.error());
+            modules.push_back(std::move(m.value()));
+        }
+
+        options             = req.options;
+        options.compileOnly = true;
+        options.defines.push_back({kLinkModulesDefine, "1"});
+        return Result<void>::ok();
+    }
+
+    Result<BuildResult> build_shader(const BuildRequest& req)
+    {
+        // Parse metadata first, so pragma errors are reported even on cache hits.
+        auto metaR = parse_vultra_metadata(req.source.text());
+        if (!metaR.isOk())
+            return Result<BuildResult>::err(metaR.error());
+        const ParsedMetadata meta = std::move(metaR.value());
+
+        const CompileOptions*                          options = &req.options;
+        CompileOptions                                 linkedOptions;
+        LinkModuleCache                                localModuleCache;
+        std::vector<std::shared_ptr<const LinkModule>> modules;
+        if (!req.linkModules.empty())
+        {
+            LinkModuleCache& cache = req.linkModuleCache ? *req.linkModuleCache : localModuleCache;
+
+            auto lr = prepare_link_modules(req, cache, linkedOptions, modules);
+            if (!lr.isOk())
+                return Result<BuildResult>::err(lr.error());
+            options = &linkedOptions;
+        }
+
+        const auto projectRoot = resolve_project_root(req.projectRoot);
+        uint64_t   buildHash   = compute_build_hash(req.source, *options, projectRoot);
+        for (const auto& m : modules)
+            buildHash = xxhash64(&m->hash, sizeof(m->hash), buildHash);
+
+        BuildResult out;
+        out.fromCache = false;
 
-        out.binary = bin;
-        out.log    = c.value().infoLog;
+        if (req.enableCache)
+        {
+            const std::string path   = cache_path(req.cacheDir, buildHash);
+            auto              cached = read_vshbin_file(path);
+            if (cached.isOk() &&
+                dependencies_up_to_date(cached.value().dependencies, projectRoot, req.fileHashCache))
+            {
+                out.binary = std::move(cached.value());
+
+                auto fr = finalize_binary(out.binary, req, meta);
+                if (!fr.isOk())
+                    return Result<BuildResult>::err(fr.error());
+
+                auto wr = emit_workgroup_variants(out, req);
+                if (!wr.isOk())
+                    return Result<BuildResult>::err(wr.error());
+
+                out.log       = "Cache hit: " + path;
+                out.fromCache = true;
+                return Result<BuildResult>::ok(std::move(out));
+            }
+        }
+
+        // Compile
+        const auto compileStart = std::chrono::steady_clock::now();
+
+        auto c = compile_glsl_to_spirv(req.source, *options);
+        if (!c.isOk())
+            return Result<BuildResult>::err(c.error());
+
+        // Link
+        double linkMs = 0.0;
+        if (!modules.empty())
+        {
+            const auto linkStart = std::chrono::steady_clock::now();
+
+            auto l = link_spirv_modules(c.value().spirv, modules, options->spirvVersion);
+            if (!l.isOk())
+                return Result<BuildResult>::err(l.error());
+            c.value().spirv = std::move(l.value());
+
+            linkMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - linkStart).count();
+        }
 
+        // Reflect
+        auto r = reflect_spirv(c.value().spirv);
+        if (!r.isOk())
+            return Result<BuildResult>::err(r.error());
+
+        const auto compileEnd = std::chrono::steady_clock::now();
+
+        ShaderBinary bin;
+        bin.stage      = req.options.stage;
+        bin.spirv      = std::move(c.value().spirv);
+        bin.spirvHash  = xxhash64_words(bin.spirv);
+        bin.reflection = std::move(r.value());
+
+        const auto& deps = c.value().dependencies;
+        bin.dependencies.reserve(deps.size());
+        for (size_t i = 0; i < deps.size(); ++i)
+            bin.dependencies.push_back({make_portable_path(deps[i], projectRoot), c.value().dependencyHashes[i]});
+
+        // Cache codegen output before metadata validation: fixing a bad pragma must not recompile.
         if (req.enableCache)
         {
             std::filesystem::create_directories(req.cacheDir);
@@ -392,10 +591,46 @@ namespace vshadersystem
             (void)write_vshbin_file(path, bin);
         }
 
+        auto fr = finalize_binary(bin, req, meta);
+        if (!fr.isOk())
+            return Result<BuildResult>::err(fr.error());
+
+        out.binary    = std::move(bin);
+        out.log       = c.value().infoLog;
+        out.compileMs = std::chrono::duration<double, std::milli>(compileEnd - compileStart).count();
+        out.linkMs    = linkMs;
+
+        auto wr = emit_workgroup_variants(out, req);
+        if (!wr.isOk())
+            return Result<BuildResult>::err(wr.error());
+
         return Result<BuildResult>::ok(std::move(out));
     }
 
+    std::vector<Result<BuildResult>>
+    build_shaders(std::span<const BuildRequest> requests, Executor& executor, TaskPriority priority)
+    {
+        std::vector<std::optional<Result<BuildResult>>> slots(requests.size());
+        {
+            TaskGroup group(executor, priority);
+            for (size_t i = 0; i < requests.size(); ++i)
+                group.run([&, i]() { slots[i].emplace(build_shader(requests[i])); });
+            group.wait();
+        }
+
+        std::vector<Result<BuildResult>> out;
+        out.reserve(slots.size());
+        for (auto& r : slots)
+            out.push_back(std::move(*r));
+        return out;
+    }
+
     Result<ShaderBinary> build_from_spirv(const std::vector<uint32_t>& spirv, ShaderStage stage)
+    {
+        return build_from_spirv(std::vector<uint32_t>(spirv), stage);
+    }
+
+    Result<ShaderBinary> build_from_spirv(std::vector<uint32_t>&& spirv, ShaderStage stage)
     {
         auto r = reflect_spirv(spirv);
         if (!r.isOk())
@@ -403,9 +638,10 @@ namespace vshadersystem
 
         ShaderBinary bin;
         bin.stage       = stage;
-        bin.spirv       = spirv;
+        bin.spirv       = std::move(spirv);
         bin.spirvHash   = xxhash64_words(bin.spirv);
-        bin.contentHash = xxhash64_words(bin.spirv);
+        bin.contentHash = bin.spirvHash;
+        bin.reflection  = std::move(r.value());
 
         MaterialDescription mdesc;
         mdesc.materialBlockName = "Material";
@@ -421,7 +657,6 @@ namespace vshadersystem
             return Result<ShaderBinary>::err(vr.error());
         }
 
-        bin.reflection   = std::move(r.value());
         bin.materialDesc = std::move(mdesc);
 
         return Result<ShaderBinary>::ok(std::move(bin));
@@ -0,0 +1,113 @@
+#include "vshadersystem/thread_pool.hpp"
+
+#include <algorithm>
+#include <utility>
+
+namespace vshadersystem
+{
+    // Set on worker threads so submissions from inside a task stay on that worker's queue.
+    static thread_local const ThreadPool* t_Pool        = nullptr;
+    static thread_local size_t            t_WorkerIndex = 0;
+
+    ThreadPool::ThreadPool(uint32_t threadCount)
+    {
+        if (threadCount == 0)
+            threadCount = std::max(1u, std::thread::hardware_concurrency());
+
+        m_Queues.reserve(threadCount);
+        for (uint32_t i = 0; i < threadCount; ++i)
+            m_Queues.push_back(std::make_unique<WorkerQueue>());
+
+        m_Threads.reserve(threadCount);
+        for (uint32_t i = 0; i < threadCount; ++i)
+            m_Threads.emplace_back([this, i]() { workerLoop(i); });
+    }
+
+    ThreadPool::~ThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_Stopping = true;
+        }
+        m_TaskReady.notify_all();
+
+        for (auto& t : m_Threads)
+            t.join();
+    }
+
+    void ThreadPool::submit(std::function<void()> task, TaskPriority priority)
+    {
+        const size_t q = t_Pool == this ? t_WorkerIndex : m_NextQueue.fetch_add(1) % m_Queues.size();
+        {
+            std::lock_guard<std::mutex> lock(m_Queues[q]->mutex);
+            m_Queues[q]->tasks[static_cast<size_t>(priority)].push_back(std::move(task));
+        }
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            ++m_Queued;
+        }
+        m_TaskReady.notify_one();
+    }
+
+    void ThreadPool::wait()
+    {
+        std::unique_lock<std::mutex> lock(m_Mutex);
+        m_Idle.wait(lock, [this]() { return m_Queued == 0 && m_Running == 0; });
+    }
+
+    bool ThreadPool::take(size_t self, std::function<void()>& out)
+    {
+        const size_t n = m_Queues.size();
+        for (size_t p = 0; p < kTaskPriorityCount; ++p)
+        {
+            // Own queue first, then steal, so a worker only leaves its queue for higher-priority work.
+            for (size_t i = 0; i < n; ++i)
+            {
+                auto&                       q = *m_Queues[(self + i) % n];
+                std::lock_guard<std::mutex> lock(q.mutex);
+                if (!q.tasks[p].empty())
+                {
+                    out = std::move(q.tasks[p].front());
+                    q.tasks[p].pop_front();
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    void ThreadPool::workerLoop(size_t index)
+    {
+        t_Pool        = this;
+        t_WorkerIndex = index;
+
+        for (;;)
+        {
+            {
+                std::unique_lock<std::mutex> lock(m_Mutex);
+                m_TaskReady.wait(lock, [this]() { return m_Stopping || m_Queued > 0; });
+                if (m_Queued == 0)
+                    return; // stopping and drained
+
+                // Claim one task; it is already in some queue since submit() pushes before counting.
+                --m_Queued;
+                ++m_Running;
+            }
+
+            // Another worker may have taken the task this claim counted while its own is still being found;
+            // the total queued never drops below the outstanding claims, so a rescan succeeds.
+            std::function<void()> task;
+            while (!take(index, task))
+                std::this_thread::yield();
+
+            task();
+
+            {
+                std::lock_guard<std::mutex> lock(m_Mutex);
+                --m_Running;
+                if (m_Queued == 0 && m_Running == 0)
+                    m_Idle.notify_all();
+            }
+        }
+    }
+} // namespace vshadersystem
@@ -0,0 +1,210 @@
+#include "vshadersystem/validation.hpp"
+#include "vshadersystem/hash.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+
+#ifdef VSHADERSYSTEM_HAS_SPIRV_TOOLS
+#include <spirv-tools/libspirv.hpp>
+#endif
+
+namespace vshadersystem
+{
+    bool spirv_validation_available()
+    {
+#ifdef VSHADERSYSTEM_HAS_SPIRV_TOOLS
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    Result<void> validate_spirv(const std::vector<uint32_t>& spirv)
+    {
+#ifdef VSHADERSYSTEM_HAS_SPIRV_TOOLS
+        std::string          diagnostics;
+        spvtools::SpirvTools tools(SPV_ENV_VULKAN_1_2);
+
+        tools.SetMessageConsumer(
+            [&](spv_message_level_t, const char*, const spv_position_t& position, const char* message) {
+                diagnostics += "word " + std::to_string(position.index) + ": " + message + "\n";
+            });
+
+        spvtools::ValidatorOptions options;
+        if (!tools.Validate(spirv.data(), spirv.size(), options))
+            return Result<void>::err({ErrorCode::eCompileError, "SPIR-V validation failed:\n" + diagnostics});
+
+        return Result<void>::ok();
+#else
+        (void)spirv;
+        return Result<void>::err(
+            {ErrorCode::eInvalidArgument,
+             "SPIR-V validation is unavailable: vshadersystem was built without the vshadersystem_spirv_tools "
+             "option."});
+#endif
+    }
+
+    // ------------------------------------------------------------
+    // SpirvValidationCache
+    // ------------------------------------------------------------
+    static uint64_t validator_seed()
+    {
+        // A newer validator may reject modules an older one accepted.
+#ifdef VSHADERSYSTEM_HAS_SPIRV_TOOLS
+        static const uint64_t seed = xxhash64(std::string("vulkan1.2;") + spvSoftwareVersionString());
+#else
+        static const uint64_t seed = 0;
+#endif
+        return seed;
+    }
+
+    SpirvValidationCache::SpirvValidationCache(std::string cacheDir)
+    {
+        if (cacheDir.empty())
+            return;
+
+        m_File = (std::filesystem::path(cacheDir) / "spirv_validated").string();
+
+        std::ifstream f(m_File);
+        std::string   line;
+        while (std::getline(f, line))
+        {
+            if (!line.empty())
+                m_Passed.insert(std::strtoull(line.c_str(), nullptr, 16));
+        }
+    }
+
+    uint64_t SpirvValidationCache::key(uint64_t spirvHash) const
+    {
+        return xxhash64(&spirvHash, sizeof(spirvHash), validator_seed());
+    }
+
+    std::optional<Result<void>> SpirvValidationCache::lookup(uint64_t k)
+    {
+        if (m_Passed.find(k) != m_Passed.end())
+        {
+            ++m_Cached;
+            return Result<void>::ok();
+        }
+        if (auto it = m_Failed.find(k); it != m_Failed.end())
+        {
+            ++m_Cached;
+            return Result<void>::err({ErrorCode::eCompileError, it->second});
+        }
+        return std::nullopt;
+    }
+
+    Result<void> SpirvValidationCache::validate(const std::vector<uint32_t>& spirv, uint64_t spirvHash)
+    {
+        const uint64_t k = key(spirvHash);
+
+        {
+            std::unique_lock<std::mutex> lock(m_Mutex);
+            m_Done.wait(lock, [&]() { return m_Running.find(k) == m_Running.end(); });
+
+            if (auto known = lookup(k))
+                return std::move(*known);
+
+            m_Running.insert(k);
+        }
+
+        return run(k, spirv);
+    }
+
+    void SpirvValidationCache::validateAsync(std::shared_ptr<const std::vector<uint32_t>> spirv,
+                                             uint64_t                                     spirvHash,
+                                             TaskGroup&                                   group,
+                                             Callback                                     onDone)
+    {
+        const uint64_t k = key(spirvHash);
+
+        std::optional<Result<void>> known;
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            if (m_Running.find(k) != m_Running.end())
+            {
+                ++m_Cached;
+                m_Waiters[k].push_back(std::move(onDone));
+                return;
+            }
+
+            known = lookup(k);
+            if (!known)
+                m_Running.insert(k);
+        }
+
+        if (known)
+        {
+            onDone(*known);
+            return;
+        }
+
+        group.run([this, k, spirv = std::move(spirv), onDone = std::move(onDone)]() { onDone(run(k, *spirv)); });
+    }
+
+    Result<void> SpirvValidationCache::run(uint64_t k, const std::vector<uint32_t>& spirv)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        auto       r     = validate_spirv(spirv);
+        const auto ms    = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        std::vector<Callback> waiters;
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_Running.erase(k);
+            ++m_Validated;
+            m_TotalMs += ms;
+
+            if (auto it = m_Waiters.find(k); it != m_Waiters.end())
+            {
+                waiters = std::move(it->second);
+                m_Waiters.erase(it);
+            }
+
+            if (r.isOk())
+            {
+                m_Passed.insert(k);
+                if (!m_File.empty())
+                {
+                    std::error_code ec;
+                    std::filesystem::create_directories(std::filesystem::path(m_File).parent_path(), ec);
+
+                    char buf[32];
+                    std::snprintf(buf, sizeof(buf), "%016llx\n", static_cast<unsigned long long>(k));
+                    std::ofstream(m_File, std::ios::app) << buf;
+                }
+            }
+            else if (r.error().code == ErrorCode::eCompileError)
+            {
+                m_Failed.emplace(k, r.error().message);
+            }
+        }
+        m_Done.notify_all();
+
+        for (auto& w : waiters)
+            w(r);
+
+        return r;
+    }
+
+    size_t SpirvValidationCache::validatedCount() const
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        return m_Validated;
+    }
+
+    size_t SpirvValidationCache::cachedCount() const
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        return m_Cached;
+    }
+
+    double SpirvValidationCache::totalValidateMs() const
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        return m_TotalMs;
+    }
+} // namespace vshadersystem
@@ -0,0 +1,98 @@
+#include "vshadersystem/variants.hpp"
+
+#include <memory>
+#include <utility>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <dlfcn.h>
+#endif
+
+namespace vshadersystem
+{
+    namespace
+    {
+        using StripVariantFn = int (*)(const char*        shaderId,
+                                       const char*        stage,
+                                       const char* const* names,
+                                       const char* const* values,
+                                       uint32_t           count);
+
+        constexpr const char* kStripSymbol = "vshaderc_strip_variant";
+
+        // Owns the loaded module; shared by every copy of the stripper.
+        struct StripPlugin
+        {
+#if defined(_WIN32)
+            HMODULE module = nullptr;
+#else
+            void* module = nullptr;
+#endif
+            StripVariantFn fn = nullptr;
+
+            StripPlugin() = default;
+            StripPlugin(const StripPlugin&)            = delete;
+            StripPlugin& operator=(const StripPlugin&) = delete;
+
+            ~StripPlugin()
+            {
+                if (!module)
+                    return;
+#if defined(_WIN32)
+                FreeLibrary(module);
+#else
+                dlclose(module);
+#endif
+            }
+        };
+    } // namespace
+
+    Result<VariantStripper> load_variant_strip_plugin(const std::string& path)
+    {
+        auto plugin = std::make_shared<StripPlugin>();
+
+#if defined(_WIN32)
+        plugin->module = LoadLibraryA(path.c_str());
+        if (!plugin->module)
+            return Result<VariantStripper>::err(
+                {ErrorCode::eIO,
+                 "failed to load strip plugin: " + path + " (error " + std::to_string(GetLastError()) + ")"});
+
+        plugin->fn = reinterpret_cast<StripVariantFn>(GetProcAddress(plugin->module, kStripSymbol));
+#else
+        plugin->module = dlopen(path.c_str(), RTLD_NOW | RTLD_LOCAL);
+        if (!plugin->module)
+            return Result<VariantStripper>::err(
+                {ErrorCode::eIO, "failed to load strip plugin: " + std::string(dlerror())});
+
+        plugin->fn = reinterpret_cast<StripVariantFn>(dlsym(plugin->module, kStripSymbol));
+#endif
+        if (!plugin->fn)
+            return Result<VariantStripper>::err(
+                {ErrorCode::eInvalidArgument, "strip plugin " + path + " does not export " + kStripSymbol});
+
+        return Result<VariantStripper>::ok([plugin](const VariantStripQuery& q) {
+            const std::string shaderId(q.shaderId);
+
+            std::vector<const char*> names;
+            std::vector<const char*> values;
+            names.reserve(q.defines.size());
+            values.reserve(q.defines.size());
+            for (const auto& d : q.defines)
+            {
+                names.push_back(d.name.c_str());
+                values.push_back(d.value.c_str());
+            }
+
+            return plugin->fn(shaderId.c_str(),
+                              shader_stage_name(q.stage),
+                              names.data(),
+                              values.data(),
+                              static_cast<uint32_t>(q.defines.size())) != 0;
+        });
+    }
+} // namespace vshadersystem
@@ -0,0 +1,338 @@
+#include "vshadersystem/variants.hpp"
+#include "vshadersystem/keyword_expr.hpp"
+#include "vshadersystem/parser_utils.hpp"
+
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+namespace vshadersystem
+{
+    // pinned[idx] non-empty: the engine keywords fix that keyword, only this value is enumerated.
+    static void enumerate_permutation_variants(const std::vector<const KeywordDecl*>& permuteDecls,
+                                               const std::vector<std::string>&        pinned,
+                                               size_t                                 idx,
+                                               std::vector<Define>&                   cur,
+                                               std::vector<std::vector<Define>>&      out)
+    {
+        if (idx >= permuteDecls.size())
+        {
+            out.push_back(cur);
+            return;
+        }
+
+        const KeywordDecl* kd = permuteDecls[idx];
+
+        if (!pinned[idx].empty())
+        {
+            cur.push_back({kd->name, pinned[idx]});
+            enumerate_permutation_variants(permuteDecls, pinned, idx + 1, cur, out);
+            cur.pop_back();
+            return;
+        }
+
+        // Bool: {0,1}
+        if (kd->kind == KeywordValueKind::eBool)
+        {
+            for (const char* v : {"0", "1"})
+            {
+                Define d;
+                d.name  = kd->name;
+                d.value = v;
+                cur.push_back(std::move(d));
+                enumerate_permutation_variants(permuteDecls, pinned, idx + 1, cur, out);
+                cur.pop_back();
+            }
+            return;
+        }
+
+        // Enum: use enumerant strings
+        for (const auto& ev : kd->enumValues)
+        {
+            Define d;
+            d.name  = kd->name;
+            d.value = ev;
+            cur.push_back(std::move(d));
+            enumerate_permutation_variants(permuteDecls, pinned, idx + 1, cur, out);
+            cur.pop_back();
+        }
+    }
+
+    // Returns true when the variant satisfies every only_if constraint.
+    static Result<bool> check_variant_constraints(const ParsedMetadata&      meta,
+                                                  const EngineKeywordsFile*  engineKeywords,
+                                                  const std::vector<Define>& defines,
+                                                  std::string&               violatedKeyword)
+    {
+        KeywordValueContext ctx;
+        ctx.values.reserve(meta.keywords.size() * 2);
+        ctx.decls.reserve(meta.keywords.size() * 2);
+
+        for (const auto& kd : meta.keywords)
+            ctx.decls[kd.name] = &kd;
+
+        std::unordered_map<std::string, std::string> defMap;
+        defMap.reserve(defines.size() * 2);
+        for (const auto& d : defines)
+            defMap[d.name] = d.value;
+
+        // resolve values for all keywords: defaults -> defines -> engineKw (global only)
+        for (const auto& kd : meta.keywords)
+        {
+            uint32_t v = kd.defaultValue;
+
+            auto it = defMap.find(kd.name);
+            if (it != defMap.end())
+            {
+                auto pv = parse_keyword_value(kd, it->second);
+                if (!pv.isOk())
+                    return Result<bool>::err(pv.error());
+                v = pv.value();
+            }
+            else if (engineKeywords && kd.scope == KeywordScope::eGlobal)
+            {
+                auto iv = engineKeywords->values.find(kd.name);
+                if (iv != engineKeywords->values.end())
+                {
+                    auto pv = parse_keyword_value(kd, iv->second);
+                    if (!pv.isOk())
+                        return Result<bool>::err(pv.error());
+                    v = pv.value();
+                }
+            }
+
+            ctx.values[kd.name] = v;
+        }
+
+        for (const auto& kd : meta.keywords)
+        {
+            if (kd.constraint.empty())
+                continue;
+
+            auto er = eval_only_if(kd.constraint, ctx);
+            if (!er.isOk())
+                return Result<bool>::err(
+                    {er.error().code, "failed to eval only_if for keyword '" + kd.name + "': " + er.error().message});
+
+            if (!er.value())
+            {
+                violatedKeyword = kd.name;
+                return Result<bool>::ok(false);
+            }
+        }
+
+        return Result<bool>::ok(true);
+    }
+
+    Result<VariantEnumeration>
+    enumerate_shader_variants(const ParsedMetadata& meta, const EngineKeywordsFile* engineKeywords, bool skipInvalid)
+    {
+        return enumerate_shader_variants(meta, engineKeywords, skipInvalid, {}, ShaderStage::eUnknown, {});
+    }
+
+    Result<VariantEnumeration> enumerate_shader_variants(const ParsedMetadata&     meta,
+                                                         const EngineKeywordsFile* engineKeywords,
+                                                         bool                      skipInvalid,
+                                                         std::string_view          shaderId,
+                                                         ShaderStage               stage,
+                                                         const VariantStripper&    stripper)
+    {
+        // Collect permutation keyword decls
+        std::vector<const KeywordDecl*> permuteDecls;
+        permuteDecls.reserve(meta.keywords.size());
+
+        for (const auto& kd : meta.keywords)
+        {
+            if (kd.dispatch == KeywordDispatch::ePermutation)
+                permuteDecls.push_back(&kd);
+        }
+
+        // Global keywords set by the engine have a single value in every variant; enumerating the others
+        // would only produce variants whose resolved keyword values (and variant hash) collide.
+        std::vector<std::string> pinned(permuteDecls.size());
+        if (engineKeywords)
+        {
+            for (size_t i = 0; i < permuteDecls.size(); ++i)
+            {
+                const KeywordDecl& kd = *permuteDecls[i];
+                if (kd.scope != KeywordScope::eGlobal)
+                    continue;
+
+                auto it = engineKeywords->values.find(kd.name);
+                if (it == engineKeywords->values.end())
+                    continue;
+
+                auto pv = parse_keyword_value(kd, it->second);
+                if (!pv.isOk())
+                    return Result<VariantEnumeration>::err(pv.error());
+
+                if (kd.kind == KeywordValueKind::eBool)
+                    pinned[i] = pv.value() ? "1" : "0";
+                else
+                    pinned[i] = kd.enumValues[pv.value()];
+            }
+        }
+
+        // Enumerate all combinations
+        std::vector<std::vector<Define>> all;
+        {
+            std::vector<Define> cur;
+            enumerate_permutation_variants(permuteDecls, pinned, 0, cur, all);
+        }
+
+        if (all.empty())
+            all.push_back({});
+
+        VariantEnumeration out;
+        out.variants.reserve(all.size());
+
+        for (auto& defines : all)
+        {
+            std::string violated;
+            auto        cr = check_variant_constraints(meta, engineKeywords, defines, violated);
+            if (!cr.isOk())
+                return Result<VariantEnumeration>::err(cr.error());
+
+            if (!cr.value())
+            {
+                ++out.pruned;
+
+                if (!skipInvalid)
+                    return Result<VariantEnumeration>::err(
+                        {ErrorCode::eInvalidArgument, "variant violates only_if constraint (" + violated + ")"});
+                continue;
+            }
+
+            if (stripper && stripper(VariantStripQuery {shaderId, stage, defines}))
+            {
+                ++out.stripped;
+                continue;
+            }
+
+            out.variants.push_back(std::move(defines));
+        }
+
+        return Result<VariantEnumeration>::ok(std::move(out));
+    }
+
+    uint32_t variant_default_distance(const ParsedMetadata&      meta,
+                                      const EngineKeywordsFile*  engineKeywords,
+                                      const std::vector<Define>& defines)
+    {
+        uint32_t distance = 0;
+        for (const auto& kd : meta.keywords)
+        {
+            if (kd.dispatch != KeywordDispatch::ePermutation)
+                continue;
+
+            uint32_t base = kd.defaultValue;
+            if (engineKeywords && kd.scope == KeywordScope::eGlobal)
+            {
+                auto it = engineKeywords->values.find(kd.name);
+                if (it != engineKeywords->values.end())
+                {
+                    auto pv = parse_keyword_value(kd, it->second);
+                    if (pv.isOk())
+                        base = pv.value();
+                }
+            }
+
+            for (const auto& d : defines)
+            {
+                if (d.name != kd.name)
+                    continue;
+
+                auto pv = parse_keyword_value(kd, d.value);
+                if (pv.isOk() && pv.value() != base)
+                    ++distance;
+                break;
+            }
+        }
+        return distance;
+    }
+
+    uint64_t VariantUsageLog::weight(std::string_view shaderId, const std::vector<Define>& defines) const
+    {
+        uint64_t total = 0;
+        for (const auto& r : records)
+        {
+            if (r.shaderId != shaderId)
+                continue;
+
+            bool match = true;
+            for (const auto& want : r.values)
+            {
+                bool found = false;
+                for (const auto& d : defines)
+                {
+                    if (d.name == want.name)
+                    {
+                        found = d.value == want.value;
+                        break;
+                    }
+                }
+
+                if (!found)
+                {
+                    match = false;
+                    break;
+                }
+            }
+
+            if (match)
+                total += r.count;
+        }
+        return total;
+    }
+
+    Result<VariantUsageLog> VariantUsageLog::load(const std::string& filePath)
+    {
+        std::ifstream f(filePath, std::ios::binary);
+        if (!f)
+            return Result<VariantUsageLog>::err({ErrorCode::eIO, "Failed to open usage log: " + filePath});
+
+        VariantUsageLog log;
+        std::string     line;
+        size_t          lineNo = 0;
+
+        while (std::getline(f, line))
+        {
+            ++lineNo;
+
+            if (const size_t hash = line.find('#'); hash != std::string::npos)
+                line.resize(hash);
+
+            std::istringstream ss(line);
+            std::string        countText;
+            if (!(ss >> countText))
+                continue;
+
+            const std::string where = filePath + ":" + std::to_string(lineNo);
+
+            VariantUsageRecord r;
+            char*              end = nullptr;
+            r.count                = std::strtoull(countText.c_str(), &end, 10);
+            if (end != countText.c_str() + countText.size() || !(ss >> r.shaderId))
+                return Result<VariantUsageLog>::err(
+                    {ErrorCode::eParseError, where + ": expected <count> <shaderId> [NAME=VALUE ...]"});
+
+            std::string kv;
+            while (ss >> kv)
+            {
+                const size_t eq = kv.find('=');
+                if (eq == std::string::npos || eq == 0)
+                    return Result<VariantUsageLog>::err(
+                        {ErrorCode::eParseError, where + ": expected NAME=VALUE, got '" + kv + "'"});
+
+                r.values.push_back({kv.substr(0, eq), kv.substr(eq + 1)});
+            }
+
+            log.records.push_back(std::move(r));
+        }
+
+        return Result<VariantUsageLog>::ok(std::move(log));
+    }
+} // namespace vshadersystem
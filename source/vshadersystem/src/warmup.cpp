@@ -0,0 +1,224 @@
+#include "vshadersystem/warmup.hpp"
+#include "vshadersystem/binary.hpp"
+#include "vshadersystem/shader_id.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <set>
+#include <unordered_map>
+#include <utility>
+
+namespace vshadersystem
+{
+    static bool warmup_less(const WarmupItem& a, const WarmupItem& b) { return a.priority < b.priority; }
+
+    WarmupScheduler::WarmupScheduler(const ShaderLibrary& lib, Callback onReady) :
+        m_Library(lib), m_OnReady(std::move(onReady))
+    {}
+
+    void WarmupScheduler::enqueue(const WarmupItem& item)
+    {
+        if (!m_Known.insert({item.keyHash, item.stage}).second)
+            return;
+
+        m_Pending.push_back(item);
+        std::push_heap(m_Pending.begin(), m_Pending.end(), warmup_less);
+        m_Progress.remaining = m_Pending.size();
+    }
+
+    void WarmupScheduler::enqueue(std::span<const WarmupItem> items)
+    {
+        m_Pending.reserve(m_Pending.size() + items.size());
+        for (const auto& item : items)
+        {
+            if (m_Known.insert({item.keyHash, item.stage}).second)
+                m_Pending.push_back(item);
+        }
+
+        std::make_heap(m_Pending.begin(), m_Pending.end(), warmup_less);
+        m_Progress.remaining = m_Pending.size();
+    }
+
+    void WarmupScheduler::reprioritize(const std::function<float(const WarmupItem& item)>& score)
+    {
+        for (auto& item : m_Pending)
+            item.priority = score(item);
+        std::make_heap(m_Pending.begin(), m_Pending.end(), warmup_less);
+    }
+
+    void WarmupScheduler::decodeNext()
+    {
+        std::pop_heap(m_Pending.begin(), m_Pending.end(), warmup_less);
+        const WarmupItem item = m_Pending.back();
+        m_Pending.pop_back();
+
+        ++m_Progress.completed;
+        m_Progress.remaining = m_Pending.size();
+
+        const auto blob = find_vshlib_blob(m_Library, item.keyHash, item.stage);
+        if (blob.empty())
+        {
+            ++m_Progress.failed;
+            m_OnReady(item, Result<ShaderBinary>::err({ErrorCode::eIO, "VSHLIB entry not found."}));
+            return;
+        }
+
+        const auto start = std::chrono::steady_clock::now();
+        auto       br    = read_vshbin(blob);
+        m_DecodedNs += std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        m_DecodedBytes += blob.size();
+
+        if (!br.isOk())
+            ++m_Progress.failed;
+        m_OnReady(item, std::move(br));
+    }
+
+    WarmupProgress WarmupScheduler::update(double budgetMs)
+    {
+        using Clock = std::chrono::steady_clock;
+
+        const auto start = Clock::now();
+        bool       first = true;
+
+        while (!m_Pending.empty())
+        {
+            // The first decode of a frame always runs; later ones only if the measured cost predicts they fit.
+            const double spentMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+            if (!first && spentMs >= budgetMs)
+                break;
+
+            if (!first && m_DecodedBytes > 0)
+            {
+                const auto* e = find_vshlib_entry(m_Library, m_Pending.front().keyHash, m_Pending.front().stage);
+                const double predictedMs =
+                    e ? (m_DecodedNs / static_cast<double>(m_DecodedBytes)) * static_cast<double>(e->size) * 1e-6 : 0.0;
+                if (spentMs + predictedMs > budgetMs)
+                    break;
+            }
+
+            decodeNext();
+            first = false;
+        }
+
+        m_Progress.spentMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+        return m_Progress;
+    }
+
+    WarmupProgress WarmupScheduler::finish()
+    {
+        const auto start = std::chrono::steady_clock::now();
+        while (!m_Pending.empty())
+            decodeNext();
+
+        m_Progress.spentMs =
+            std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        return m_Progress;
+    }
+
+    void WarmupScheduler::clear()
+    {
+        m_Pending.clear();
+        m_Known.clear();
+        m_Progress = {};
+    }
+
+    void warmup_async(const ShaderLibrary&        lib,
+                      std::span<const WarmupItem> items,
+                      TaskGroup&                  group,
+                      WarmupScheduler::Callback   onReady)
+    {
+        std::vector<WarmupItem> ordered(items.begin(), items.end());
+        std::stable_sort(
+            ordered.begin(), ordered.end(), [](const WarmupItem& a, const WarmupItem& b) { return warmup_less(b, a); });
+
+        std::set<std::pair<uint64_t, ShaderStage>> seen;
+
+        auto callback = std::make_shared<const WarmupScheduler::Callback>(std::move(onReady));
+        for (const auto& item : ordered)
+        {
+            if (!seen.insert({item.keyHash, item.stage}).second)
+                continue;
+
+            group.run([&lib, item, callback]() {
+                const auto blob = find_vshlib_blob(lib, item.keyHash, item.stage);
+                if (blob.empty())
+                {
+                    (*callback)(item, Result<ShaderBinary>::err({ErrorCode::eIO, "VSHLIB entry not found."}));
+                    return;
+                }
+                (*callback)(item, read_vshbin(blob));
+            });
+        }
+    }
+
+    // ------------------------------------------------------------
+    // Item lists
+    // ------------------------------------------------------------
+    static bool usage_value_matches(const KeywordBitField& field, const std::string& value, uint32_t entryValue)
+    {
+        if (field.kind == KeywordValueKind::eBool)
+        {
+            if (value == "1" || value == "true" || value == "TRUE" || value == "True")
+                return entryValue == 1;
+            if (value == "0" || value == "false" || value == "FALSE" || value == "False")
+                return entryValue == 0;
+            return false;
+        }
+
+        return entryValue < field.enumValues.size() && field.enumValues[entryValue] == value;
+    }
+
+    std::vector<WarmupItem> warmup_items_from_usage_log(const ShaderLibrary& lib, const VariantUsageLog& log)
+    {
+        const auto& bitsets = lib.keywordBitsets;
+
+        std::unordered_map<uint64_t, std::vector<const VariantUsageRecord*>> recordsByShader;
+        for (const auto& r : log.records)
+            recordsByShader[shader_id_hash(r.shaderId)].push_back(&r);
+
+        std::vector<WarmupItem> out;
+        for (uint32_t i = 0; i < bitsets.entryCount && i < lib.entries.size(); ++i)
+        {
+            auto it = recordsByShader.find(bitsets.shaderIdHashes[i]);
+            if (bitsets.shaderIdHashes[i] == 0 || it == recordsByShader.end())
+                continue;
+
+            uint64_t weight = 0;
+            for (const auto* r : it->second)
+            {
+                bool match = true;
+                for (const auto& want : r->values)
+                {
+                    const auto* field = bitsets.find(want.name);
+                    uint32_t    value = 0;
+                    if (!field || !bitsets.get(i, *field, value) || !usage_value_matches(*field, want.value, value))
+                    {
+                        match = false;
+                        break;
+                    }
+                }
+
+                if (match)
+                    weight += r->count;
+            }
+
+            if (weight > 0)
+                out.push_back({lib.entries[i].keyHash, lib.entries[i].stage, static_cast<float>(weight)});
+        }
+        return out;
+    }
+
+    std::vector<WarmupItem> warmup_items_from_library(const ShaderLibrary& lib, int32_t profile)
+    {
+        std::vector<WarmupItem> out;
+        out.reserve(lib.entries.size());
+        for (size_t i = 0; i < lib.entries.size(); ++i)
+        {
+            if (profile >= 0 && !vshlib_entry_in_profile(lib, i, static_cast<uint32_t>(profile)))
+                continue;
+            out.push_back({lib.entries[i].keyHash, lib.entries[i].stage, 0.0f});
+        }
+        return out;
+    }
+} // namespace vshadersystem
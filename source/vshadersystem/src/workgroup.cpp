@@ -0,0 +1,197 @@
+#include "vshadersystem/workgroup.hpp"
+#include "vshadersystem/hash.hpp"
+
+#include <spirv_cross/spirv.hpp>
+
+#include <unordered_map>
+
+namespace vshadersystem
+{
+    static bool parse_dim(std::string_view s, uint32_t& out)
+    {
+        if (s.empty() || s.size() > 9)
+            return false;
+        uint32_t v = 0;
+        for (char c : s)
+        {
+            if (c < '0' || c > '9')
+                return false;
+            v = v * 10u + static_cast<uint32_t>(c - '0');
+        }
+        if (v == 0)
+            return false;
+        out = v;
+        return true;
+    }
+
+    Result<std::vector<WorkgroupSize>> parse_workgroup_sizes(std::string_view list)
+    {
+        std::vector<WorkgroupSize> out;
+
+        size_t i = 0;
+        while (i <= list.size())
+        {
+            size_t j = list.find_first_of(",;", i);
+            if (j == std::string_view::npos)
+                j = list.size();
+
+            std::string_view item = list.substr(i, j - i);
+            while (!item.empty() && item.front() == ' ')
+                item.remove_prefix(1);
+            while (!item.empty() && item.back() == ' ')
+                item.remove_suffix(1);
+
+            if (!item.empty())
+            {
+                uint32_t dims[3] = {1, 1, 1};
+                size_t   d       = 0;
+                size_t   k       = 0;
+                while (true)
+                {
+                    const size_t x = item.find('x', k);
+                    const auto   s = item.substr(k, x == std::string_view::npos ? std::string_view::npos : x - k);
+                    if (d >= 3 || !parse_dim(s, dims[d]))
+                        return Result<std::vector<WorkgroupSize>>::err(
+                            {ErrorCode::eInvalidArgument, "Invalid workgroup size: " + std::string(item)});
+                    ++d;
+                    if (x == std::string_view::npos)
+                        break;
+                    k = x + 1;
+                }
+                out.push_back({dims[0], dims[1], dims[2]});
+            }
+
+            i = j + 1;
+        }
+
+        return Result<std::vector<WorkgroupSize>>::ok(std::move(out));
+    }
+
+    std::string format_workgroup_size(const WorkgroupSize& size)
+    {
+        return std::to_string(size.x) + "x" + std::to_string(size.y) + "x" + std::to_string(size.z);
+    }
+
+    Result<std::vector<uint32_t>> specialize_workgroup_size(const std::vector<uint32_t>& spirv,
+                                                            const ShaderReflection&      refl,
+                                                            const WorkgroupSize&         size)
+    {
+        constexpr size_t kHeaderWords = 5;
+
+        if (spirv.size() < kHeaderWords || spirv[0] != spv::MagicNumber)
+            return Result<std::vector<uint32_t>>::err({ErrorCode::eInvalidArgument, "Invalid SPIR-V module header."});
+        if (!refl.hasLocalSize)
+            return Result<std::vector<uint32_t>>::err(
+                {ErrorCode::eInvalidArgument, "Workgroup size variants require a compute shader."});
+
+        const uint32_t specIds[3] = {refl.localSizeSpecIdX, refl.localSizeSpecIdY, refl.localSizeSpecIdZ};
+        const uint32_t fixed[3]   = {refl.localSizeX, refl.localSizeY, refl.localSizeZ};
+        const uint32_t wanted[3]  = {size.x, size.y, size.z};
+
+        for (int d = 0; d < 3; ++d)
+        {
+            if (specIds[d] == kNoSpecId && fixed[d] != wanted[d])
+                return Result<std::vector<uint32_t>>::err(
+                    {ErrorCode::eInvalidArgument,
+                     "Workgroup size " + format_workgroup_size(size) + " changes a dimension without local_size_" +
+                         std::string(1, static_cast<char>('x' + d)) + "_id."});
+        }
+
+        std::vector<uint32_t> out = spirv;
+
+        // SpecId decorations precede the constants they decorate.
+        std::unordered_map<uint32_t, uint32_t> specIdOf; // result id -> SpecId
+        bool                                   patched[3] = {false, false, false};
+
+        for (size_t i = kHeaderWords; i < out.size();)
+        {
+            const uint32_t wordCount = out[i] >> 16;
+            const uint32_t op        = out[i] & 0xFFFFu;
+            if (wordCount == 0 || i + wordCount > out.size())
+                return Result<std::vector<uint32_t>>::err(
+                    {ErrorCode::eInvalidArgument, "Malformed SPIR-V instruction stream."});
+
+            if (op == spv::OpDecorate && wordCount >= 4 && out[i + 2] == spv::DecorationSpecId)
+            {
+                specIdOf[out[i + 1]] = out[i + 3];
+            }
+            else if (op == spv::OpExecutionMode && wordCount >= 6 && out[i + 2] == spv::ExecutionModeLocalSize)
+            {
+                // Keep the literal LocalSize in sync for tools that ignore the WorkgroupSize built-in.
+                for (int d = 0; d < 3; ++d)
+                {
+                    if (specIds[d] != kNoSpecId)
+                        out[i + 3 + d] = wanted[d];
+                }
+            }
+            else if (op == spv::OpSpecConstant && wordCount == 4)
+            {
+                auto it = specIdOf.find(out[i + 2]);
+                if (it != specIdOf.end())
+                {
+                    for (int d = 0; d < 3; ++d)
+                    {
+                        if (specIds[d] == it->second)
+                        {
+                            out[i + 3] = wanted[d];
+                            patched[d] = true;
+                        }
+                    }
+                }
+            }
+            else if (op == spv::OpFunction)
+            {
+                break;
+            }
+
+            i += wordCount;
+        }
+
+        for (int d = 0; d < 3; ++d)
+        {
+            if (specIds[d] != kNoSpecId && !patched[d])
+                return Result<std::vector<uint32_t>>::err(
+                    {ErrorCode::eInvalidArgument,
+                     "Specialization constant " + std::to_string(specIds[d]) + " for the local size not found."});
+        }
+
+        return Result<std::vector<uint32_t>>::ok(std::move(out));
+    }
+
+    uint64_t workgroup_variant_hash(uint64_t variantHash, const WorkgroupSize& size)
+    {
+        const uint32_t words[3] = {size.x, size.y, size.z};
+        return xxhash64(words, sizeof(words), variantHash);
+    }
+
+    size_t select_workgroup_size(const std::vector<WorkgroupSize>& candidates,
+                                 uint32_t                          threadsX,
+                                 uint32_t                          threadsY,
+                                 uint32_t                          threadsZ)
+    {
+        auto launched = [](uint32_t threads, uint32_t size) -> uint64_t {
+            const uint64_t s = size == 0 ? 1 : size;
+            return (static_cast<uint64_t>(threads) + s - 1) / s * s;
+        };
+
+        size_t   best         = 0;
+        uint64_t bestLaunched = UINT64_MAX;
+        uint64_t bestVolume   = 0;
+
+        for (size_t i = 0; i < candidates.size(); ++i)
+        {
+            const auto&    c = candidates[i];
+            const uint64_t n = launched(threadsX, c.x) * launched(threadsY, c.y) * launched(threadsZ, c.z);
+            const uint64_t v = static_cast<uint64_t>(c.x) * c.y * c.z;
+
+            if (n < bestLaunched || (n == bestLaunched && v > bestVolume))
+            {
+                best         = i;
+                bestLaunched = n;
+                bestVolume   = v;
+            }
+        }
+
+        return best;
+    }
+} // namespace vshadersystem
@@ -4,6 +4,10 @@ add_requires("spirv-cross vulkan-sdk-1.4.309", {configs = { shared = true, debug
 add_requires("glslang 1.4.309+0", {configs = {debug = is_mode("debug")}, system = false})
 add_requires("xxhash")
 
+if has_config("vshadersystem_spirv_tools") then
+	add_requires("spirv-tools 1.4.309+0", {configs = {debug = is_mode("debug")}, system = false})
+end
+
 target("vshadersystem")
 	set_kind("static")
 
@@ -14,5 +18,31 @@ target("vshadersystem")
 
 	add_packages("glslang", "spirv-cross", "xxhash", {public = true})
 
+	-- Link modules, validation
+	if has_config("vshadersystem_spirv_tools") then
+		add_packages("spirv-tools", {public = true})
+		add_defines("VSHADERSYSTEM_HAS_SPIRV_TOOLS", {public = true})
+	end
+
+	-- ThreadPool
+	if is_plat("linux", "bsd") then
+		add_syslinks("pthread", {public = true})
+	end
+
+	-- Variant strip plugins (dlopen)
+	if is_plat("linux") then
+		add_syslinks("dl", {public = true})
+	end
+
+	-- ProcessPool (worker memory readout)
+	if is_plat("windows", "mingw") then
+		add_syslinks("psapi", {public = true})
+	end
+
+	-- Live link (Unix domain sockets)
+	if is_plat("windows", "mingw") then
+		add_syslinks("ws2_32", {public = true})
+	end
+
 	-- set target directory
     set_targetdir("$(builddir)/$(plat)/$(arch)/$(mode)/vshadersystem")
\ No newline at end of file
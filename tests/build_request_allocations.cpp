@@ -0,0 +1,165 @@
+// Builds the per-variant BuildRequests of a shader the way vshaderc build/watch/analyze do: the source,
+// include dirs, engine keywords and binding table are shared, only the defines belong to the variant.
+// Counts allocations through a replaced operator new and checks that nothing the variants share is
+// copied per request: the allocations for N variants are the same whether the shared data is tiny or
+// large, and none of them is large.
+
+#include <vshadersystem/system.hpp>
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <string>
+#include <vector>
+
+using namespace vshadersystem;
+
+namespace
+{
+    std::atomic<bool>   g_Counting {false};
+    std::atomic<size_t> g_Allocations {0};
+    std::atomic<size_t> g_LargeAllocations {0};
+
+    constexpr size_t kLargeAllocation = 16 * 1024;
+} // namespace
+
+void* operator new(std::size_t size)
+{
+    if (g_Counting.load(std::memory_order_relaxed))
+    {
+        ++g_Allocations;
+        if (size >= kLargeAllocation)
+            ++g_LargeAllocations;
+    }
+
+    if (void* p = std::malloc(size ? size : 1))
+        return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+namespace
+{
+    struct SharedInputs
+    {
+        std::shared_ptr<const std::string>              source;
+        std::shared_ptr<const std::vector<std::string>> includeDirs;
+        std::shared_ptr<const EngineKeywordsFile>       keywords;
+        std::shared_ptr<const BindingTable>             bindingTable;
+    };
+
+    // scale = 0 gives the smallest inputs; larger scales grow every shared input.
+    SharedInputs make_inputs(size_t scale)
+    {
+        std::string source = "#version 460\n#pragma keyword permute USE_A\n#pragma keyword permute USE_B\n";
+        source.append(scale * 64 * 1024, ' ');
+        source += "\nvoid main() {}\n";
+
+        std::vector<std::string> includeDirs = {"shaders/include"};
+        EngineKeywordsFile       keywords;
+        BindingTable             table;
+        for (size_t i = 0; i < scale * 256; ++i)
+        {
+            const std::string name = "RESOURCE_WITH_A_LONG_NAME_" + std::to_string(i);
+            includeDirs.push_back("third_party/some/long/include/directory/" + std::to_string(i));
+            keywords.values[name] = "1";
+            table.entries.push_back({name, KeywordScope::eGlobal, 0, static_cast<uint32_t>(i)});
+        }
+
+        SharedInputs in;
+        in.source       = std::make_shared<const std::string>(std::move(source));
+        in.includeDirs  = std::make_shared<const std::vector<std::string>>(std::move(includeDirs));
+        in.keywords     = std::make_shared<const EngineKeywordsFile>(std::move(keywords));
+        in.bindingTable = std::make_shared<const BindingTable>(std::move(table));
+        return in;
+    }
+
+    struct Counts
+    {
+        size_t allocations      = 0;
+        size_t largeAllocations = 0;
+    };
+
+    Counts count_variant_requests(const SharedInputs& in, const std::vector<std::vector<Define>>& variants)
+    {
+        std::vector<BuildRequest> requests;
+        requests.reserve(variants.size());
+
+        g_Allocations      = 0;
+        g_LargeAllocations = 0;
+        g_Counting         = true;
+
+        for (const auto& defines : variants)
+        {
+            BuildRequest req;
+            req.source.virtualPath        = "pbr.frag.vshader";
+            req.source.sharedSourceText   = in.source;
+            req.options.stage             = ShaderStage::eFrag;
+            req.options.sharedIncludeDirs = in.includeDirs;
+            req.options.defines           = defines;
+            req.sharedEngineKeywords      = in.keywords;
+            req.sharedBindingTable        = in.bindingTable;
+            requests.push_back(std::move(req));
+        }
+
+        g_Counting = false;
+        return {g_Allocations.load(), g_LargeAllocations.load()};
+    }
+
+    std::vector<std::vector<Define>> make_variants(size_t count)
+    {
+        std::vector<std::vector<Define>> out(count);
+        for (size_t i = 0; i < count; ++i)
+            out[i] = {{"USE_A", (i & 1) ? "1" : "0"}, {"USE_B", (i & 2) ? "1" : "0"}};
+        return out;
+    }
+
+    int g_Failures = 0;
+
+    void check(bool ok, const char* what, size_t variants, const Counts& small, const Counts& large)
+    {
+        std::printf("%s variants=%zu allocations small=%zu large=%zu (large allocations: %zu, %zu): %s\n",
+                    what,
+                    variants,
+                    small.allocations,
+                    large.allocations,
+                    small.largeAllocations,
+                    large.largeAllocations,
+                    ok ? "ok" : "FAILED");
+        if (!ok)
+            ++g_Failures;
+    }
+} // namespace
+
+int main()
+{
+    const SharedInputs small = make_inputs(0);
+    const SharedInputs large = make_inputs(16);
+
+    for (size_t n : {1u, 8u, 64u, 512u})
+    {
+        const auto   variants = make_variants(n);
+        const Counts s        = count_variant_requests(small, variants);
+        const Counts l        = count_variant_requests(large, variants);
+
+        check(s.allocations == l.allocations && l.largeAllocations == 0, "shared inputs", n, s, l);
+    }
+
+    // The accessors resolve to the shared copies.
+    BuildRequest req;
+    req.sharedEngineKeywords      = large.keywords;
+    req.sharedBindingTable        = large.bindingTable;
+    req.options.sharedIncludeDirs = large.includeDirs;
+    if (req.engineKeywordsOrNull() != large.keywords.get() || req.bindingTableOrNull() != large.bindingTable.get() ||
+        &req.options.includeDirList() != large.includeDirs.get())
+    {
+        std::printf("shared accessors: FAILED\n");
+        ++g_Failures;
+    }
+
+    return g_Failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,95 @@
+// Include guard detection: a header is only skipped on re-include when its guard is unconditional.
+// A #pragma once nested in #if/#ifdef may be inactive under the current defines, so such a header has
+// to be included again, with and without a shared IncludeCache.
+
+#include <vshadersystem/compiler.hpp>
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+using namespace vshadersystem;
+
+namespace
+{
+    int g_Failures = 0;
+
+    void check(bool ok, const char* what)
+    {
+        std::printf("%s: %s\n", what, ok ? "ok" : "FAILED");
+        if (!ok)
+            ++g_Failures;
+    }
+
+    void write_file(const std::filesystem::path& path, const std::string& text)
+    {
+        std::ofstream(path, std::ios::binary | std::ios::trunc) << text;
+    }
+
+    bool detected_pragma_once(IncludeCache& cache, const std::filesystem::path& path)
+    {
+        IncludeCache::File file;
+        return cache.load(path, file) && file.pragmaOnce;
+    }
+} // namespace
+
+int main()
+{
+    const auto dir = std::filesystem::temp_directory_path() / "vshadersystem_include_guards";
+    std::filesystem::create_directories(dir);
+
+    write_file(dir / "once.glsl", "#pragma once\nconst float kOnce = 1.0;\n");
+    write_file(dir / "conditional_once.glsl",
+               "#ifdef HEADER_ONCE\n"
+               "#pragma once\n"
+               "#endif\n"
+               "#ifdef HEADER_SEEN\n"
+               "#define HEADER_SEEN_TWICE 1\n"
+               "#endif\n"
+               "#define HEADER_SEEN 1\n");
+    write_file(dir / "guarded_once.glsl",
+               "#ifndef GUARDED_ONCE_GLSL\n"
+               "#define GUARDED_ONCE_GLSL\n"
+               "#if 1\n"
+               "#pragma once\n"
+               "#endif\n"
+               "#endif\n");
+
+    IncludeCache cache;
+    check(detected_pragma_once(cache, dir / "once.glsl"), "top-level #pragma once");
+    check(!detected_pragma_once(cache, dir / "conditional_once.glsl"), "conditional #pragma once ignored");
+    check(!detected_pragma_once(cache, dir / "guarded_once.glsl"), "#pragma once inside a guard ignored");
+
+    // HEADER_ONCE is not defined, so the pragma is inactive and the second #include must expand again.
+    SourceInput input;
+    input.virtualPath = (dir / "conditional_once.frag").generic_string();
+    input.sourceText  = "#version 460\n"
+                        "#include \"conditional_once.glsl\"\n"
+                        "#include \"conditional_once.glsl\"\n"
+                        "#ifndef HEADER_SEEN_TWICE\n"
+                        "#error conditional_once.glsl was skipped on its second include\n"
+                        "#endif\n"
+                        "layout(location = 0) out vec4 outColor;\n"
+                        "void main() { outColor = vec4(1.0); }\n";
+
+    CompileOptions options;
+    options.stage       = ShaderStage::eFrag;
+    options.includeDirs = {dir.generic_string()};
+
+    auto uncached = compile_glsl_to_spirv(input, options);
+    check(uncached.isOk(), "conditional #pragma once included twice");
+    if (!uncached.isOk())
+        std::printf("  %s\n", uncached.error().message.c_str());
+
+    options.includeCache = &cache;
+    auto cached          = compile_glsl_to_spirv(input, options);
+    check(cached.isOk(), "conditional #pragma once included twice (IncludeCache)");
+    if (!cached.isOk())
+        std::printf("  %s\n", cached.error().message.c_str());
+
+    std::error_code ec;
+    std::filesystem::remove_all(dir, ec);
+
+    return g_Failures == 0 ? 0 : 1;
+}
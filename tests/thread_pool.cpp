@@ -0,0 +1,159 @@
+// Exercises ThreadPool and TaskGroup the way build and the async library APIs use them: priorities on
+// one worker, stealing of tasks spawned inside a worker, many short task groups, a flood of submissions,
+// draining on destruction, and validateAsync requests for one hash sharing a single run. Meant to run
+// under ThreadSanitizer as well (xmake f --policies=build.sanitizer.thread).
+
+#include <vshadersystem/thread_pool.hpp>
+#include <vshadersystem/validation.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+
+using namespace vshadersystem;
+
+namespace
+{
+    int g_Failures = 0;
+
+    void check(bool ok, const char* what)
+    {
+        std::printf("%s: %s\n", what, ok ? "ok" : "FAILED");
+        if (!ok)
+            ++g_Failures;
+    }
+
+    // A single worker runs queued tasks by priority, each priority in submission order.
+    void test_priority_order()
+    {
+        ThreadPool        pool(1);
+        std::mutex        mutex;
+        std::vector<int>  order;
+        std::atomic<bool> go {false};
+
+        pool.submit([&]() {
+            while (!go)
+                std::this_thread::yield();
+        });
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+        auto record = [&](int v) {
+            std::lock_guard<std::mutex> lock(mutex);
+            order.push_back(v);
+        };
+        for (int i = 0; i < 3; ++i)
+            pool.submit([&, i]() { record(10 + i); }, TaskPriority::eLow);
+        for (int i = 0; i < 3; ++i)
+            pool.submit([&, i]() { record(i); }, TaskPriority::eHigh);
+        for (int i = 0; i < 3; ++i)
+            pool.submit([&, i]() { record(5 + i); });
+
+        go = true;
+        pool.wait();
+
+        check(order == std::vector<int> {0, 1, 2, 5, 6, 7, 10, 11, 12}, "priority order");
+    }
+
+    // Tasks submitted from inside one worker land on its queue and are stolen by the others.
+    void test_stealing()
+    {
+        ThreadPool                pool(4);
+        std::mutex                mutex;
+        std::set<std::thread::id> threads;
+        std::atomic<int>          ran {0};
+
+        pool.submit([&]() {
+            for (int i = 0; i < 64; ++i)
+            {
+                pool.submit([&]() {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+                    {
+                        std::lock_guard<std::mutex> lock(mutex);
+                        threads.insert(std::this_thread::get_id());
+                    }
+                    ++ran;
+                });
+            }
+        });
+        pool.wait();
+
+        check(ran == 64 && threads.size() > 1, "stealing");
+    }
+
+    void test_task_groups()
+    {
+        ThreadPool pool;
+
+        bool groupsOk = true;
+        for (int round = 0; round < 200; ++round)
+        {
+            std::atomic<int> ran {0};
+            TaskGroup        group(pool, static_cast<TaskPriority>(round % kTaskPriorityCount));
+            for (int i = 0; i < 100; ++i)
+                group.run([&]() { ++ran; });
+            group.wait();
+            groupsOk = groupsOk && ran == 100;
+        }
+        check(groupsOk, "task groups");
+
+        std::atomic<int> ran {0};
+        for (int i = 0; i < 10000; ++i)
+            pool.submit([&]() { ++ran; }, static_cast<TaskPriority>(i % kTaskPriorityCount));
+        pool.wait();
+        check(ran == 10000, "stress");
+    }
+
+    void test_destructor_drains()
+    {
+        std::atomic<int> ran {0};
+        {
+            ThreadPool pool(3);
+            for (int i = 0; i < 1000; ++i)
+                pool.submit([&]() { ++ran; });
+        }
+        check(ran == 1000, "destructor drains");
+    }
+
+    // Requests for a hash that is being validated are answered by that run. The worker is held busy
+    // until every request is in, so the first run is still pending when the others arrive.
+    void test_validate_async_one_hash()
+    {
+        ThreadPool           pool(1);
+        SpirvValidationCache cache;
+
+        auto              spirv = std::make_shared<const std::vector<uint32_t>>(std::vector<uint32_t> {1, 2, 3});
+        std::atomic<int>  answered {0};
+        std::atomic<bool> go {false};
+        {
+            TaskGroup group(pool, TaskPriority::eLow);
+            pool.submit(
+                [&]() {
+                    while (!go)
+                        std::this_thread::yield();
+                },
+                TaskPriority::eHigh);
+            for (int i = 0; i < 32; ++i)
+                cache.validateAsync(spirv, 42, group, [&](const Result<void>&) { ++answered; });
+            go = true;
+            group.wait();
+        }
+
+        check(answered == 32 && cache.validatedCount() == 1 && cache.cachedCount() == 31, "validateAsync one hash");
+    }
+} // namespace
+
+int main()
+{
+    test_priority_order();
+    test_stealing();
+    test_task_groups();
+    test_destructor_drains();
+    test_validate_async_one_hash();
+
+    return g_Failures == 0 ? 0 : 1;
+}
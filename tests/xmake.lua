@@ -0,0 +1,37 @@
+-- Each test is a standalone binary returning non-zero on failure; run them with `xmake test`.
+
+target("test_build_request_allocations")
+	set_kind("binary")
+
+	add_files("build_request_allocations.cpp")
+
+	add_deps("vshadersystem")
+
+	add_tests("default")
+
+	-- set target directory
+	set_targetdir("$(builddir)/$(plat)/$(arch)/$(mode)/vshadersystem/tests")
+
+target("test_thread_pool")
+	set_kind("binary")
+
+	add_files("thread_pool.cpp")
+
+	add_deps("vshadersystem")
+
+	add_tests("default")
+
+	-- set target directory
+	set_targetdir("$(builddir)/$(plat)/$(arch)/$(mode)/vshadersystem/tests")
+
+target("test_include_guards")
+	set_kind("binary")
+
+	add_files("include_guards.cpp")
+
+	add_deps("vshadersystem")
+
+	add_tests("default")
+
+	-- set target directory
+	set_targetdir("$(builddir)/$(plat)/$(arch)/$(mode)/vshadersystem/tests")
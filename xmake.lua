@@ -19,6 +19,18 @@ option("vshadersystem_build_examples") -- build examples?
     set_description("Enable vshadersystem examples")
 option_end()
 
+option("vshadersystem_build_tests") -- build tests?
+    set_default(false)
+    set_showmenu(true)
+    set_description("Enable vshadersystem tests (run with xmake test)")
+option_end()
+
+option("vshadersystem_spirv_tools") -- link SPIRV-Tools for experimental link modules and validation?
+    set_default(false)
+    set_showmenu(true)
+    set_description("Enable SPIR-V linking of include modules and SPIR-V validation (requires SPIRV-Tools)")
+option_end()
+
 -- if build on windows
 if is_plat("windows") then
     add_cxxflags("/Zc:__cplusplus", {tools = {"msvc", "cl"}}) -- fix __cplusplus == 199711L error
@@ -60,4 +72,9 @@ includes("source")
 -- if build examples, then include examples
 if has_config("vshadersystem_build_examples") then
     includes("examples")
+end
+
+-- if build tests, then include tests
+if has_config("vshadersystem_build_tests") then
+    includes("tests")
 end
\ No newline at end of file